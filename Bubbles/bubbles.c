@@ -1,6 +1,6 @@
 /***************************************************************************
 ******************************* 14/Sep/92 **********************************
-****************************   Version 2.0   *******************************
+****************************   Version 3.0   *******************************
 ************************* Author: Paolo Cignoni ****************************
 *									   *
 *    FILE:	bubbles.c						   *
@@ -13,6 +13,7 @@
 * IMPORTS:	Error							   *
 *		ErrorNULL						   *
 *		ErrorFALSE						   *
+*		ParallelFor, ThreadNum, SetThreadNum (OList)		   *
 *									   *
 * GLOBALS:	ProgramName						   *
 *									   *
@@ -31,28 +32,31 @@
 *									   *
 *    2.0  21/02/94      Added [-d n] option for n dimensional case         *
 *									   *
+*    3.0  19/10/26      Sites generated in parallel [-j n] with a counter  *
+*			based random generator, so a seed gives the same   *
+*			dataset with any number of threads. Chunked and    *
+*			binary [-b] output.				   *
+*									   *
+*    3.1  19/10/26      Stress generators [-g kind] [-t x]: spheres, shells*
+*			slabs, lattices, anisotropic boxes and power law   *
+*			clusters.					   *
+*									   *
 ****************************************************************************
 ***************************************************************************/
 
 
 #include "error.h"
 #include "general.h"
+#include <OList/parallel.h>
 
 #include<time.h>
 #include<math.h>
 #include<stdio.h>
 #include<stdlib.h>
+#include<string.h>
 #include<ctype.h>
 #include<limits.h>
 
-#ifndef MSDOS
-#define rand() random()
-#define srand(a) srandom(a)
-#ifndef RAND_MAX
-#define RAND_MAX LONG_MAX
-#endif
-#endif
-
 #define STD   0
 #define GEOM  1
 #define QHULL 2
@@ -70,9 +74,15 @@
 	-G		Out in Geomview format                          \n\
         -Q              Out in Qhull format                             \n\
         -D              Out in Detri format                             \n\
+        -b              Out in binary PLY format                        \n\
+\n\
+        -g kind         Sites generator (ball default):                 \n\
+                        ball sphere shell slab lattice aniso power      \n\
+        -t x            Generator parameter (see bubbles.txt)           \n\
 \n\
 	-s n		Set Random seed = n	   	                \n\
         -d n            Sites in n dimensions (-d 2 default).           \n\
+        -j n            Use n threads (default one for each processor). \n\
 \n\
 	npoints		total number of sites produced			\n\
 	nbubbles	number of bubbles (clusters) of sites		\n\
@@ -83,14 +93,401 @@
 #define RANDOM	 1    /* Constants for bubble site number */
 #define VOLUME	 2
 
-typedef struct Point3Struct
+#define BALL	 0    /* Sites generators, see Generators[] */
+#define SPHERE	 1
+#define SHELL	 2
+#define SLAB	 3
+#define LATTICE	 4
+#define ANISO	 5
+#define POWER	 6
+
+#define POWER_CORE 0.05	/* Min u of the power sites, see MakeSite  */
+
+#define MAXDIM 10
+
+#define CHUNK_SITES 8192	/* Sites generated by a thread at once	   */
+#define COORD_CHARS 32		/* Max chars written for a coordinate	   */
+
+#define RAND_GAMMA  0x9E3779B97F4A7C15ULL  /* 2^64 / golden ratio	   */
+#define SETUP_STREAM 0xFFFFFFFFFFFFFFFFULL /* Stream of bubbles setup	   */
+
+typedef unsigned long long RandState;
+
+typedef struct
+{
+ char  *name;
+ double param;		/* Default of the -t parameter		   */
+ boolean box;		/* Whether it fills the box ignoring bubbles */
+} GeneratorInfo;
+
+static GeneratorInfo Generators[] =
+{
+ { "ball",	0.0,	FALSE },	/* Sites in the bubbles		   */
+ { "sphere",	0.0,	FALSE },	/* On the bubble surfaces	   */
+ { "shell",	0.05,	FALSE },	/* Within thickness t of them	   */
+ { "slab",	0.01,	TRUE  },	/* Box squeezed to t on last axis  */
+ { "lattice",	0.01,	TRUE  },	/* Grid nodes moved of t*spacing   */
+ { "aniso",	0.1,	TRUE  },	/* Box with sides 1, t, t^2, ...   */
+ { "power",	1.5,	FALSE },	/* Bubble i has sites ~ (i+1)^-t   */
+ { NULL,	0.0,	FALSE }
+};
+
+typedef struct
+{
+ long	first;		/* First site of the chunk			   */
+ long	n;		/* Number of sites of the chunk			   */
+ char  *buf;		/* Output of the chunk				   */
+ size_t len;
+} Chunk;
+
+
+/***************************************************************************
+*									   *
+* Global Variables:							   *
+*									   *
+*     -	The random seed							   *
+*     -	The bubbles and the program flags shared by the threads		   *
+*									   *
+***************************************************************************/
+
+static RandState Seed;
+
+static int	Dim=3;
+static boolean	UniformDistribution=TRUE;
+static boolean	Binary=FALSE;
+static int	Format=STD;
+static int	Generator=BALL;
+static double	Param=-1;	/* -t parameter, <0 means the default	   */
+static long	LatticeSide;	/* Nodes for each side of the lattice	   */
+static double	BoxRadius;
+
+static long	nbubbles=1;
+static long    *bubblefirst;	/* Index of the first site of each bubble  */
+static double  *bubblecenter;
+static double  *bubbleradius;
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	Mix64, SeedStream, Uniform				   *
+*									   *
+*  PURPOSE:	A counter based random generator (splitmix64).		   *
+*									   *
+*    NOTES:	Each site has its own stream, whose state is the mix of	   *
+*		the seed and of the site index; so the sites do not depend *
+*		on the order (and on the thread) in which they are built   *
+*		and a seed always gives the same dataset.		   *
+*									   *
+***************************************************************************/
+
+static RandState Mix64(RandState z)
+{
+ z=(z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+ z=(z^(z>>27))*0x94D049BB133111EBULL;
+ return z^(z>>31);
+}
+
+static void SeedStream(RandState *s, RandState stream)
+{
+ *s=Mix64(Seed^Mix64(stream+RAND_GAMMA));
+}
+
+/* Un double uniforme in [0,1) con 53 bit casuali. */
+static double Uniform(RandState *s)
+{
+ *s+=RAND_GAMMA;
+ return (double)(Mix64(*s)>>11) * (1.0/9007199254740992.0);
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	BallSite, Direction					   *
+*									   *
+*  PURPOSE:	A random point of the ball of radius lim (with the -u or   *
+*		-n density) and a random unit vector.			   *
+*									   *
+*    NOTES:	The random points of the cube [-1,1]^Dim are discarded	   *
+*		until one falls in the ball. The ball generator passes the *
+*		bubble radius as lim, as bubbles always did: so a bubble   *
+*		of radius r<1 is filled up to r*r once scaled.		   *
+*									   *
+***************************************************************************/
+
+static void BallSite(RandState *s, double *coord, double lim)
 {
- double x;
- double y;
- double z;
-} Point3;
+ double x, dist;
+ int k;
 
-typedef Point3 Vector3;
+ for(;;)
+   {
+    dist=0;
+    for(k=0;k<Dim;k++)
+      {
+       x=2.0*Uniform(s) - 1.0;
+       dist += x*x;
+       coord[k]=x;
+      }
+
+    if(!UniformDistribution)
+      {
+       dist=pow(dist,.5);
+       for(k=0;k<Dim;k++)
+	 coord[k]*=dist;
+      }
+    dist=0;
+    for(k=0;k<Dim;k++)
+       dist+=coord[k]*coord[k];
+
+    if(sqrt(dist)<=lim) return;
+   }
+}
+
+static void Direction(RandState *s, double *coord)
+{
+ double x, dist;
+ int k;
+
+ do {				/* Scarta anche i punti troppo vicini al  */
+    dist=0;			/* centro, la loro direzione e' imprecisa */
+    for(k=0;k<Dim;k++)
+      {
+       x=2.0*Uniform(s) - 1.0;
+       dist += x*x;
+       coord[k]=x;
+      }
+   } while(dist>1.0 || dist<1e-4);
+
+ dist=sqrt(dist);
+ for(k=0;k<Dim;k++)
+   coord[k]/=dist;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	MakeSite						   *
+*									   *
+*  PURPOSE:	Build the site of index g, belonging to bubble b.	   *
+*									   *
+*    NOTES:	The site depends on the generator:			   *
+*									   *
+*	ball	 in the bubble.						   *
+*	sphere	 on the bubble surface, all the sites are cospherical up   *
+*		 to the output rounding.				   *
+*	shell	 at uniform depth in [0, t*radius) below the surface, as a *
+*		 scanned surface with noise.				   *
+*	slab	 uniform in the box with the last side squeezed to t.	   *
+*	lattice	 the g-th node of a regular grid filling the box, moved	   *
+*		 of at most t*spacing on each axis (t=0 gives the exact	   *
+*		 grid, the most cospherical dataset).			   *
+*	aniso	 uniform in the box with sides boxsize * t^k.		   *
+*	power	 in the bubble with the radius r = radius * u^2, so the	   *
+*		 density grows as r^(1/2-Dim) towards the center. u is	   *
+*		 not less than POWER_CORE, otherwise the central sites	   *
+*		 would be equal once rounded to the six output decimals.   *
+*									   *
+*		The box generators have a single bubble centered in the	   *
+*		origin.							   *
+*									   *
+***************************************************************************/
+
+static void MakeSite(long g, long b, double *coord)
+{
+ RandState s;
+ double u;
+ long node;
+ int k;
+
+ SeedStream(&s,(RandState)g);
+ switch(Generator)
+   {
+    case BALL :	BallSite(&s,coord,bubbleradius[b]);
+		for(k=0;k<Dim;k++) coord[k]*=bubbleradius[b];
+		break;
+
+    case SPHERE:	Direction(&s,coord);
+		for(k=0;k<Dim;k++) coord[k]*=bubbleradius[b];
+		break;
+
+    case SHELL:	Direction(&s,coord);
+		u=1.0-Param*Uniform(&s);
+		for(k=0;k<Dim;k++) coord[k]*=u*bubbleradius[b];
+		break;
+
+    case POWER:	Direction(&s,coord);
+		u=POWER_CORE+(1.0-POWER_CORE)*Uniform(&s);
+		for(k=0;k<Dim;k++) coord[k]*=u*u*bubbleradius[b];
+		break;
+
+    case SLAB:	for(k=0;k<Dim;k++)
+		  coord[k]=(2.0*Uniform(&s) - 1.0)*BoxRadius;
+		coord[Dim-1]*=Param;
+		break;
+
+    case ANISO:	for(k=0;k<Dim;k++)
+		  coord[k]=(2.0*Uniform(&s) - 1.0)*BoxRadius*pow(Param,(double)k);
+		break;
+
+    case LATTICE: node=g;
+		for(k=0;k<Dim;k++)
+		  {
+		   coord[k]=((node%LatticeSide)+0.5 + Param*(2.0*Uniform(&s)-1.0))
+			    *2.0*BoxRadius/LatticeSide - BoxRadius;
+		   node/=LatticeSide;
+		  }
+		break;
+   }
+
+ for(k=0;k<Dim;k++)
+   coord[k]+=bubblecenter[b*MAXDIM+k];
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	PutCoord						   *
+*									   *
+*  PURPOSE:	Write a coordinate as printf("%f ") does.		   *
+*									   *
+*   RETURN:	The end of the written string.				   *
+*									   *
+*    NOTES:	sprintf is the slowest part of the program, so the usual   *
+*		coordinates are converted by hand as a number of	   *
+*		millionths; only the huge ones go to sprintf.		   *
+*									   *
+***************************************************************************/
+
+static char *PutCoord(char *p, double x)
+{
+ unsigned long long v, ip;
+ char digit[24];
+ int i, n=0;
+
+ if(!(fabs(x)<1e12)) return p+sprintf(p,"%f ",x);
+
+ if(x<0) { *p++='-'; x=-x; }
+ v=(unsigned long long)(x*1e6+0.5);
+ ip=v/1000000;
+ do { digit[n++]=(char)('0'+ip%10); ip/=10; } while(ip);
+ while(n) *p++=digit[--n];
+ *p++='.';
+ v%=1000000;
+ for(i=5;i>=0;i--) { p[i]=(char)('0'+v%10); v/=10; }
+ p+=6;
+ *p++=' ';
+ return p;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	FillChunks						   *
+*									   *
+*  PURPOSE:	ParallelFor body: build the sites of the chunks [from,to)  *
+*		and write them in the chunk buffers.			   *
+*									   *
+*    NOTES:	In text format a bubble starts with an empty line, as the  *
+*		sequential bubbles always did.				   *
+*									   *
+***************************************************************************/
+
+static void FillChunks(long from, long to, int thread, void *arg)
+{
+ Chunk *c=(Chunk *)arg;
+ double coord[MAXDIM];
+ long g, nb, hi, m;
+ char *p;
+ int k;
+
+ for(;from<to;from++)
+  {
+   g=c[from].first;
+				/* Ricerca binaria della prima bolla che   */
+   nb=0; hi=nbubbles;		/* inizia in g o dopo.			   */
+   while(nb<hi)
+     {
+      m=(nb+hi)/2;
+      if(bubblefirst[m]<g) nb=m+1;
+		      else hi=m;
+     }
+
+   p=c[from].buf;
+   for(;g<c[from].first+c[from].n;g++)
+     {
+      while(nb<nbubbles && bubblefirst[nb]==g)
+	{
+	 if(!Binary) *p++='\n';
+	 nb++;
+	}
+				/* Il sito g e' nell'ultima bolla iniziata */
+      if(Binary)
+	{
+	 MakeSite(g,nb-1,(double *)p);
+	 p+=Dim*sizeof(double);
+	 continue;
+	}
+      MakeSite(g,nb-1,coord);
+      for(k=0;k<Dim;k++)
+	p=PutCoord(p,coord[k]);
+      *p++='\n';
+     }
+   c[from].len=p-c[from].buf;
+  }
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	WriteSites						   *
+*									   *
+*  PURPOSE:	Build and write all the sites.				   *
+*									   *
+*    NOTES:	The chunks are built in parallel a batch at a time (two	   *
+*		chunks for each thread) and then written in order with	   *
+*		a single fwrite each.					   *
+*									   *
+***************************************************************************/
+
+static void WriteSites(long npoints)
+{
+ long nchunk, batch, i, first, b;
+ size_t size;
+ Chunk *c;
+
+ batch=2*ThreadNum();
+ if(Binary) size=CHUNK_SITES*Dim*sizeof(double);
+       else size=CHUNK_SITES*(Dim*COORD_CHARS+2);
+
+ c=(Chunk *)calloc((size_t)batch,sizeof(Chunk));
+ if(!c) Error("Insufficient memory\n",EXIT);
+ for(i=0;i<batch;i++)
+   {
+    c[i].buf=(char *)malloc(size);
+    if(!c[i].buf) Error("Insufficient memory\n",EXIT);
+   }
+
+ for(first=0;first<npoints;first+=nchunk*CHUNK_SITES)
+   {
+    nchunk=MIN(batch,(npoints-first+CHUNK_SITES-1)/CHUNK_SITES);
+    for(i=0;i<nchunk;i++)
+      {
+       c[i].first=first+i*CHUNK_SITES;
+       c[i].n=MIN(CHUNK_SITES,npoints-c[i].first);
+      }
+    ParallelFor(nchunk,1,FillChunks,c);
+    for(i=0;i<nchunk;i++)
+      if(fwrite(c[i].buf,1,c[i].len,stdout)!=c[i].len)
+	Error("Unable to write the sites\n",EXIT);
+   }
+
+ if(!Binary)			/* Bolle vuote in fondo al dataset.	   */
+   for(b=0;b<nbubbles;b++)
+     if(bubblefirst[b]==npoints) printf("\n");
+
+ for(i=0;i<batch;i++) free(c[i].buf);
+ free(c);
+}
 
 
 
@@ -119,8 +516,10 @@ typedef Point3 Vector3;
 *	-r		Random number of sites for bubble.		   *
 *	-v		Number of sites proprortional to bubble volume.    *
 *	-G		Out in Geomview format                             *
+*	-b		Out in binary PLY format                           *
 *	-s n		Set Random seed = n	   	                   *
 *       -d n            Sites in n dimensions (-d 2 default).              *
+*       -j n            Use n threads.                                     *
 *									   *
 *	npoints		total number of sites produced			   *
 *	nbubbles	number of bubbles (clusters) of sites		   *
@@ -167,66 +566,86 @@ typedef Point3 Vector3;
 *	So if -1 < x < +1 is generated with uniform density then	   *
 *	tan(x*PI/2) is distribuited approximately with normal distribution.*
 *									   *
+*	The stress generators (-g) are described in MakeSite; the box	   *
+*	ones ignore nbubbles, power sets the number of sites per bubble	   *
+*	instead of -c, -r, -v.						   *
 *									   *
+*	The bubbles are defined sequentially with the stream		   *
+*	SETUP_STREAM, the site i with the stream i, so the dataset depends *
+*	only on the seed.						   *
 *									   *
 ***************************************************************************/
 
 main(int argc, char *argv[])
 {
- int i=1,j,k;
+ int i=1,k;
 
- int Dim=3;
- #define MAXDIM 10
- #define RAND_MAX 0x8fffffff
- boolean UniformDistribution=TRUE;    /* Flags for command line arguments */
- int Format = STD;
  int SitePerBubble=CONSTANT;
 
- long npoints, nbubbles=1;
+ long npoints;
  double boxsize=1, boxradius;
 
  long *bubblesize;
  long total=0, total2=0;
 
- double x ;
-
- double *bubblecenter;
- double *bubbleradius;
  double bubblemaxradius;
- double coord[MAXDIM];
- double dist;
+ RandState s;
+ int one=1;
+ char *kind;
+ double weight;
+
  SetProgramName("bubbles");
- srand( (unsigned)time( NULL ) );
- 
+ Seed=(RandState)time( NULL );
+
  if(argc<2) Error(USAGE,EXIT);
 
- while(*argv[i]=='-')
+ while(i<argc && *argv[i]=='-')
     {
       switch((argv[i])[1])
 	 {
 	  case 'G': Format=GEOM;	break;
 	  case 'Q': Format=QHULL;	break;
 	  case 'D': Format=DETRI;	break;
-	  case 's': if(argv[i][2]=='\0' && isdigit(argv[i+1][0]))
-	                  srand( (unsigned)atoi(argv[++i])); 
-  	            else  srand( (unsigned)atoi(argv[i]+2)); 
+	  case 'b': Binary=TRUE;	break;
+	  case 's': if(argv[i][2]=='\0' && i+1<argc && isdigit(argv[i+1][0]))
+	                  Seed=(RandState)(unsigned)atoi(argv[++i]);
+  	            else  Seed=(RandState)(unsigned)atoi(argv[i]+2);
                    break;
 	  case 'u': UniformDistribution=TRUE;	break;
 	  case 'n': UniformDistribution=FALSE;	break;
 	  case 'c': SitePerBubble=CONSTANT;	break;
 	  case 'r': SitePerBubble=RANDOM;	break;
 	  case 'v': SitePerBubble=VOLUME;	break;
-          case 'd' : if(argv[i][2]=='\0' && isdigit(argv[i+1][0]))
+          case 'd' : if(argv[i][2]=='\0' && i+1<argc && isdigit(argv[i+1][0]))
                          Dim=atoi(argv[++i]);
                     else Dim=atoi(argv[i]+2);
                    break;
+          case 'g' : if(argv[i][2]=='\0' && i+1<argc) kind=argv[++i];
+		     else kind=argv[i]+2;
+		   for(k=0;Generators[k].name;k++)
+		     if(strcmp(kind,Generators[k].name)==0) break;
+		   if(!Generators[k].name)
+		     Errorf(EXIT,"Error: Unknown generator %s.\n",kind);
+		   Generator=k;
+                   break;
+          case 't' : if(argv[i][2]=='\0' && i+1<argc) Param=atof(argv[++i]);
+		     else Param=atof(argv[i]+2);
+		   if(Param<0) Errorf(EXIT,"Error: Negative parameter %g.\n",Param);
+                   break;
+          case 'j' : if(argv[i][2]=='\0' && i+1<argc && isdigit(argv[i+1][0]))
+                         SetThreadNum(atoi(argv[++i]));
+                    else SetThreadNum(atoi(argv[i]+2));
+                   break;
           default : Errorf(NO_EXIT,"Error: Unknown switch %s.\n",argv[i]);
 	 }
 
       i++;
     }
  if(argc-i<1) Error(USAGE,EXIT);
- npoints=(long)atoi(argv[i++]);
+ if(Dim<1 || Dim>MAXDIM) Errorf(EXIT,"Dimension must be in [1,%i]\n",MAXDIM);
+ if(Binary && Format!=STD)
+	Error("Binary output is only in the standard format\n",EXIT);
+ npoints=atol(argv[i++]);
 
  if(argc > i)
      boxsize=atof(argv[i++]);
@@ -236,17 +655,25 @@ main(int argc, char *argv[])
  if(nbubbles>npoints)
 	Error("Bubble number must be less than point number\n",EXIT);
 
+ if(Param<0) Param=Generators[Generator].param;
+ if(Generators[Generator].box) nbubbles=1;
+ if(Generator==LATTICE)		/* The smallest grid with npoints nodes */
+   for(LatticeSide=1;pow((double)LatticeSide,(double)Dim)<npoints;)
+     LatticeSide++;
+
  bubblesize   =  (long *) calloc((size_t)nbubbles, sizeof(long));
+ bubblefirst  =  (long *) calloc((size_t)nbubbles, sizeof(long));
  bubblecenter = (double *)calloc((size_t)nbubbles*MAXDIM, sizeof(double));
  bubbleradius = (double *)calloc((size_t)nbubbles, sizeof(double));
 
- if(!bubblecenter || !bubbleradius || !bubblesize)
+ if(!bubblecenter || !bubbleradius || !bubblesize || !bubblefirst)
 				Error("Insufficient memory\n",EXIT);
 
- boxradius=boxsize/2;
+ boxradius=BoxRadius=boxsize/2;
 
  bubblemaxradius = boxradius / pow(2.0 * nbubbles,1/3) * 1.5 / 2.0;
 
+ SeedStream(&s,SETUP_STREAM);
 
  /* Define bubble centers and radii */
 
@@ -254,23 +681,23 @@ main(int argc, char *argv[])
   {				     /* it must fill the box.	    */
    for(k=0;k<Dim;k++)
      bubblecenter[k] = 0.0;
-       
+
    bubbleradius[0]   = boxradius;
  }
- else 
+ else
    for(i=0;i<nbubbles;i++)
      {
        for(k=0;k<Dim;k++)
-	 bubblecenter[i*MAXDIM+k] = 
-	   ((double)rand()/(RAND_MAX/2.0) - 1.0)*boxradius;
+	 bubblecenter[i*MAXDIM+k] =
+	   (2.0*Uniform(&s) - 1.0)*boxradius;
        do
 	 {
-	   bubbleradius[i]=((double)rand()/(RAND_MAX))* bubblemaxradius;
+	   bubbleradius[i]=Uniform(&s)* bubblemaxradius;
 	 }
        while(bubbleradius[i] < ((bubblemaxradius/nbubbles)/2));
        bubbleradius[i]*=6;
      }
- 
+
 
  /* Defineo number of Sites per bubble */
  /* for RANDOM and VOLUME we need 2 pass */
@@ -282,7 +709,7 @@ main(int argc, char *argv[])
 
   if(SitePerBubble==RANDOM)
     {
-     bubblesize[i]=1+rand()%npoints;
+     bubblesize[i]=1+(long)(Uniform(&s)*npoints);
      total+=bubblesize[i];
     }
 
@@ -294,78 +721,60 @@ main(int argc, char *argv[])
   }
 
 
+ /* Power law sizes: the bubble i has a weight (i+1)^-Param */
+
+ if(Generator==POWER)
+   {
+    SitePerBubble=RANDOM;
+    for(total=0,i=0;i<nbubbles;i++)
+      {
+       weight=pow(i+1.0,-Param);
+       bubblesize[i]=(long)(weight*1e9);
+       total+=bubblesize[i];
+      }
+   }
+
  /* second pass */
 
  if(SitePerBubble==VOLUME || SitePerBubble==RANDOM)
    {
     for(i=0;i<nbubbles-1;i++)
        {
-	
-	bubblesize[i] = bubblesize[i]*npoints/total;
+
+	bubblesize[i] = (long)((double)bubblesize[i]*npoints/total);
 	total2+=bubblesize[i];
        }
     bubblesize[nbubbles-1]=npoints-total2;
    }
-/*
- for(i=0;i<nbubbles;i++)
-     printf("% bubblesize[%i] = %i %lf \n",i,bubblesize[i],bubbleradius[i] );
-       */
+
+ for(i=1;i<nbubbles;i++)
+   bubblefirst[i]=bubblefirst[i-1]+bubblesize[i-1];
+
  /* Finally we start to print! */
  /******************************************************************/
- if(Format == STD) printf("%i\n",npoints);
- if(Format == GEOM) 
+ if(Binary)			/* PLY binario nell'ordine nativo dei byte */
    {
-     printf("VECT\n%i %i 0\n",npoints,npoints);
+    printf("ply\nformat %s 1.0\nelement vertex %ld\n",
+	   *(char *)&one ? "binary_little_endian" : "binary_big_endian",npoints);
+    for(k=0;k<Dim;k++)
+      if(k<3) printf("property double %c\n","xyz"[k]);
+	 else printf("property double c%i\n",k);
+    printf("end_header\n");
+   }
+ if(Format == STD && !Binary) printf("%ld\n",npoints);
+ if(Format == GEOM)
+   {
+     printf("VECT\n%ld %ld 0\n",npoints,npoints);
      for(i=0;i<npoints;i++) printf("1 ");
      printf("\n");
      for(i=0;i<npoints;i++) printf("0 ");
    }
-  if(Format == QHULL)  printf("3 %i\n",npoints);
-  if(Format == DETRI)  printf("# %i\n# fix: 8.6",npoints);
- 
+  if(Format == QHULL)  printf("%i %ld\n",Dim,npoints);
+  if(Format == DETRI)  printf("# %ld\n# fix: 8.6",npoints);
+
  /******************************************************************/
- 
- for(i=0;i<nbubbles;i++)
-  {
-   printf("\n");
-   for(j=0;j<bubblesize[i];)
-     {
-       dist=0;
-       for(k=0;k<Dim;k++)
-         {
-	   x=((double)random())/(RAND_MAX/2.0) - 1.0;
-	   dist += x*x;
-	   coord[k]=x;
-	 }
-       
-       if(!UniformDistribution)
-	 {
-	   dist=pow(dist,.5);
-	     for(k=0;k<Dim;k++)
-	       coord[k]*=dist;
-	 }
-       dist=0;
-       for(k=0;k<Dim;k++)
-	 {
-	   dist+=coord[k]*coord[k];
-	   coord[k]*=bubbleradius[i];
-	 }
-       
-       if(sqrt(dist)<=bubbleradius[i])
-	 {
-	   for(k=0;k<Dim;k++)
-	     printf("%f ",coord[k]+ bubblecenter[i*MAXDIM+k] );
-	   printf("\n");
-	   j++;
-	 }
- /*      else 
-	 {printf("Wrong ! %lf ",sqrt(dist));
-	   for(k=0;k<Dim;k++)
-	     printf("%f ",coord[k]);
-	   printf("\n");
-	 }*/
-     }
-  }
+
+ WriteSites(npoints);
 
  return 0;
 }
@@ -0,0 +1,402 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      batch.c                                                    *
+*                                                                          *
+* PURPOSE:      Triangulating many small independent point sets at once.   *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               FirstTetra, MakeTetra, ReuseUG, FastMakeTetra              *
+*                                                                          *
+* EXPORTS:      ReadBatch       Read a batch of point sets                 *
+*               RunBatch        Triangulate all the sets of a batch        *
+*               WriteBatch      Write the tetrahedra of all the sets       *
+*               EraseBatch      Free a batch                               *
+*                                                                          *
+*   NOTES:      With a few hundred points a run spends more in its fixed   *
+*               costs than in the tetrahedra: a UG and three hashed lists  *
+*               allocated and freed, the walls of DeWall. Here each set is *
+*               completed by one thread as a leaf of the hybrid DeWall     *
+*               (see hybrid.c), with one list of open faces and no walls,  *
+*               and the sets are spread on the threads. Each thread keeps  *
+*               its list, its Store and the memory of its UG (see ReuseUG) *
+*               from a set to the next, so after the first sets it	   *
+*               allocates only the faces.                                  *
+*               The tetrahedra of a set are made of the same faces in any  *
+*               thread, and the sets are written in their order, so the    *
+*               result does not depend on the number of threads.           *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/numfile.h>
+#include <OList/delaunay.h>
+
+#include "graphics.h"
+#include "dewall.h"
+
+
+/* Global for Statistic Infomations */
+
+extern PARALLEL_LOCAL StatInfo SI;
+
+/* Global Program Flag */
+
+extern boolean SafeTetraFlag;
+extern boolean UGScaleFlag;
+extern float   UGScale;
+
+
+typedef struct BatchSpacestruct
+{
+ Point3 **v;			/* The points of the current set	  */
+ pindex Size;
+ List Q;			/* Its open faces			  */
+ Store T;			/* The tetrahedra of all the sets of the  */
+				/* thread, with the indices in B->v	  */
+ UG G;
+ UGSpace S;
+} BatchSpace;
+
+typedef struct BatchJobstruct
+{
+ Batch *B;
+ int *Thread;			/* The thread of each set and the first   */
+ long *Start;			/* of its tetrahedra in the Store of the  */
+				/* thread				  */
+ BatchSpace W[MAX_THREADS];
+ StatInfo S[MAX_THREADS];	/* The counters of each thread		  */
+} BatchJob;
+
+
+/***************************************************************************
+*									   *
+* ReadBatch								   *
+*									   *
+* Read in B a batch file:						   *
+*									   *
+*      S								   *
+*      n_1 n_2 ... n_S							   *
+*      X Y Z								   *
+*      ...								   *
+*									   *
+* the number of sets, the number of points of each set and then the points *
+* of all the sets, one set after the other.				   *
+*									   *
+***************************************************************************/
+
+Batch *ReadBatch(char *filename, Batch *B)
+{
+ NumFile F;
+ long s, n, m;
+
+ memset(B,0,sizeof(Batch));
+ if(!OpenNumFile(filename,&F)) Error("ReadBatch, Unable to open input file.\n",EXIT);
+
+ if(!ReadLong(&F,&(B->Sets)) || B->Sets<0)
+   Errorf(EXIT,"ReadBatch, %s is not a batch file.\n",filename);
+
+ B->First=(long *)malloc((size_t)(B->Sets+1)*sizeof(long));
+ B->TFirst=(long *)calloc((size_t)(B->Sets+1),sizeof(long));
+ if(!B->First || !B->TFirst) Error("ReadBatch, Not enough memory for the sets.\n",EXIT);
+
+ B->First[0]=0;
+ for(s=0;s<B->Sets;s++)
+   {
+    if(!ReadLong(&F,&n) || n<0)
+      Errorf(EXIT,"ReadBatch, %s has no size for set %ld.\n",filename,s+1);
+    B->First[s+1]=B->First[s]+n;
+   }
+
+ n=B->First[B->Sets];
+ B->v=(Point3 *)calloc((size_t)MAX(n,1),sizeof(Point3));
+ if(!B->v) Error("ReadBatch, Not enough memory to load point dataset.\n",EXIT);
+
+ if((m=ReadReals(&F,n,3,&(B->v[0].x),sizeof(Point3)))<n)
+   Errorf(EXIT,"ReadBatch, %s truncated at point %ld.\n",filename,m);
+ CloseNumFile(&F);
+
+ for(m=0;m<n;m++) B->v[m].mark=-1;
+ return B;
+}
+
+
+/*
+ * OpenFace
+ *
+ * Aggiunge f alle facce aperte di W se non c'e' gia', altrimenti la chiude
+ * e la toglie, aggiornando i contatori dei suoi punti come in RunLeaf.
+ */
+
+static void OpenFace(Face *f, Point3 *BaseV, BatchSpace *W)
+{
+ Face *old;
+
+ if((old=(Face *)ToggleFace(f,W->Q)))
+   {
+    free(old);
+    SI.Face--;
+    MarkFace(BaseV,f,-1);
+    free(f);
+   }
+ else MarkFace(BaseV,f,1);
+}
+
+
+/*
+ * DropSet
+ *
+ * Abbandona un insieme che costruisce tetraedri in ciclo: libera t, f e le
+ * facce ancora aperte. I suoi tetraedri restano in W->T, ma non sono
+ * contati.
+ */
+
+static void DropSet(Tetra *t, Face *f, BatchSpace *W)
+{
+ int i;
+
+ for(i=0;i<4;i++) free(t->f[i]);
+ free(t);
+ free(f);
+ while(ExtractList(&f,W->Q)) free(f);
+}
+
+
+/*
+ * RunSet
+ *
+ * Triangola l'insieme s nello spazio W del thread e restituisce il numero
+ * di tetraedri aggiunti a W->T, zero se l'insieme e' degenere. Senza muri
+ * il primo tetraedro non deve attraversarne uno: parte dal punto piu'
+ * vicino a v[0], come in InCoDe; le sue facce sono le prime aperte.
+ * Per errori numerici un insieme puo' costruire due volte lo stesso
+ * tetraedro e non finire mai (vedi -t): non puo' avere piu' di n*n/2
+ * tetraedri, oltre e' abbandonato e contato fra i degeneri, senza fermare
+ * gli altri insiemi come farebbe Error.
+ */
+
+static long RunSet(Batch *B, long s, BatchSpace *W)
+{
+ Point3 *BaseV=B->v;
+ pindex n=(pindex)(B->First[s+1]-B->First[s]), i;
+ long Built=CountStore(W->T), Limit;
+ Tetra *t;
+ ShortTetra st;
+ Face *f;
+
+ if(n<4) return 0;
+ if(n>W->Size)
+   {
+    free(W->v);
+    W->Size=MAX(n,2*W->Size);
+    W->v=(Point3 **)malloc((size_t)W->Size*sizeof(Point3 *));
+    if(!W->v) Error("RunBatch, Not enough memory for the points of a set!!\n",EXIT);
+   }
+ for(i=0;i<n;i++) W->v[i]=&(BaseV[B->First[s]+i]);
+
+ if(!(t=FirstTetra(W->v,BaseV,n,1))) return 0;
+
+ for(i=0;i<4;i++) OpenFace(t->f[i],BaseV,W);
+ Tetra2ShortTetra(t,&st);
+ i=st.v[0];		/* FirstTetra reversed t->f[0], swap two vertices */
+ st.v[0]=st.v[1];	/* as DeWall does.				  */
+ st.v[1]=i;
+ free(t);
+ AppendStore(&st,W->T);
+ SI.Face+=4;
+ SI.Tetra++;
+
+ Limit=Built+(long)n*n/2;
+ if(n>BATCH_SMALL)
+   ReuseUG(W->v,NULL,n,UGScaleFlag ? UG_CELLS(n*UGScale) : TuneUG(W->v,n),&(W->G),&(W->S));
+
+ while(ExtractList(&f,W->Q))
+ {
+  if(n>BATCH_SMALL) t=FastMakeTetra(f,W->v,BaseV,n,&(W->G));
+	       else t=MakeTetra(f,W->v,BaseV,n);
+  if(t==NULL) SI.CHFace++;
+  else
+     {
+      Tetra2ShortTetra(t,&st);
+
+      if(CountStore(W->T)>Limit || (SafeTetraFlag && MemberStore(&st, W->T)))
+	{
+	 DropSet(t,f,W);
+	 return 0;
+	}
+      AppendStore(&st,W->T);
+
+      SI.Face+=3;
+      SI.Tetra++;
+
+      for(i=1;i<4;i++) OpenFace(t->f[i],BaseV,W);
+
+      free(t->f[0]);
+      free(t);
+     }
+  free(f);
+ }
+
+ return CountStore(W->T)-Built;
+}
+
+
+/***************************************************************************
+*									   *
+* RunBatch								   *
+*									   *
+* Triangulate in parallel all the sets of B, BATCH_GRAIN at a time for	   *
+* each thread, then copy the tetrahedra of the sets in B->T in the order   *
+* of the sets, with the indices of their points in the set. The sets with  *
+* no tetrahedra are counted in B->Degenerate.				   *
+*									   *
+***************************************************************************/
+
+static void SetBody(long from, long to, int thread, void *arg)
+{
+ BatchJob *J=(BatchJob *)arg;
+ BatchSpace *W=&(J->W[thread]);
+ StatInfo Base=SI;
+ long s;
+
+ for(s=from;s<to;s++)
+   {
+    J->Thread[s]=thread;
+    J->Start[s]=CountStore(W->T);
+    J->B->TFirst[s+1]=RunSet(J->B,s,W);
+   }
+
+ AddStat(&SI,&Base,&(J->S[thread]));
+ SI=Base;
+}
+
+static void CopyBody(long from, long to, int thread, void *arg)
+{
+ BatchJob *J=(BatchJob *)arg;
+ Batch *B=J->B;
+ ShortTetra *t, *r;
+ long s, i;
+ int k;
+
+ for(s=from;s<to;s++)
+   for(i=B->TFirst[s];i<B->TFirst[s+1];i++)
+     {
+      t=(ShortTetra *)StoreElem(J->Start[s]+i-B->TFirst[s],J->W[J->Thread[s]].T);
+      r=&(B->T[i]);
+      for(k=0;k<4;k++) r->v[k]=t->v[k]-(pindex)B->First[s];
+     }
+}
+
+void RunBatch(Batch *B)
+{
+ BatchJob *J;
+ StatInfo Zero;
+ long s;
+ int i;
+
+ J=(BatchJob *)calloc(1,sizeof(BatchJob));
+ if(J) J->Thread=(int *)malloc((size_t)MAX(B->Sets,1)*sizeof(int));
+ if(J) J->Start=(long *)malloc((size_t)MAX(B->Sets,1)*sizeof(long));
+ if(!J || !J->Thread || !J->Start) Error("RunBatch, Not enough memory for the batch!!\n",EXIT);
+ J->B=B;
+ memset(&Zero,0,sizeof(StatInfo));
+
+ for(i=0;i<ThreadNum();i++)	/* Not in the threads: HashList uses the  */
+   {				/* global stack of listscan.c		  */
+    J->W[i].Q=NewList(FIFO,sizeof(Face));
+    ChangeEqualObjectList(EqualFace,J->W[i].Q);
+    HashList(BATCH_HASH,HashFace,J->W[i].Q);
+    J->W[i].T=NewStore(sizeof(ShortTetra));
+    if(!J->W[i].T) Error("RunBatch, Not enough memory for the tetrahedra!!\n",EXIT);
+    if(SafeTetraFlag)
+      HashStore((long)BATCH_HASH*TETRA_PER_POINT,HashTetra,EqualTetra,J->W[i].T);
+   }
+
+ ParallelFor(B->Sets, BATCH_GRAIN, SetBody, J);
+
+ B->TFirst[0]=0;
+ B->Degenerate=0;
+ for(s=0;s<B->Sets;s++)
+   {
+    if(B->TFirst[s+1]==0) B->Degenerate++;
+    B->TFirst[s+1]+=B->TFirst[s];
+   }
+ B->T=(ShortTetra *)malloc((size_t)MAX(B->TFirst[B->Sets],1)*sizeof(ShortTetra));
+ if(!B->T) Error("RunBatch, Not enough memory for the tetrahedra!!\n",EXIT);
+
+ ParallelFor(B->Sets, BATCH_GRAIN, CopyBody, J);
+
+ for(i=0;i<MAX_THREADS;i++)
+   {
+    AddStat(&(J->S[i]),&Zero,&SI);
+    if(!J->W[i].T) continue;
+    EraseList(J->W[i].Q);
+    EraseStore(J->W[i].T);
+    EraseUGSpace(&(J->W[i].S));
+    free(J->W[i].v);
+   }
+ free(J->Thread);
+ free(J->Start);
+ free(J);
+}
+
+
+/***************************************************************************
+*									   *
+* WriteBatch								   *
+*									   *
+* Write on fp the tetrahedra of the sets of B:				   *
+*									   *
+*      S								   *
+*      first_1 count_1							   *
+*      ...								   *
+*      first_S count_S							   *
+*      N								   *
+*      V0 V1 V2 V3							   *
+*      ...								   *
+*									   *
+* the number of sets, the first and the number of the tetrahedra of each   *
+* set, then all the N tetrahedra as in WriteTetraVector, each with the	   *
+* indices of its vertices in its set.					   *
+*									   *
+***************************************************************************/
+
+void WriteBatch(Batch *B, FILE *fp)
+{
+ long s;
+
+ fprintf(fp,"%ld\n",B->Sets);
+ for(s=0;s<B->Sets;s++)
+   fprintf(fp,"%ld %ld\n",B->TFirst[s],B->TFirst[s+1]-B->TFirst[s]);
+ WriteTetraVector(B->T,B->TFirst[B->Sets],fp);
+}
+
+
+/***************************************************************************
+*									   *
+* EraseBatch								   *
+*									   *
+* Free the points and the tetrahedra of B.				   *
+*									   *
+***************************************************************************/
+
+void EraseBatch(Batch *B)
+{
+ free(B->First);
+ free(B->TFirst);
+ free(B->v);
+ free(B->T);
+ memset(B,0,sizeof(Batch));
+}
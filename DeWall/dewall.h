@@ -16,6 +16,8 @@
 *               Line            Definition                                 *
 *               Plist           Definition                                 *
 *		UG		Definition				   *
+*		UGSpace 	Definition				   *
+*		Batch		Definition				   *
 *		StatInfo	Definition				   *
 *                                                                          *
 *   NOTES:	This is the optimized version of the DeWall algorithm.	   *
@@ -28,15 +30,19 @@
 ****************************************************************************
 ***************************************************************************/
 
+#include <OList/cloud.h>	/* PointFilter, for ReadPoints		  */
+
 #define BIGNUMBER 1000000000.0
 #define EPSILON 0.0000001
+#define TETRA_PER_POINT 7	/* About 6.8 tetrahedra for each point of */
+				/* a uniform dataset, sizes the -t hash.  */
 
 
 
-typedef struct Facestruct	/* A Face is an array of 3 Point3 pointers*/
-{				/* Faces are oriented, top follows right  */
- Point3 *v[3];			/* hand rules for vertex ordering	  */
-} Face;
+typedef struct Facestruct	/* A Face is an array of 3 int indices of */
+{				/* Point3 in the Point3 vector BaseV.	  */
+ pindex v[3];			/* Faces are oriented, top follows right  */
+} Face; 			/* hand rules for vertex ordering	  */
 
 
 typedef struct Tetrastruct	/* A Tetra is an array of 4 Face pointers */
@@ -46,7 +52,7 @@ typedef struct Tetrastruct	/* A Tetra is an array of 4 Face pointers */
 
 typedef struct Tetra2struct
 {				/* A ShortTetra is an abbreviated type for*/
- int v[4];			/* representing Tetrahedra. It contains   */
+ pindex v[4];			/* representing Tetrahedra. It contains   */
 } ShortTetra;			/* only the four index of its vertices	  */
 
 
@@ -61,11 +67,22 @@ typedef struct Linestruct {	/* A Line in the space is the direction   */
 	Vector3 Lv;
 	} Line;
 
+typedef struct DDFormstruct	/* The dd distance from a face of a point */
+{				/* given as r=p-o and its lifted coord	  */
+ Vector3 N;			/* w=|r|^2 (o is the UG center). With	  */
+ double off;			/* h = N.r - off the height of p on the   */
+ Vector3 A;			/* face and t = (w + A.r + K)/(2h), the   */
+ double K;			/* sphere through face and p has center   */
+ double R2;			/* at Lu + t N and squared radius R2+t^2. */
+} DDForm;
+
 
 struct plist {			/* This is a List of Point. I dont used   */
 	Point3 *p;		/* Olist for this structure because it is */
 	struct plist *next;	/* really very simple, used many times and*/
-	};			/* I write this code before Olist :-)	  */
+	Point3 r;		/* I write this code before Olist :-)	  */
+	double w;		/* r and w are the point relative to the  */
+	};			/* UG center and its lifted coordinate.   */
 typedef struct plist Plist;
 
 enum Axis
@@ -95,6 +112,7 @@ typedef struct UGstruct {
 
 	Point3 vp;	/* Maximum vertex of UG */
 	Point3 vn;	/* Minimum vertex of UG */
+	Point3 o;	/* Center of UG, origin of the Plist r */
 
 	double side;	/* Cell Edge */
 
@@ -107,38 +125,220 @@ typedef struct UGstruct {
 	} UG;
 
 
+/****************************************************************************
+*									    *
+* UGSpace								    *
+*									    *
+* The memory of the UG built one after the other by ReuseUG: the cells,    *
+* their marks and the nodes of the point lists, one for each point. It     *
+* only grows, so it is allocated again only for a UG larger than all the   *
+* previous ones.							    *
+*									    *
+****************************************************************************/
+
+typedef struct UGSpacestruct {
+	Plist **C;	/* The cells and their marks		   */
+	int *Marked;
+	int Cells;
+	Plist *Node;	/* The nodes of the point lists		   */
+	pindex Nodes;
+	} UGSpace;
+
+
+/****************************************************************************
+*									    *
+* UG tuning								    *
+*									    *
+* When the user does not give the UG size, TuneUG chooses it from a sample  *
+* of UG_SAMPLE points binned in a coarse grid of UG_SAMPLE_CELL sampled     *
+* points per cell. The clustering index K measures how many more neighbours *
+* a point has than in a uniform set of the same bounding box (1 for uniform *
+* sets). A face costs the visited cells plus the tested points: for uniform *
+* sets the balance is at about UG_OCCUPANCY points per cell, clustered sets *
+* need finer cells, so the UG gets n * K^UG_CLUSTER / UG_OCCUPANCY cells,   *
+* between UG_MIN_SCALE*n and UG_MAX_SCALE*n. The two constants are fitted   *
+* on benchmark runs and can be changed from the command line.		    *
+*									    *
+****************************************************************************/
+
+#define UG_SAMPLE	4096	/* Points sampled by TuneUG		   */
+#define UG_SAMPLE_CELL	8	/* Sampled points per coarse cell	   */
+#define UG_OCCUPANCY	4.0	/* Points per cell for uniform sets	   */
+#define UG_CLUSTER	0.7	/* Exponent of the clustering index	   */
+#define UG_MIN_SCALE	0.125	/* Bounds of the tuned cells/points ratio  */
+#define UG_MAX_SCALE	8.0
+
+				/* m cells as the int of BuildUG, with x*y*z */
+				/* still in an int (needs limits.h)	    */
+#define UG_CELLS(m)	((int)MIN(MAX((double)(m),1.0),(double)INT_MAX/2))
+
+
+
+/****************************************************************************
+*									    *
+* Wall choice								    *
+*									    *
+* Each subproblem is split by the plane, normal to an axis, that crosses    *
+* the fewest tetrahedra according to a cost model. In a region of linear    *
+* density l (points per unit of length along the axis) and cross section   *
+* A the points are about (l^2 A)^(1/3) per unit of area, times A, so the    *
+* wall has about WALL_COST * l^(2/3) * A^(1/3) tetrahedra, WALL_COST	    *
+* fitted on uniform sets. l is measured on a sample of WALL_SAMPLE points,  *
+* as the fraction 2*WALL_DELTA of the sampled coordinates around the	    *
+* position over the length they span, A is the sampled bounding box. For    *
+* a cube this is the usual n^(2/3) wall on every axis, for a slab the long  *
+* axis gets the small wall. Positions other than the median, at steps of    *
+* WALL_STEP of the points, can be tried to cut sparser regions.		    *
+* The wall always lies between two different coordinates, so no point can  *
+* be on it, not even when many points share the median coordinate.	    *
+*									    *
+****************************************************************************/
+
+#define WALL_CYCLE	0	/* Axes X, Y, Z in turn, at the median	    */
+#define WALL_MODEL	1	/* Axis of the smallest predicted wall	    */
+
+#define WALL_SAMPLE	1024	/* Points sampled for the cost model	    */
+#define WALL_DELTA	0.05	/* Half width of the density window	    */
+#define WALL_STEP	0.025	/* Step of the positions off the median     */
+#define WALL_SHIFT	0.1	/* Default largest shift from the median    */
+#define WALL_COST	7.8	/* Tetrahedra for l^(2/3) * A^(1/3)	    */
+#define WALL_CELL	4	/* Sampled points per cell of the section   */
+#define WALL_GRID	16	/* Largest grid of the section		    */
+#define WALL_MIN_CLUSTER 0.25	/* Smallest clustering index of a section   */
+#define WALL_LEVELS	48	/* Levels of the per level statistics	    */
+
+
+/****************************************************************************
+*									    *
+* Hybrid								    *
+*									    *
+* In the hybrid mode DeWall stops splitting at the subproblems of at most   *
+* Size points. Each of them becomes a Leaf: the slab v of its points and    *
+* the faces that the walls of its parents left open. When the walls are	    *
+* done the leaves are completed in parallel, each with the UG of its points *
+* and a single active face list as in InCoDe, without the further walls,    *
+* sorting and lists of DeWall. The tetrahedra of each leaf go in its own    *
+* Store T, appended to the result in the order of the leaves.		    *
+* The UG of a leaf is not adaptive, so the leaves must be small: with	    *
+* leaves of 16384 points clustered sets are twice slower than DeWall, with  *
+* about 1000 points a leaf and its UG stay in the cache and it is as fast.  *
+*									    *
+****************************************************************************/
+
+#define HYBRID_LEAF	1024	/* Points of a leaf by default		    */
+#define HYBRID_SPLIT	4	/* Leaves wanted at least for each thread   */
+
+typedef struct Leafstruct {
+	Point3 **v;	/* The points of the leaf		   */
+	pindex n;
+	List Q;		/* The faces still open			   */
+	Store T;	/* The tetrahedra built by the leaf	   */
+	} Leaf;
+
+typedef struct Hybridstruct {
+	pindex Size;	/* Subproblems up to Size points are leaves */
+	Store Leaves;	/* The Leaf found so far		   */
+	} Hybrid;
+
+
+/****************************************************************************
+*									    *
+* Batch									    *
+*									    *
+* Many small point sets triangulated independently in one run (-n), each   *
+* by a single thread (see batch.c). The points of set s are		    *
+* v[First[s]..First[s+1]-1], its tetrahedra are T[TFirst[s]..TFirst[s+1]-1] *
+* and their vertices are indices in the set, from 0; a set with no	    *
+* tetrahedra is degenerate: less than four points, all coplanar, or	    *
+* dropped for a cycle of numerical errors.				    *
+* Sets up to BATCH_SMALL points are completed with MakeTetra, the larger   *
+* with a UG; BATCH_GRAIN sets at a time are given to a thread.		    *
+*									    *
+****************************************************************************/
+
+#define BATCH_SMALL	20
+#define BATCH_GRAIN	16
+#define BATCH_HASH	256	/* Hash size of the open faces of a thread  */
+
+typedef struct Batchstruct {
+	long Sets;
+	long *First;	/* Sets+1 offsets of the points		   */
+	Point3 *v;
+	long *TFirst;	/* Sets+1 offsets of the tetrahedra	   */
+	ShortTetra *T;
+	long Degenerate;	/* Sets without tetrahedra	   */
+	} Batch;
+
+
 
 typedef struct StatInfostruct
 {
 			/* General Stats	*/
-  int	 Point;
+  pindex Point;
   double Secs;
-  int	 Face;
-  int	 CHFace;
-  int	 Tetra;
+  long	 Face;
+  long	 CHFace;
+  long	 Tetra;
 			/* UG Stats		*/
   int	 Cell;
   int	 EmptyCell;
   int	 MaxPointPerCell;
   double CellEdge;
+  double Cluster;	/* Clustering index found by TuneUG */
 			/* List Stats		*/
   int	 QSize;
   int	 EqualTest;
 			/* Incode Stats 	*/
   long	 TestedPoint;
-  int	 MakeTetra;
+  long	 MakeTetra;
   double MinRadius;
   double Radius;
   int	 MinRadiusNum;
 			/* Incode + UG Stats	*/
-  int	 EmptyBox;
-  int	 SecondBox;
-  int	 UsefulSecondBox;
+  long	 EmptyBox;
+  long	 SecondBox;
+  long	 UsefulSecondBox;
   long	 TestedCell;
 
-  int WallSize;
+  long WallSize;
+			/* Wall Stats, for each level */
+  int	 WallNum[WALL_LEVELS];		/* Walls built		   */
+  double WallPredicted[WALL_LEVELS];	/* Tetrahedra predicted    */
+  long	 WallTetra[WALL_LEVELS];	/* Tetrahedra built	   */
 } StatInfo;
 
+
+/****************************************************************************
+*									    *
+* WallJob								    *
+*									    *
+* With more than one thread the walls of the subproblems larger than	    *
+* WALL_PARALLEL points are built a batch of WALL_BATCH faces at a time: the *
+* tetrahedra of the batch are searched in parallel, each thread with its    *
+* own cell marks and statistic counters, then committed in order by DeWall  *
+* (see wall.c). Smaller walls are too short to repay the threads.	    *
+*									    *
+****************************************************************************/
+
+#define WALL_PARALLEL	8192	/* Smallest subproblem with a parallel wall */
+#define WALL_BATCH	256	/* Faces searched in parallel at a time	    */
+
+typedef struct WallJobstruct {
+	Point3 **v;	/* The points of the subproblem and its UG  */
+	Point3 *BaseV;
+	pindex n;
+	UG *G;
+
+	Face *F[WALL_BATCH];	/* The faces of the batch and their */
+	Tetra *T[WALL_BATCH];	/* tetrahedra				*/
+	long nf;
+
+	int *Marked[MAX_THREADS];	/* The UG cell marks of each thread */
+	int Mark[MAX_THREADS];
+	StatInfo S[MAX_THREADS];	/* The counters of each thread	    */
+	} WallJob;
+
+
 /**************************************************************************
 *									  *
 *				PROTOTYPES				  *
@@ -149,9 +349,10 @@ typedef struct StatInfostruct
 *   file.c                                                                *
 **************************************************************************/
 
-Point3 *ReadPoints(char *filename, int *n);
-void WriteTetraList(List T, FILE *fp);
-ShortTetra *Tetra2ShortTetra(Tetra *t,Point3 *BaseV);
+Point3 *ReadPoints(char *filename, PointFilter *PF, pindex *n);
+void WriteTetraStore(Store T, FILE *fp);
+void WriteTetraVector(ShortTetra *t, long n, FILE *fp);
+ShortTetra *Tetra2ShortTetra(Tetra *t, ShortTetra *st);
 
 int HashFace(void *F);
 int HashTetra(void *T);
@@ -167,21 +368,26 @@ Plane *CalcPlane(Vector3 *p0, Vector3 *p1, Vector3 *p2, Plane *p );
 boolean RightSide(Plane *p, Point3 *v);
 Point3 *CalcPlaneInter(Plane *p0, Plane *p1,Plane *p2,Point3 *c);
 Point3 *CalcSphereCenter(Point3 *v0, Point3 *v1, Point3 *v2, Point3 *v3,Point3 *c);
-Point3 *NormalToFace(Face *f, Point3 *n);
+Point3 *NormalToFace(Point3 *BaseV, Face *f, Point3 *n);
 Point3 *CalcLinePlaneInter(Line *l, Plane *p, Point3 *c);
 Plane *CalcMiddlePlane(Point3 *p1, Point3 *p2, Plane *p);
 Line *CalcLineofCenter(Point3 *p1, Point3 *p2, Point3 *p3, Line *l);
+DDForm *CalcDDForm(Plane *p, Line *Lc, double FaceRadius, Point3 *o, DDForm *d);
 boolean PointBelongtoLine(Point3 *p, Line *l);
 boolean PointBelongtoPlane(Point3 *p, Plane *pl);
 boolean ReverseFace(Face *f);
-int Intersect(Face *f, Plane *p);
+int Intersect(Point3 *BaseV, Face *f, Plane *p);
+void MarkFace(Point3 *BaseV, Face *f, int inc);
 
 /**************************************************************************
 *   unifgrid.c                                                            *
 **************************************************************************/
 
-UG *BuildUG(Point3 *v[], int *UsedPoint, int n, int m, UG *C);
-Tetra *FastMakeTetra(Face *f,Point3 *v[], int n, UG *C);
+int TuneUG(Point3 *v[], pindex n);
+UG *BuildUG(Point3 *v[], int *UsedPoint, pindex n, int m, UG *C);
+UG *ReuseUG(Point3 *v[], int *UsedPoint, pindex n, int m, UG *G, UGSpace *S);
+void EraseUGSpace(UGSpace *S);
+Tetra *FastMakeTetra(Face *f,Point3 *v[], Point3 *BaseV, pindex n, UG *C);
 void EraseUG(UG *G);
 
 
@@ -189,8 +395,48 @@ void EraseUG(UG *G);
 *   main.c                                                                *
 **************************************************************************/
 
-void CheckTetra(Tetra *t, Point3 *v[], int n);
-Tetra *BuildTetra(Face *f, Point3 *p);
+Tetra *BuildTetra(Face *f, pindex p);
+Tetra *MakeTetra(Face *f, Point3 *v[], Point3 *BaseV, pindex n);
+Tetra *FirstTetra(Point3 *v[], Point3 *BaseV, pindex n, pindex m);
+pindex ChooseWall(Point3 *v[], pindex n, enum Axis a, Plane *alpha,
+		  enum Axis *axis, double *Predicted);
+
+
+/**************************************************************************
+*   hybrid.c								  *
+**************************************************************************/
+
+void InitHybrid(pindex n, pindex Size, Hybrid *H);
+boolean AddLeaf(Point3 *v[], pindex n, List Q, Hybrid *H);
+void RunLeaves(Point3 *BaseV, Store T, Hybrid *H);
+void EraseHybrid(Hybrid *H);
+
+
+/**************************************************************************
+*   batch.c								  *
+**************************************************************************/
+
+Batch *ReadBatch(char *filename, Batch *B);
+void RunBatch(Batch *B);
+void WriteBatch(Batch *B, FILE *fp);
+void EraseBatch(Batch *B);
+
+
+/**************************************************************************
+*   wall.c								  *
+**************************************************************************/
+
+void InitWallJob(Point3 *v[], Point3 *BaseV, pindex n, UG *G, WallJob *W);
+long WallBatch(List La, List Pending, WallJob *W);
+void EraseWallJob(WallJob *W);
+
+
+/**************************************************************************
+*   check.c								  *
+**************************************************************************/
+
+pindex CheckTetraUG(ShortTetra *t, Point3 *BaseV, UG *G);
+long CheckTriangulation(Store T, Point3 *BaseV, UG *G);
 
 
 /**************************************************************************
@@ -198,6 +444,7 @@ Tetra *BuildTetra(Face *f, Point3 *p);
 **************************************************************************/
 
 void InitStat();
+void AddStat(StatInfo *s, StatInfo *base, StatInfo *to);
 void PrintStat();
 void PrintNumStat();
 void PrintNumStatTitle();
@@ -38,7 +38,7 @@ typedef struct Box2dStruct {            /* 2d box */
 
 typedef struct Point3Struct {   /* 3d point */
 	double x, y, z;
-	char mark;
+	int mark;
 } Point3;
 typedef Point3 Vector3;
 
@@ -0,0 +1,245 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      hybrid.c                                                   *
+*                                                                          *
+* PURPOSE:      The leaves of the hybrid DeWall, completed in parallel.    *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               BuildUG and FastMakeTetra                                  *
+*                                                                          *
+* EXPORTS:      InitHybrid      Choose the size of the leaves              *
+*               AddLeaf         Make a leaf of a small subproblem          *
+*               RunLeaves       Complete all the leaves                    *
+*               EraseHybrid     Free the leaves                            *
+*                                                                          *
+*   NOTES:      A leaf needs no wall: all the tetrahedra that cross the    *
+*               walls of its parents are already built, so the ones still  *
+*               missing on its open faces have all the vertices among its  *
+*               points. Each leaf builds the UG of its points in the       *
+*               thread that completes it; the leaves share no data but the *
+*               points, and the mark of a point is changed only by the     *
+*               leaf that contains it.                                     *
+*               A UG for all the leaves would save the building, but it is *
+*               not adaptive: on clustered sets it tests about three times *
+*               the points of the UG of each subproblem, whose cells       *
+*               follow the density as DeWall goes down. For the same       *
+*               reason the leaves must be small, see HYBRID_LEAF.          *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/delaunay.h>
+
+#include "graphics.h"
+#include "dewall.h"
+
+
+/* Global for Statistic Infomations */
+
+extern PARALLEL_LOCAL StatInfo SI;
+
+/* Global Program Flag */
+
+extern boolean SafeTetraFlag;
+extern boolean UGSubFlag;
+extern float   UGScale;
+
+
+/***************************************************************************
+*									   *
+* InitHybrid								   *
+*									   *
+* Set the maximum size of a leaf for a set of n points. With Size 0 the    *
+* leaves have at most HYBRID_LEAF points, and are at least HYBRID_SPLIT	   *
+* for each thread.							   *
+*									   *
+***************************************************************************/
+
+void InitHybrid(pindex n, pindex Size, Hybrid *H)
+{
+ if(Size<=0) Size=MIN(HYBRID_LEAF, n/((pindex)HYBRID_SPLIT*ThreadNum())+1);
+ H->Size=MAX(Size,20);
+ H->Leaves=NewStore(sizeof(Leaf));
+ if(!H->Leaves) Error("InitHybrid, Not enough memory for the leaves!!\n",EXIT);
+}
+
+
+/***************************************************************************
+*									   *
+* AddLeaf								   *
+*									   *
+* If the subproblem of the n points of v and of the open faces Q is small  *
+* enough make it a leaf and return TRUE. The faces are moved from Q to the *
+* List of the leaf, so the caller can erase Q as usual.			   *
+*									   *
+***************************************************************************/
+
+boolean AddLeaf(Point3 *v[], pindex n, List Q, Hybrid *H)
+{
+ Leaf L;
+ Face *f;
+
+ if(n>H->Size || CountList(Q)==0) return FALSE;
+
+ L.v=v;
+ L.n=n;
+ L.T=NULL;
+ L.Q=NewList(FIFO,sizeof(Face));
+ ChangeEqualObjectList(EqualFace,L.Q);
+ if(n>40) HashList(n/4,HashFace,L.Q);
+
+ while(ExtractList(&f,Q)) InsertList(f,L.Q);
+
+ AppendStore(&L,H->Leaves);
+ return TRUE;
+}
+
+
+/*
+ * RunLeaf
+ *
+ * Completa una foglia: una sola lista di facce attive, come in InCoDe.
+ * Ogni nuova faccia gia' presente nella lista e' chiusa e la si toglie,
+ * altrimenti la si aggiunge. La UG e' quella dei soli punti della foglia.
+ */
+
+static void RunLeaf(Leaf *L, Point3 *BaseV)
+{
+ Tetra *t;
+ ShortTetra st;
+ Face *f, *old;
+ int i;
+ UG G;
+
+ if(UGSubFlag) BuildUG(L->v,NULL,L->n,TuneUG(L->v,L->n),&G);
+	  else BuildUG(L->v,NULL,L->n,UG_CELLS(L->n*UGScale),&G);
+
+ L->T=NewStore(sizeof(ShortTetra));
+ if(SafeTetraFlag) HashStore((long)L->n*TETRA_PER_POINT,HashTetra,EqualTetra,L->T);
+
+ while(ExtractList(&f,L->Q))
+ {
+  t=FastMakeTetra(f,L->v,BaseV,L->n,&G);
+  if(t==NULL) SI.CHFace++;
+  else
+     {
+      Tetra2ShortTetra(t,&st);
+
+      if(SafeTetraFlag) if(MemberStore(&st, L->T))
+			Error("Cyclic Tetrahedra Creation\n",EXIT);
+      AppendStore(&st,L->T);
+
+      SI.Face+=3;
+      SI.Tetra++;
+
+      for(i=1;i<4;i++)
+	if((old=(Face *)ToggleFace(t->f[i],L->Q)))
+	  {
+	   free(old);
+	   SI.Face--;
+	   MarkFace(BaseV,t->f[i],-1);
+	   free(t->f[i]);
+	  }
+	else MarkFace(BaseV,t->f[i],1);
+
+      free(t->f[0]);
+      free(t);
+     }
+  free(f);
+ }
+
+ EraseList(L->Q);
+ L->Q=NULL_LIST;
+ EraseUG(&G);
+}
+
+
+/***************************************************************************
+*									   *
+* RunLeaves								   *
+*									   *
+* Complete in parallel all the leaves of H, then append their tetrahedra   *
+* to T in the order of the leaves, so the result does not depend on the    *
+* number of threads. Each thread has its own statistic counters, summed   *
+* in SI at the end.							   *
+*									   *
+***************************************************************************/
+
+typedef struct LeafJobstruct
+{
+ Hybrid *H;
+ Point3 *BaseV;
+ StatInfo S[MAX_THREADS];	/* The counters of each thread		  */
+} LeafJob;
+
+static void LeafBody(long from, long to, int thread, void *arg)
+{
+ LeafJob *J=(LeafJob *)arg;
+ StatInfo Base;
+ long i;
+
+ for(i=from;i<to;i++)
+   {
+    Base=SI;
+    RunLeaf((Leaf *)StoreElem(i,J->H->Leaves),J->BaseV);
+    AddStat(&SI,&Base,&(J->S[thread]));
+    SI=Base;
+   }
+}
+
+void RunLeaves(Point3 *BaseV, Store T, Hybrid *H)
+{
+ LeafJob J;
+ StatInfo Zero;
+ Leaf *L;
+ long i, j, nl=CountStore(H->Leaves);
+
+ J.H=H;
+ J.BaseV=BaseV;
+ memset(J.S,0,sizeof(J.S));
+ memset(&Zero,0,sizeof(StatInfo));
+
+ ParallelFor(nl, 1, LeafBody, &J);
+
+ for(i=0;i<MAX_THREADS;i++) AddStat(&(J.S[i]),&Zero,&SI);
+
+ for(i=0;i<nl;i++)
+   {
+    L=(Leaf *)StoreElem(i,H->Leaves);
+    for(j=0;j<CountStore(L->T);j++)
+      {
+       if(SafeTetraFlag) if(MemberStore(StoreElem(j,L->T),T))
+			   Error("Cyclic Tetrahedra Creation\n",EXIT);
+       AppendStore(StoreElem(j,L->T),T);
+      }
+    EraseStore(L->T);
+    L->T=NULL;
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* EraseHybrid								   *
+*									   *
+* Free the vector of the leaves.					   *
+*									   *
+***************************************************************************/
+
+void EraseHybrid(Hybrid *H)
+{
+ EraseStore(H->Leaves);
+}
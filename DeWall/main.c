@@ -29,7 +29,13 @@
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
 #include <OList/chronos.h>
+#include <OList/parallel.h>
+#include <OList/tetpack.h>
+#include <OList/serve.h>
+#include <OList/delaunay.h>
+#include <OList/voronoi.h>
 
 #include <ctype.h>
 #include <math.h>
@@ -48,18 +54,41 @@
 #include "graphics.h"
 #include "dewall.h"
 
-#define USAGE_MESSAGE "\nUsage: dewall [-s[1|2]] [-u nnn] [-p] [-c] [-t] filein [fileout]\n\
+#define USAGE_MESSAGE "\nUsage: dewall [-s[1|2]] [-u x|a|s] [-w c|m|s[x]] [-l [nnn]] [-p] [-c] [-t] [-j nnn] [-v filevor] [-k filevtk] [-a] [-z] [-b box] [-m classes] filein [fileout]\n\
+       dewall -n [-u x|a] [-t] [-j nnn] filebatch [fileout]\n\
+       dewall -d socket\n\
 	-s	Turn on statistic informations (descriptive format)\n\
 	-s1	Turn on statistic informations (numerical only format)\n\
 	-s2	Turn on statistic informations \n\
 		(numerical+descriptive line format)\n\
 	-u <x>	Set Uniform Grid scale ug size of <x>)\n\
+	-u a[o[,e]] Tune the UG size on a sample of the points (default),\n\
+		optionally with o points per cell and cluster exponent e\n\
+	-u s[o[,e]] As -u a, but tune again the UG of each subproblem\n\
+	-w c	Split along the axes X, Y, Z in turn, at the median (default)\n\
+	-w m	Split along the axis of the smallest predicted wall\n\
+	-w s[x]	As -w m, moving the wall up to x of the points from the\n\
+		median to cut a sparser region (default 0.1)\n\
+	-l [nnn] Hybrid mode: complete in parallel the subproblems of at most\n\
+		nnn points without further walls (default 1024)\n\
 	-p	print the number of tetrahedra built while processing\n\
 	-c	Check every tetrahedron is a Delaunay one\n\
 	-t	Check for double creating Tetrahedra (caused by num. errors)\n\
+	-j nnn	Use nnn threads (default one for each processor)\n\
+	-v filevor Write the Voronoi diagram on filevor\n\
+	-k filevtk Write points and tetrahedra as a VTK unstructured grid\n\
+	-a	Add face areas and cell volumes to the Voronoi diagram,\n\
+		radius and volume of the tetrahedra to the VTK grid\n\
+	-z	Write the tetrahedra packed (see tetpack.h)\n\
+	-b x0,y0,z0,x1,y1,z1 Load only the points inside the box\n\
+	-m c1,c2,... Load only the LAS points of these classes\n\
 \n\
-	filein	file of points to be triangulated\n\
+	filein	file of points to be triangulated (.pnt, PLY, LAS or .xyz)\n\
 	fileout triangulation output file\n\
+\n\
+	-n	Batch mode: triangulate each of the many small point sets\n\
+		of filebatch on its own (see batch.c)\n\
+	-d socket Run the command lines sent on the socket (see serve.h)\n\
 "
 
 /***************************************************************************
@@ -73,7 +102,8 @@
 ***************************************************************************/
 
 
-StatInfo SI;			/* Statistic Infomations */
+PARALLEL_LOCAL StatInfo SI;	/* Statistic Infomations, a copy for   */
+				/* each thread that completes leaves.  */
 
 
 				/************** Program Flags **************/
@@ -83,17 +113,42 @@ boolean CheckFlag	= OFF;	/* Whether checking each built tetrahedron */
 
 boolean StatFlag	= OFF;	/* Whether printing Statistic Infomations. */
 
+char   *VoronoiFile	= NULL; /* Where writing the Voronoi diagram	   */
+
+boolean AreaFlag	= OFF;	/* Whether adding areas and volumes to the */
+				/* Voronoi diagram.			   */
+
+boolean PackFlag	= OFF;	/* Whether writing the tetrahedra packed.  */
+
+char   *VTKFile		= NULL; /* Where writing the VTK grid		   */
+
+PointFilter Filter;		/* Which points of the input are loaded    */
+
 boolean NumStatFlag	= OFF;	/* Whether printing only numerical values  */
 				/* of Statistic Infomations.		   */
 
 boolean NumStatTitleFlag= OFF;	/* Whether add title to previuos Statistics*/
 
 boolean UGScaleFlag	= OFF;	/* Whether UG size is user defined	   */
-float	UGScale		= 1;	/* The UG size user proposed		   */
+float	UGScale		= 1;	/* The UG size user proposed, or the one   */
+				/* TuneUG chose for the whole point set.   */
+boolean UGSubFlag	= OFF;	/* Whether tuning again the UG of each	   */
+				/* DeWall subproblem.			   */
+double	UGOccupancy	= UG_OCCUPANCY; /* The constants of the UG tuning  */
+double	UGCluster	= UG_CLUSTER;	/* cost model, see dewall.h.	   */
 
 boolean UpdateFlag	= OFF;	/* Whether printing the increasing number  */
 				/* of builded tetrahedra while processing. */
 
+int	WallMode	= WALL_CYCLE;	/* How choosing the walls, and the  */
+double	WallShift	= 0;		/* largest shift from the median.   */
+
+boolean HybridFlag	= OFF;	/* Whether completing the small subproblems*/
+pindex	HybridSize	= 0;	/* as leaves, and their maximum size (0 	   */
+				/* for the default, see dewall.h).	   */
+
+boolean BatchFlag	= OFF;	/* Whether the input is a batch of sets.   */
+
 boolean SafeTetraFlag	= OFF;	/* Whether checking each new tetra is a    */
 				/* real new tetra and it is not twice	   */
 				/* twice inserted. This situation happens  */
@@ -101,39 +156,79 @@ boolean SafeTetraFlag	= OFF;	/* Whether checking each new tetra is a    */
 				/* whole algorithm.			   */
 
 
+				/********* Memory of the running job *******/
+
+static struct
+{
+ Point3 *BaseV;
+ Point3 **v;
+ int	*usedpoint;
+ List	 Q;
+ Store	 T;
+ ShortTetra *tv;
+ Batch	 B;
+ FILE	*fp;
+} Job;
+
+
 /***************************************************************************
 *									   *
-* CheckTetra								   *
+* DefaultFlags								   *
 *									   *
-* Test that all the points are out of the sphere circumscribed to	   *
-* tetrahedron t. This test need a O(n) time and is made only on explicit   *
-* user request (-c parameter).						   *
+* Give to the program flags and statistics their initial values, as a new  *
+* process would have them, before a job.				   *
 *									   *
 ***************************************************************************/
 
-void CheckTetra(Tetra *t, Point3 *v[], int n)
+static void DefaultFlags(void)
 {
- int i;
- Point3 Center;
- double Radius;
- double d;
-
- if(!CalcSphereCenter(t->f[0]->v[0],
-		      t->f[0]->v[1],
-		      t->f[0]->v[2],
-		      t->f[1]->v[1], &Center ))
-			  Error("CheckTetra, Bad Tetrahedron, CalcSphereCenter Failed!\n",EXIT);
-
- Radius = V3DistanceBetween2Points(&Center, t->f[0]->v[0]);
- for(i=0;i<n;i++)
- {
-   d=V3DistanceBetween2Points(&Center,v[i]);
-   if( d < Radius - EPSILON)
-     Error("CheckTetra, A not Delaunay Tetrahedron was built!\n",EXIT);
- }
+ CheckFlag=OFF;
+ StatFlag=OFF;
+ VoronoiFile=NULL;
+ AreaFlag=OFF;
+ PackFlag=OFF;
+ VTKFile=NULL;
+ InitFilter(&Filter);
+ NumStatFlag=OFF;
+ NumStatTitleFlag=OFF;
+ UGScaleFlag=OFF;
+ UGScale=1;
+ UGSubFlag=OFF;
+ UGOccupancy=UG_OCCUPANCY;
+ UGCluster=UG_CLUSTER;
+ UpdateFlag=OFF;
+ WallMode=WALL_CYCLE;
+ WallShift=0;
+ HybridFlag=OFF;
+ HybridSize=0;
+ BatchFlag=OFF;
+ SafeTetraFlag=OFF;
+ SetThreadNum(0);
+ memset(&SI,0,sizeof(SI));
 }
 
 
+/***************************************************************************
+*									   *
+* EndJob								   *
+*									   *
+* Free the memory and close the output of a job; called at its end and,    *
+* for a job ended by an error, before the next one.			   *
+*									   *
+***************************************************************************/
+
+static void EndJob(void)
+{
+ if(Job.BaseV) free(Job.BaseV);
+ if(Job.v) free(Job.v);
+ if(Job.usedpoint) free(Job.usedpoint);
+ if(Job.Q) EraseList(Job.Q);
+ if(Job.T) EraseStore(Job.T);
+ if(Job.tv) free(Job.tv);
+ EraseBatch(&(Job.B));
+ if(Job.fp && Job.fp!=stdout) fclose(Job.fp);
+ memset(&Job,0,sizeof(Job));
+}
 
 
 /***************************************************************************
@@ -145,7 +240,7 @@ void CheckTetra(Tetra *t, Point3 *v[], int n)
 *									   *
 ***************************************************************************/
 
-Tetra *BuildTetra(Face *f, Point3 *p)
+Tetra *BuildTetra(Face *f, pindex p)
 {
  Tetra *t;
  Face *f0, *f1,*f2,*f3;
@@ -193,30 +288,30 @@ Tetra *BuildTetra(Face *f, Point3 *p)
 *									   *
 ***************************************************************************/
 
-Tetra *MakeTetra(Face *f,Point3 *v[], int n)
+Tetra *MakeTetra(Face *f, Point3 *v[], Point3 *BaseV, pindex n)
 {
  Plane p,Mp;
  boolean found=FALSE;
  double Radius=BIGNUMBER,  rad;
  Line Lc;
- int pind=0;
+ pindex pind=0;
  Tetra *t;
  Point3 Center, c;
- int i;
+ pindex i;
 
- if(!CalcPlane(f->v[0],f->v[1],f->v[2],&p))
+ if(!CalcPlane(&(BaseV[f->v[0]]),&(BaseV[f->v[1]]),&(BaseV[f->v[2]]),&p))
 		Error("MakeTetra, Face with collinar vertices!\n",EXIT);
 
- CalcLineofCenter(f->v[0],f->v[1],f->v[2],&Lc);
+ CalcLineofCenter(&(BaseV[f->v[0]]),&(BaseV[f->v[1]]),&(BaseV[f->v[2]]),&Lc);
 
  for(i=0;i<n;i++)
  {
-  if((v[i]!=f->v[0]) &&
-     (v[i]!=f->v[1]) &&
-     (v[i]!=f->v[2]) &&
+  if((v[i]-BaseV!=f->v[0]) &&
+     (v[i]-BaseV!=f->v[1]) &&
+     (v[i]-BaseV!=f->v[2]) &&
      RightSide(&p,v[i]) )
 		{
-		 CalcMiddlePlane(v[i],f->v[0],&Mp);
+		 CalcMiddlePlane(v[i],&(BaseV[f->v[0]]),&Mp);
 		 if(CalcLinePlaneInter(&Lc,&Mp,&c))
 		      {
 			rad=V3SquaredDistanceBetween2Points(&c, v[i]);
@@ -236,13 +331,11 @@ Tetra *MakeTetra(Face *f,Point3 *v[], int n)
 
  if(!found) return NULL;
 
- t=BuildTetra(f,v[pind]);
-
- if(CheckFlag)	CheckTetra(t,v,n);
+ t=BuildTetra(f,(pindex)(v[pind]-BaseV));
 
  if(StatFlag)
  {Point3 C;
-  CalcSphereCenter(f->v[0], f->v[1], f->v[2], v[pind], &C);
+  CalcSphereCenter(&(BaseV[f->v[0]]), &(BaseV[f->v[1]]), &(BaseV[f->v[2]]), v[pind], &C);
   SI.Radius+=V3DistanceBetween2Points(&C, v[pind]);
  }
 
@@ -253,13 +346,15 @@ Tetra *MakeTetra(Face *f,Point3 *v[], int n)
 *									   *
 * FirstTetra								   *
 *									   *
-* Build the first Delaunay tetrahedron of the triangulation.		   *
+* Build the first Delaunay tetrahedron of the triangulation, across the    *
+* wall between v[m-1] and v[m]; with m=1 its first edge joins v[0] to its  *
+* nearest point, as in InCoDe. Return NULL if all the points are coplanar. *
 *									   *
 ***************************************************************************/
 
-Tetra *FirstTetra(Point3 *v[], int n)
+Tetra *FirstTetra(Point3 *v[], Point3 *BaseV, pindex n, pindex m)
 {
- int i, MinIndex=0;
+ pindex i, MinIndex=0;
  double Radius, MinRadius=BIGNUMBER;
 
  Tetra *t;
@@ -270,15 +365,15 @@ Tetra *FirstTetra(Point3 *v[], int n)
 
  boolean found=FALSE;
 
- f.v[0]=v[n/2-1];	/* The first point of the face is the	*/
+ f.v[0]=(pindex)(v[m-1]-BaseV);	/* The first point of the face is the	*/
 			/* nearest to middle plane in negative	*/
 			/* halfspace.				*/
 
 			/* The 2nd point of the face is the	*/
 			/* euclidean nearest to first point	*/
- for(i=n/2;i<n;i++)	/* that is in the positive halfspace	*/
+ for(i=m;i<n;i++)	/* that is in the positive halfspace	*/
     {
-     Radius=V3SquaredDistanceBetween2Points(f.v[0], v[i]);
+     Radius=V3SquaredDistanceBetween2Points(&(BaseV[f.v[0]]), v[i]);
      if(Radius<MinRadius)
 	{
 	 MinRadius=Radius;
@@ -286,22 +381,22 @@ Tetra *FirstTetra(Point3 *v[], int n)
 	}
     }
 
- f.v[1]=v[MinIndex];
+ f.v[1]=(pindex)(v[MinIndex]-BaseV);
 			/* The 3rd point is that with previous	*/
 			/* ones builds the smallest circle.	*/
 
- CalcMiddlePlane(f.v[0],f.v[1], &(p[0]));
+ CalcMiddlePlane(&(BaseV[f.v[0]]),&(BaseV[f.v[1]]), &(p[0]));
 
  MinRadius=BIGNUMBER;
 
  for(i=0;i<n;i++)
-  if(v[i]!=f.v[0] && v[i]!=f.v[1])
+  if(v[i]-BaseV!=f.v[0] && v[i]-BaseV!=f.v[1])
    {
-    CalcMiddlePlane(f.v[0], v[i],&(p[1]));
-    if(CalcPlane(f.v[0],f.v[1],v[i],&(p[2])))
+    CalcMiddlePlane(&(BaseV[f.v[0]]), v[i],&(p[1]));
+    if(CalcPlane(&(BaseV[f.v[0]]),&(BaseV[f.v[1]]),v[i],&(p[2])))
       if(CalcPlaneInter(&(p[0]), &(p[1]), &(p[2]), &c))
 	{
-	 Radius=V3DistanceBetween2Points(&c, f.v[0]);
+	 Radius=V3DistanceBetween2Points(&c, &(BaseV[f.v[0]]));
 	  if(Radius<MinRadius)
 		{
 		 MinRadius=Radius;
@@ -310,7 +405,8 @@ Tetra *FirstTetra(Point3 *v[], int n)
 	}
    }
 
- f.v[2]=v[MinIndex];
+ f.v[2]=(pindex)(v[MinIndex]-BaseV);
+ if(f.v[2]==f.v[1]) return NULL;	/* All the points are collinear */
 
 
  /* The first tetrahedron construction is analogous to normal */
@@ -318,13 +414,13 @@ Tetra *FirstTetra(Point3 *v[], int n)
 
  MinRadius=BIGNUMBER;
 
- CalcPlane(f.v[0], f.v[1], f.v[2],&p[0]);
- CalcLineofCenter(f.v[0], f.v[1], f.v[2], &Lc);
+ CalcPlane(&(BaseV[f.v[0]]), &(BaseV[f.v[1]]), &(BaseV[f.v[2]]),&p[0]);
+ CalcLineofCenter(&(BaseV[f.v[0]]), &(BaseV[f.v[1]]), &(BaseV[f.v[2]]), &Lc);
 
  for(i=0;i<n;i++)
-  if(v[i]!=f.v[0] && v[i]!=f.v[1] && v[i]!=f.v[2] )
+  if(v[i]-BaseV!=f.v[0] && v[i]-BaseV!=f.v[1] && v[i]-BaseV!=f.v[2] )
    {
-    CalcMiddlePlane(v[i], f.v[0], &Mp);
+    CalcMiddlePlane(v[i], &(BaseV[f.v[0]]), &Mp);
     if(CalcLinePlaneInter(&Lc, &Mp, &c))
 	 {
 	   Radius=V3SquaredDistanceBetween2Points(&c, v[i]);
@@ -339,13 +435,11 @@ Tetra *FirstTetra(Point3 *v[], int n)
 	 }
    }
 
- if(!found) Error("FirstTetra, Planar dataset, unable to build first tetrahedron.\n",EXIT);
+ if(!found) return NULL;
 
  if(!RightSide(&p[0],v[MinIndex]))	ReverseFace(&f);
 
- t=BuildTetra(&f, v[MinIndex]);
-
- CheckTetra(t,v,n);
+ t=BuildTetra(&f, (pindex)(v[MinIndex]-BaseV));
 
  ReverseFace(t->f[0]); /* First Face in first Tetra   */
 		       /* must be outward oriented    */
@@ -392,6 +486,159 @@ int ZComp(void *E1, void *E2)
 }
 
 
+/*
+ * Coord
+ *
+ * La coordinata di un punto lungo un asse.
+ */
+
+static double Coord(pointer P, int a)
+{
+ Point3 *p=(Point3 *)P;
+
+ switch(a)
+  {
+   case XAxis : return p->x;
+   case YAxis : return p->y;
+   default    : return p->z;
+  }
+}
+
+
+/*
+ * WallCost
+ *
+ * Le dimensioni previste del muro normale all'asse a nella posizione q
+ * (frazione dei punti), dati gli S punti del campione s ordinati lungo
+ * l'asse e la loro scatola vn-vp, per n punti (vedi dewall.h). L'area
+ * della sezione e' divisa per l'indice di clustering dei punti del
+ * campione vicini al muro, contati in una griglia della sezione.
+ */
+
+static double WallCost(Point3 **s, pindex S, pindex n, enum Axis a, double q,
+		       Point3 *vn, Point3 *vp)
+{
+ int Count[WALL_GRID*WALL_GRID];
+ enum Axis b=(enum Axis)((a+1)%3),
+	   c=(enum Axis)((a+2)%3);
+ pindex i=(pindex)(q*(S-1)+0.5),
+	d=MAX(1,(pindex)(WALL_DELTA*S)),
+	lo=MAX(0,i-d),
+	hi=MIN(S-1,i+d),
+	k=hi-lo+1, j;
+ double len=Coord(s[hi],a)-Coord(s[lo],a),
+	Lb=Coord(vp,b)-Coord(vn,b),
+	Lc=Coord(vp,c)-Coord(vn,c),
+	K=0;
+ int g, x, y;
+
+ if(len<=0) return BIGNUMBER;
+
+ g=MIN(MAX((int)sqrt((double)k/WALL_CELL),1),WALL_GRID);
+ for(x=0;x<g*g;x++) Count[x]=0;
+ for(j=lo;j<=hi;j++)
+   {
+    x= Lb>0 ? MIN((int)((Coord(s[j],b)-Coord(vn,b))/Lb*g),g-1) : 0;
+    y= Lc>0 ? MIN((int)((Coord(s[j],c)-Coord(vn,c))/Lc*g),g-1) : 0;
+    Count[x+y*g]++;
+   }
+ for(x=0;x<g*g;x++) K+=(double)Count[x]*(Count[x]-1);
+ K=MAX(K*g*g/((double)k*(k-1)),WALL_MIN_CLUSTER);
+
+ return WALL_COST*pow((double)n*(hi-lo)/(S-1)/len,2.0/3.0)*pow(Lb*Lc/K,1.0/3.0);
+}
+
+
+/***************************************************************************
+*									   *
+* ChooseWall								   *
+*									   *
+* Choose the wall splitting the n points of v: the axis following a with   *
+* -w c, otherwise the axis and position of the smallest wall predicted by  *
+* the cost model of dewall.h. v is sorted along the axis and SplitWall	   *
+* puts the wall between the two nearest different coordinates, so that	   *
+* v[0..m-1] and v[m..n-1], with m the returned index, are on its two	   *
+* sides; if all the points have the same coordinate the next best axis is  *
+* tried. The wall plane goes in alpha, its axis in axis and its predicted  *
+* number of tetrahedra in Predicted.					   *
+*									   *
+***************************************************************************/
+
+pindex ChooseWall(Point3 *v[], pindex n, enum Axis a, Plane *alpha,
+		  enum Axis *axis, double *Predicted)
+{
+ static int (*Comp[3])(void *, void *)={XComp, YComp, ZComp};
+ Point3 *s[3][WALL_SAMPLE], vn, vp;
+ double Cost[3], Pos[3], c, q;
+ enum Axis Order[3], t;
+ pindex S=MIN(n,WALL_SAMPLE), j, m;
+ int k, h;
+
+ vn=vp=*v[0];
+ for(j=0;j<S;j++)			/* Sample the points */
+   {
+    s[0][j]=s[1][j]=s[2][j]=v[(pindex)((double)j*n/S)];
+    vn.x=MIN(vn.x,s[0][j]->x); vp.x=MAX(vp.x,s[0][j]->x);
+    vn.y=MIN(vn.y,s[0][j]->y); vp.y=MAX(vp.y,s[0][j]->y);
+    vn.z=MIN(vn.z,s[0][j]->z); vp.z=MAX(vp.z,s[0][j]->z);
+   }
+ for(k=0;k<3;k++)
+   qsort((void *)s[k], (size_t)S, sizeof(Point3 *),
+	 (int (*)(const void *,const void *))Comp[k]);
+
+ for(k=0;k<3;k++)			/* Predict the walls, the   */
+   {					/* axes in the cycle order  */
+    Order[k]=(enum Axis)((a+k)%3);
+    Cost[Order[k]]=BIGNUMBER;
+    Pos[Order[k]]=0.5;
+    if(S<2) continue;
+    for(q=0.5-WallShift;q<=0.5+WallShift+EPSILON;q+=WALL_STEP)
+      {
+       c=WallCost(s[Order[k]],S,n,Order[k],q,&vn,&vp);
+       if(c<Cost[Order[k]] || (c==Cost[Order[k]] && fabs(q-0.5)<fabs(Pos[Order[k]]-0.5)))
+	 {
+	  Cost[Order[k]]=c;
+	  Pos[Order[k]]=q;
+	 }
+       if(WallShift<=0) break;
+      }
+   }
+
+ if(WallMode==WALL_MODEL)		/* Sort the axes by cost */
+   for(k=1;k<3;k++)
+     for(h=k;h>0 && Cost[Order[h]]<Cost[Order[h-1]];h--)
+       {
+	t=Order[h];
+	Order[h]=Order[h-1];
+	Order[h-1]=t;
+       }
+
+ for(k=0;k<3;k++)
+   {
+    *axis=Order[k];
+    qsort((void *)v, (size_t)n, sizeof(Point3 *),
+	  (int (*)(const void *,const void *))Comp[*axis]);
+
+    m=SplitWall((pointer *)v,n,(pindex)(Pos[*axis]*n),*axis,Coord,&(alpha->off));
+    if(m>0)
+      {
+       alpha->N.x=alpha->N.y=alpha->N.z=0;
+       switch(*axis)
+	{
+	 case XAxis : alpha->N.x=1; break;
+	 case YAxis : alpha->N.y=1; break;
+	 case ZAxis : alpha->N.z=1; break;
+	}
+       *Predicted=(Cost[*axis]<BIGNUMBER) ? Cost[*axis] : 0;
+       return m;
+      }
+   }
+
+ Error("ChooseWall, Duplicated points in dataset.\n",EXIT);
+ return 0;
+}
+
+
 /***************************************************************************
 *									   *
 * DeWall								   *
@@ -411,27 +658,33 @@ int ZComp(void *E1, void *E2)
 *									   *
 ***************************************************************************/
 
-void DeWall(Point3 *v[], Point3 *BaseV, int *UsedPoint, int n, List Q, List T, enum Axis a)
+void DeWall(Point3 *v[], Point3 *BaseV, int *UsedPoint, pindex n, List Q, Store T, enum Axis a,
+	    int level, Hybrid *H)
 {
  List Ln=NULL_LIST,
       La=NULL_LIST,
-      Lp=NULL_LIST;
+      Lp=NULL_LIST,
+      l;
 
  Tetra *t;
- ShortTetra *st;
- Face  *f;
- int i,j;
+ ShortTetra st;
+ Face  *f, *old;
+ pindex i, m;
+ int j;
  UG g;
  Plane alpha;
+ enum Axis axis;
+ double Predicted;
+ long Built;
+ WallJob *W=NULL;			/* Used by the parallel walls only */
+ List Pending=NULL_LIST;
+ long k=0;
 
- alpha.N.x=0;
- alpha.N.y=0;
- alpha.N.z=0;
- alpha.off=0;
+ if(H && AddLeaf(v,n,Q,H)) return;		/* Left to RunLeaves	  */
 
  if(n>20)
- if(UGScaleFlag) BuildUG(v,UsedPoint,n, (int)(n*UGScale),&g); 	/* Initialize Uniform Grid */
-	   else BuildUG(v,UsedPoint,n,      n,&g);
+ if(UGSubFlag) BuildUG(v,UsedPoint,n,TuneUG(v,n),&g);	/* Initialize Uniform Grid */
+	  else BuildUG(v,UsedPoint,n,UG_CELLS(n*UGScale),&g);
 
  Ln=NewList(FIFO,sizeof(Face));			/* Initialize Active Face */
  ChangeEqualObjectList(EqualFace,Ln);		/* List Ln.		  */
@@ -446,52 +699,36 @@ void DeWall(Point3 *v[], Point3 *BaseV, int *UsedPoint, int n, List Q, List T, e
  if(n>40) HashList(n/4,HashFace,Lp);
 
 
- switch(a)
-  {
-   case XAxis :	qsort((void *)v, (size_t)n, sizeof(Point3 *),
-				 (int (*)(const void *,const void *))XComp);
-		alpha.N.x = 1;
-		alpha.off = (v[n/2-1]->x+v[n/2]->x)/2;
-		break;
-
-   case YAxis : qsort((void *)v, (size_t)n, sizeof(Point3 *), 
-				 (int (*)(const void *,const void *))YComp);
-		alpha.N.y = 1;
-		alpha.off = (v[n/2-1]->y+v[n/2]->y)/2;
-		break;
-
-   case ZAxis : qsort((void *)v, (size_t)n, sizeof(Point3 *),
-				 (int (*)(const void *,const void *))ZComp);
-		alpha.N.z = 1;
-		alpha.off = (v[n/2-1]->z+v[n/2]->z)/2;
-		break;
-  }
+ m=ChooseWall(v,n,a,&alpha,&axis,&Predicted);
+ Built=SI.Tetra;
 
  if(CountList(Q)==0)
  {
-  t=FirstTetra(v,n);
+  t=FirstTetra(v,BaseV,n,m);
+  if(!t) Error("FirstTetra, Planar dataset, unable to build first tetrahedron.\n",EXIT);
 
   for(i=0;i<4;i++)
     {
-      switch (Intersect(t->f[i],&alpha))
+      switch (Intersect(BaseV,t->f[i],&alpha))
 	{
 	case  0 :     InsertList(t->f[i], La);	 break;
 	case  1 :     InsertList(t->f[i], Lp);	 break;
 	case -1 :     InsertList(t->f[i], Ln);	 break;
 	}
-      for(j=0;j<3;j++)
-	if(t->f[i]->v[j]->mark==-1)  t->f[i]->v[j]->mark=1;
-	else t->f[i]->v[j]->mark++;
+      MarkFace(BaseV,t->f[i],1);
     }
-  st=Tetra2ShortTetra(t,BaseV);
+  Tetra2ShortTetra(t,&st);
+  i=st.v[0];		/* FirstTetra reversed t->f[0], swap two vertices */
+  st.v[0]=st.v[1];	/* to give st the same orientation of the other   */
+  st.v[1]=i;		/* tetrahedra.					  */
   free(t);
-  InsertList(st,T);
+  AppendStore(&st,T);
   SI.Face+=4;
  }
  else
  {
   while(ExtractList(&f,Q))
-    switch (Intersect(f,&alpha))
+    switch (Intersect(BaseV,f,&alpha))
     {
       case  0 :     InsertList(f, La);	 break;
       case  1 :     InsertList(f, Lp);	 break;
@@ -499,105 +736,103 @@ void DeWall(Point3 *v[], Point3 *BaseV, int *UsedPoint, int n, List Q, List T, e
     }
  }
 
- while(ExtractList(&f,La))
+ if(n>WALL_PARALLEL && ThreadNum()>1)		/* Parallel wall, see wall.c */
+   {
+    W=(WallJob *)malloc(sizeof(WallJob));
+    if(!W) Error("DeWall, Not enough memory for the wall job!!\n",EXIT);
+    InitWallJob(v,BaseV,n,&g,W);
+    Pending=NewList(FIFO,sizeof(Face));
+    ChangeEqualObjectList(EqualFace,Pending);
+    HashList(WALL_BATCH,HashFace,Pending);
+   }
+
+ for(;;)
  {
-  if(n>20) t=FastMakeTetra(f,v,n,&g);
-      else t=MakeTetra(f,v,n);
+  if(W)
+    {
+     if(k==W->nf)
+       {
+	if(WallBatch(La,Pending,W)==0) break;
+	k=0;
+       }
+     f=W->F[k];
+     t=W->T[k++];
+     if(!MemberList(f,Pending))		/* f was closed by a tetrahedron */
+       {					/* of the batch, t is a copy of it */
+	if(t)
+	  {
+	   for(j=0;j<4;j++) free(t->f[j]);
+	   free(t);
+	  }
+	free(f);
+	continue;
+       }
+     DeleteCurrList(Pending);
+    }
+  else
+    {
+     if(!ExtractList(&f,La)) break;
+     if(n>20) t=FastMakeTetra(f,v,BaseV,n,&g);
+	 else t=MakeTetra(f,v,BaseV,n);
+    }
+
   if(t==NULL) SI.CHFace++;
   else
      {
-      st=Tetra2ShortTetra(t,BaseV);
+      Tetra2ShortTetra(t,&st);
 
-      if(SafeTetraFlag) if(MemberList(st, T))
+      if(SafeTetraFlag) if(MemberStore(&st, T))
 			Error("Cyclic Tetrahedra Creation\n",EXIT);
-      InsertList(st,T);
+      AppendStore(&st,T);
 
       SI.Face+=3;
       SI.Tetra++;
 
       if(UpdateFlag)
-	 if(SI.Tetra%50 == 0) printf("Tetrahedra Built %i\r",SI.Tetra++);
+	 if(SI.Tetra%50 == 0) printf("Tetrahedra Built %ld\r",SI.Tetra++);
 
       for(i=1;i<4;i++)
-	 switch (Intersect(t->f[i],&alpha))
+	{
+	 switch (Intersect(BaseV,t->f[i],&alpha))
 	  {
-	   case	0 :	if(MemberList(t->f[i],La))
-			  {
-			   DeleteCurrList(La);
-			   
-			   SI.Face--;
-			   for(j=0;j<3;j++)
-			     t->f[i]->v[j]->mark--;
-			   free(t->f[i]);
-			  }
-			else 
-			  {
-			    InsertList(t->f[i],La);
-			    for(j=0;j<3;j++)
-			      if(t->f[i]->v[j]->mark==-1)  t->f[i]->v[j]->mark=1;
-			      else t->f[i]->v[j]->mark++;
-			    
-			  }
-	     break;
-	   case 1 :	if(MemberList(t->f[i],Lp))
-			  {
-			    DeleteCurrList(Lp);
-			  
-			    SI.Face--;
-			    for(j=0;j<3;j++)
-			      t->f[i]->v[j]->mark--;
-			    free(t->f[i]);
-			  }
-	                else 
-			  {
-			    InsertList(t->f[i],Lp);
-			    for(j=0;j<3;j++)
-			      if(t->f[i]->v[j]->mark==-1)  t->f[i]->v[j]->mark=1;
-			      else t->f[i]->v[j]->mark++;
-			    
-			  }
-	     break;
-	   case -1:	if(MemberList(t->f[i],Ln))
-			  {
-			    DeleteCurrList(Ln);
-	
-			    SI.Face--;
-			    for(j=0;j<3;j++)
-			      t->f[i]->v[j]->mark--;		
-			    free(t->f[i]);
-
-			  }
-			else 
-			  {
-			    InsertList(t->f[i],Ln);
-			    for(j=0;j<3;j++)
-			      if(t->f[i]->v[j]->mark==-1)  t->f[i]->v[j]->mark=1;
-			      else t->f[i]->v[j]->mark++;
-			    
-			  }
-			break;
+	   case	0 : l=La; break;
+	   case	1 : l=Lp; break;
+	   default: l=Ln; break;
 	  }
+	 if(W && l==La && !MemberList(t->f[i],La) && MemberList(t->f[i],Pending))
+	   DeleteCurrList(Pending);	/* Freed when its turn comes  */
+	 else if((old=(Face *)ToggleFace(t->f[i],l))) free(old);
+	 else
+	   {
+	    MarkFace(BaseV,t->f[i],1);	/* A new active face	      */
+	    continue;
+	   }
+	 SI.Face--;			/* The face is closed	      */
+	 MarkFace(BaseV,t->f[i],-1);
+	 free(t->f[i]);
+	}
 
       free(t->f[0]);
       free(t);
      }
   free(f);
  }
+ if(W)
+   {
+    EraseWallJob(W);
+    EraseList(Pending);
+    free(W);
+   }
  if(SI.WallSize==0) SI.WallSize=SI.Tetra;
- /* if(n>20) EraseUG(&g); */ 
+ level=MIN(level,WALL_LEVELS-1);
+ SI.WallNum[level]++;
+ SI.WallPredicted[level]+=Predicted;
+ SI.WallTetra[level]+=SI.Tetra-Built;
+ if(n>20) EraseUG(&g);
 
- switch(a)
-  {
-   case XAxis : if(CountList(Ln)>0) DeWall(v,	     BaseV,UsedPoint,n/2,    Ln,T,YAxis);
-		if(CountList(Lp)>0) DeWall(&(v[n/2]),BaseV,UsedPoint,n-(n/2),Lp,T,YAxis);
-		break;
-   case YAxis : if(CountList(Ln)>0) DeWall(v,	     BaseV,UsedPoint,n/2,    Ln,T,ZAxis);
-		if(CountList(Lp)>0) DeWall(&(v[n/2]),BaseV,UsedPoint,n-(n/2),Lp,T,ZAxis);
-		break;
-   case ZAxis : if(CountList(Ln)>0) DeWall(v,	     BaseV,UsedPoint,n/2,    Ln,T,XAxis);
-		if(CountList(Lp)>0) DeWall(&(v[n/2]),BaseV,UsedPoint,n-(n/2),Lp,T,XAxis);
-		break;
-  }
+ axis=(enum Axis)((axis+1)%3);
+ if(CountList(Ln)>0) DeWall(v,	   BaseV,UsedPoint,m,  Ln,T,axis,level+1,H);
+ if(CountList(Lp)>0) DeWall(&(v[m]),BaseV,UsedPoint,n-m,Lp,T,axis,level+1,H);
 
  EraseList(Ln);
  EraseList(La);
@@ -606,31 +841,75 @@ void DeWall(Point3 *v[], Point3 *BaseV, int *UsedPoint, int n, List Q, List T, e
 
 /***************************************************************************
 *									   *
-* main									   *
+* TriangulateBatch							   *
 *									   *
-* Do the usual command line parsing, file I/O and timing matters.	   *
+* The batch mode: triangulate each set of the batch file name[0] on its   *
+* own and write them all on name[1], or on stdout.			   *
 *									   *
 ***************************************************************************/
 
-main(int argc, char *argv[])
+static int TriangulateBatch(char *name[], int names)
+{
+ FILE *fp=stdout;
+ Batch *B=&(Job.B);
+
+ ReadBatch(name[0],B);
+ if(names>1) Job.fp=fp=fopen(name[1],"w");
+ if(!fp) Error("Unable to open output file\n",EXIT);
+
+ ResetChronos(USER_CHRONOS);
+ StartChronos(USER_CHRONOS);
+ RunBatch(B);
+ StopChronos(USER_CHRONOS);
+
+ SI.Point=(pindex)B->First[B->Sets];
+ SI.Tetra=B->TFirst[B->Sets];
+ SI.Secs=ReadChronos(USER_CHRONOS);
+ printf("Sets:%7ld Points:%7" IDX " Secs:%6.2f Tetras:%7ld\n",B->Sets,SI.Point,SI.Secs,SI.Tetra);
+ if(B->Degenerate)
+   Errorf(NO_EXIT,"%ld of %ld sets are degenerate, without tetrahedra\n",B->Degenerate,B->Sets);
+
+ WriteBatch(B,fp);
+ EndJob();
+ return 0;
+}
+
+
+/***************************************************************************
+*									   *
+* Triangulate								   *
+*									   *
+* Do the usual command line parsing, file I/O and timing matters; the	   *
+* whole program for a command line, or a job of the server.		   *
+*									   *
+***************************************************************************/
+
+static int Triangulate(int argc, char *argv[])
 {
- char buf[80];
+ char buf[80], *s;
  Point3 **v;
  Point3 *BaseV;
  int *usedpoint;
- List	T=NULL_LIST,
-	Q=NULL_LIST;
- int n,i=1;
- FILE *fp=stdout;
+ List	Q=NULL_LIST;
+ Store	T;
+ UG g;
+ Hybrid H;
+ pindex n,i=1;
+ long bad=0;
+ FILE *fp=stdout, *vfp;
+ ShortTetra *tv;
+ long nt;
  double sec;
- SetProgramName("DeWall");
+
+ EndJob();
+ DefaultFlags();
  if((argc<2) ||
     (strcmp(argv[i],"/?")==0)||
     (strcmp(argv[i],"-?")==0)||
     (strcmp(argv[i],"/h")==0)||
     (strcmp(argv[i],"-h")==0)  ) Error(USAGE_MESSAGE, EXIT);
 
-  while(*argv[i]=='-')
+  while(i<argc && *argv[i]=='-')
    {
     switch(argv[i][1])
       {
@@ -646,48 +925,107 @@ main(int argc, char *argv[])
 				}
 		  break;
 
-       case 'u' : UGScaleFlag=ON;
-		  if(argv[i][2]==0 && isdigit(argv[i+1][0]))
-			 UGScale=atof(argv[++i]);
-		    else UGScale=atof(argv[i]+2);
-	          break;
+       case 'u' : if(argv[i][2]==0 && argv[i+1] && strchr("0123456789.as",argv[i+1][0]))
+			 s=argv[++i];
+		    else s=argv[i]+2;
+		  if(*s=='a' || *s=='s')
+		    {
+		     if(*s=='s') UGSubFlag=ON;
+		     if(s[1]) sscanf(s+1,"%lf,%lf",&UGOccupancy,&UGCluster);
+		    }
+		  else
+		    {
+		     UGScaleFlag=ON;
+		     UGScale=atof(s);
+		    }
+		  break;
+
+       case 'a' : AreaFlag=ON;				break;
+       case 'z' : PackFlag=ON;				break;
+       case 'k' : if(argv[i][2]==0) VTKFile=argv[++i];
+		    else VTKFile=argv[i]+2;
+		  break;
+
+       case 'b' : if(!SetFilterBox(&Filter,argv[i][2]==0 ? argv[++i] : argv[i]+2))
+		    Error("Wrong box, give -b xmin,ymin,zmin,xmax,ymax,zmax\n",EXIT);
+		  break;
+       case 'm' : if(!SetFilterClass(&Filter,argv[i][2]==0 ? argv[++i] : argv[i]+2))
+		    Error("Wrong classes, give -m c1,c2,...\n",EXIT);
+		  break;
+
+       case 'w' : if(argv[i][2]==0 && argv[i+1] && strchr("cms",argv[i+1][0]))
+			 s=argv[++i];
+		    else s=argv[i]+2;
+		  WallShift=0;
+		  WallMode= *s=='c' ? WALL_CYCLE : WALL_MODEL;
+		  if(*s=='s') WallShift=s[1] ? atof(s+1) : WALL_SHIFT;
+		  if(WallShift>0.4) WallShift=0.4;
+		  break;
+
+       case 'l' : HybridFlag=ON;
+		  if(argv[i][2]==0 && argv[i+1] && isdigit(argv[i+1][0]))
+			 HybridSize=atol(argv[++i]);
+		    else HybridSize=atol(argv[i]+2);
+		  break;
+
+       case 'v' : if(argv[i][2]==0) VoronoiFile=argv[++i];
+		    else VoronoiFile=argv[i]+2;
+		  break;
+
+       case 'n' : BatchFlag=ON;				break;
+
+       case 'j' : if(argv[i][2]==0 && argv[i+1] && isdigit(argv[i+1][0]))
+			 SetThreadNum(atoi(argv[++i]));
+		    else SetThreadNum(atoi(argv[i]+2));
+		  break;
 
        default	: sprintf(buf,"Unknown options '%s'\n",argv[i]);
 		  Error(buf,NO_EXIT);
       }
     i++;
     }
+ if(i>=argc) Error(USAGE_MESSAGE, EXIT);
+ if(BatchFlag) return TriangulateBatch(argv+i,argc-i);
 
- BaseV=ReadPoints(argv[i++],&n);
+ Job.BaseV=BaseV=ReadPoints(argv[i++],&Filter,&n);
 
- if(argc>i) fp=fopen(argv[i],"w");
+ if(argc>i) Job.fp=fp=fopen(argv[i],PackFlag ? "wb" : "w");
+ if(!fp) Error("Unable to open output file\n",EXIT);
 
  SI.Point=n;
 
- v=(Point3 **)malloc(n*sizeof(Point3 *));
- usedpoint=(int *)malloc(n*sizeof(int));
+ Job.v=v=(Point3 **)malloc(n*sizeof(Point3 *));
+ Job.usedpoint=usedpoint=(int *)malloc(n*sizeof(int));
 
  if(!v || !usedpoint) Error("Unable to allocate memory for Points\n",EXIT);
  for(i=0;i<n;i++) v[i]=&(BaseV[i]);
  for(i=0;i<n;i++)  usedpoint[i] = -1;
 
- Q=NewList(FIFO,sizeof(Face));			/* Initialize First Face  */
+ Job.Q=Q=NewList(FIFO,sizeof(Face));		/* Initialize First Face  */
  ChangeEqualObjectList(EqualFace,Q);		/* List Q.		  */
  if(n>40) HashList(n/4,HashFace,Q);
 
- T=NewList(LIFO,sizeof(ShortTetra));		/* Initialize Built Tetra-*/
- ChangeEqualObjectList(EqualTetra,T);		/* hedra List T.	  */
- if(SafeTetraFlag && n>40) HashList(n/4,HashTetra,T);
+ Job.T=T=NewStore(sizeof(ShortTetra));		/* Initialize Built Tetra-*/
+ if(SafeTetraFlag)				/* hedra Store T.	  */
+   HashStore((long)n*TETRA_PER_POINT,HashTetra,EqualTetra,T);
 
  ResetChronos(USER_CHRONOS);
  StartChronos(USER_CHRONOS);
 
- DeWall(v,BaseV,usedpoint,n,Q,T,XAxis);
+ if(!UGScaleFlag && !UGSubFlag) UGScale=(float)TuneUG(v,n)/n;
+ if(HybridFlag)
+   {
+    InitHybrid(n,HybridSize,&H);
+    DeWall(v,BaseV,usedpoint,n,Q,T,XAxis,0,&H);
+    RunLeaves(BaseV,T,&H);
+    EraseHybrid(&H);
+   }
+ else DeWall(v,BaseV,usedpoint,n,Q,T,XAxis,0,NULL);
 
  StopChronos(USER_CHRONOS);
  sec=ReadChronos(USER_CHRONOS);
 
- SI.Tetra=CountList(T);
+ SI.Tetra=CountStore(T);
  
 
  SI.Secs=sec;
@@ -696,9 +1034,69 @@ main(int argc, char *argv[])
  if(StatFlag && NumStatFlag && NumStatTitleFlag) PrintNumStatTitle();
  if(StatFlag && NumStatFlag) PrintNumStat();
  if(!StatFlag)
-     printf("Points:%7i Secs:%6.2f Tetras:%7i\n",SI.Point,SI.Secs,SI.Tetra);
+     printf("Points:%7" IDX " Secs:%6.2f Tetras:%7ld\n",SI.Point,SI.Secs,SI.Tetra);
 
- WriteTetraList(T,fp);
+ if(CheckFlag)
+   {
+    for(i=0;i<n;i++) v[i]=&(BaseV[i]);
+    BuildUG(v,usedpoint,n,UG_CELLS(n),&g);
+    bad=CheckTriangulation(T,BaseV,&g);
+    EraseUG(&g);
+    if(bad) Errorf(NO_EXIT,"%ld of %ld tetrahedra are not Delaunay!\n",bad,SI.Tetra);
+       else printf("Checked %ld tetrahedra, all Delaunay.\n",SI.Tetra);
+   }
 
- return 0;
+ if(VTKFile)
+   {
+    vfp=fopen(VTKFile,"wb");
+    if(!vfp) Error("Unable to open VTK output file\n",EXIT);
+    WriteVTK(T,BaseV,sizeof(Point3),n,AreaFlag,vfp);
+    fclose(vfp);
+   }
+
+ if(PackFlag)
+   {
+    nt=CountStore(T);
+    Job.tv=tv=(ShortTetra *)Store2Vector(T);	/* Held twice for a moment */
+    Job.T=NULL;
+    WriteTetPack(tv[0].v,nt,n,fp);		/* Sorts tv		  */
+    if(VoronoiFile)
+      {
+       Job.T=T=Vector2Store(tv,nt,sizeof(ShortTetra));	/* Packed order */
+       Job.tv=NULL;
+       if(!T) Error("Unable to allocate memory for Tetrahedra\n",EXIT);
+      }
+   }
+ else WriteTetraStore(T,fp);
+
+ if(VoronoiFile)
+   {
+    vfp=fopen(VoronoiFile,"w");
+    if(!vfp) Error("Unable to open Voronoi output file\n",EXIT);
+    WriteVoronoi(T,BaseV,sizeof(Point3),n,AreaFlag,vfp);
+    fclose(vfp);
+   }
+
+ EndJob();
+ return bad ? 1 : 0;
+}
+
+
+/***************************************************************************
+*									   *
+* main									   *
+*									   *
+* Triangulate the command line, or serve the jobs sent on a socket.	   *
+*									   *
+***************************************************************************/
+
+main(int argc, char *argv[])
+{
+ SetProgramName("DeWall");
+ if(argc==3 && strcmp(argv[1],"-d")==0)
+   {
+    ServeJobs(argv[2],argv[0],Triangulate);
+    return 0;
+   }
+ return Triangulate(argc,argv);
 }
@@ -24,6 +24,8 @@
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
 
 #include <math.h>
 #include <stdio.h>
@@ -32,11 +34,13 @@
 #include "graphics.h"
 #include "dewall.h"
 
-extern StatInfo SI;
+extern PARALLEL_LOCAL StatInfo SI;
 extern NumStatFlag;
 
 void InitStat()
 {
+ int i;
+
  SI.Tetra=1;
  SI.MakeTetra=0;
  SI.EqualTest=0;
@@ -50,30 +54,68 @@ void InitStat()
  SI.MinRadiusNum=0;
  SI.Radius=0;
 SI.WallSize=0;
+ SI.Cluster=0;
+ for(i=0;i<WALL_LEVELS;i++)
+   {
+    SI.WallNum[i]=0;
+    SI.WallPredicted[i]=0;
+    SI.WallTetra[i]=0;
+   }
+}
+
+/*
+ * AddStat
+ *
+ * Aggiunge a to i contatori accumulati in s dopo la copia base, per
+ * sommare quelli dei thread che hanno completato le foglie.
+ */
+
+void AddStat(StatInfo *s, StatInfo *base, StatInfo *to)
+{
+ to->Face	     += s->Face	- base->Face;
+ to->CHFace	     += s->CHFace	- base->CHFace;
+ to->Tetra	     += s->Tetra	- base->Tetra;
+ to->EqualTest	     += s->EqualTest	- base->EqualTest;
+ to->TestedPoint     += s->TestedPoint	- base->TestedPoint;
+ to->MakeTetra	     += s->MakeTetra	- base->MakeTetra;
+ to->MinRadius	     += s->MinRadius	- base->MinRadius;
+ to->Radius	     += s->Radius	- base->Radius;
+ to->MinRadiusNum    += s->MinRadiusNum	- base->MinRadiusNum;
+ to->EmptyBox	     += s->EmptyBox	- base->EmptyBox;
+ to->SecondBox	     += s->SecondBox	- base->SecondBox;
+ to->UsefulSecondBox += s->UsefulSecondBox - base->UsefulSecondBox;
+ to->TestedCell	     += s->TestedCell	- base->TestedCell;
 }
 
 void PrintStat()
 {
+ int i;
+
  printf("+----- Statistical Informations ----------------------------------------+\n");
 
  printf("|Points     |Time (sec.)|Tetras     |Faces      |CH Faces   |TetraRadius|");
  printf("\n");
- printf("|%7i    |%7.3f    |%7i    |%7i    |%7i    |%7.3f    |",SI.Point,SI.Secs,SI.Tetra,SI.Face,SI.CHFace,SI.Radius/SI.Tetra);
+ printf("|%7" IDX "    |%7.3f    |%7ld    |%7ld    |%7ld    |%7.3f    |",SI.Point,SI.Secs,SI.Tetra,SI.Face,SI.CHFace,SI.Radius/SI.Tetra);
  printf("\n");
 
  printf("|UGMakeTetra|Empty Box  | 2nd Box   |Useful 2nd |PntPerFace |CellPerFace|");
  printf("\n");
- printf("|%7i    |%7i    |%7i    |%7i    |%7.2f    |%7.2f    ",SI.MakeTetra,SI.EmptyBox,SI.SecondBox,SI.UsefulSecondBox,(double)SI.TestedPoint/SI.Face,(double)SI.TestedCell/SI.Face);
+ printf("|%7ld    |%7ld    |%7ld    |%7ld    |%7.2f    |%7.2f    ",SI.MakeTetra,SI.EmptyBox,SI.SecondBox,SI.UsefulSecondBox,(double)SI.TestedPoint/SI.Face,(double)SI.TestedCell/SI.Face);
  printf("\n");
- printf("WallSize %7i, Cell Num %7i   Empty Cell %7i MaxPoint %7i   \n",
-	SI.WallSize,SI.Cell, SI.EmptyCell, SI.MaxPointPerCell);
+ printf("WallSize %7ld, Cell Num %7i   Empty Cell %7i MaxPoint %7i   Cluster %7.3f\n",
+	SI.WallSize,SI.Cell, SI.EmptyCell, SI.MaxPointPerCell, SI.Cluster);
+ printf("Level  Walls    Predicted    Tetras   (average wall size)\n");
+ for(i=0;i<WALL_LEVELS;i++)
+   if(SI.WallNum[i]>0)
+     printf("%5i %6i   %10.1f %9.1f\n",i,SI.WallNum[i],
+	    SI.WallPredicted[i]/SI.WallNum[i],(double)SI.WallTetra[i]/SI.WallNum[i]);
 }
 
 void PrintNumStat()
 {
- printf("%7i   , %7.3f   , %7i   , %7i   , %7i   , %7.3f   , ",
+ printf("%7" IDX "   , %7.3f   , %7ld   , %7ld   , %7ld   , %7.3f   , ",
 	SI.Point,SI.Secs,SI.Tetra,SI.Face,SI.CHFace,SI.Radius/SI.Tetra);
- printf("%7i   , %7i   , %7i   , %7i   , %7.2f   , %7.2f   , ",
+ printf("%7ld   , %7ld   , %7ld   , %7ld   , %7.2f   , %7.2f   , ",
 	SI.MakeTetra, SI.EmptyBox, SI.SecondBox, SI.UsefulSecondBox,
 	(double)SI.TestedPoint/SI.Face,(double)SI.TestedCell/SI.Face);
 
@@ -10,7 +10,10 @@
 * IMPORTS:      OList                                                      *
 *               Statistic Variables                                        *
 *                                                                          *
-* EXPORTS:	BuildUG       Initialize the UG data structure		   *
+* EXPORTS:	TuneUG        Choose the size of the UG			   *
+*		BuildUG       Initialize the UG data structure		   *
+*		ReuseUG       Initialize a UG in the memory of a UGSpace   *
+*		EraseUGSpace  Free the memory of a UGSpace		   *
 *               FastMakeTetra   Build a new tetra using UG to speed up     *
 *                                                                          *
 *   NOTES:      This is the optimized version of the InCoDe algorithm.     *
@@ -26,24 +29,29 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <limits.h>
 #include "graphics.h"
 
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/delaunay.h>
 
 #include "dewall.h"
 
 
 /* Global for Statistic Infomations */
 
-extern StatInfo SI;
+extern PARALLEL_LOCAL StatInfo SI;
 
 /* Global Program Flag */
 
-extern boolean CheckFlag;
 extern boolean StatFlag;
+extern double	UGOccupancy, UGCluster;
 
 /***************************************************************************
 *									   *
@@ -56,7 +64,17 @@ extern boolean StatFlag;
 *									   *
 ***************************************************************************/
 
-Plist *AddPoint(Plist *P, Point3 *p)
+static Plist *InitPlist(Plist *TempP, Plist *P, Point3 *p, Point3 *o)
+{
+ TempP->p=p;
+ V3Sub(p,o,&(TempP->r));
+ TempP->w=V3Dot(&(TempP->r),&(TempP->r));
+ TempP->next=P;
+
+ return TempP;
+}
+
+Plist *AddPoint(Plist *P, Point3 *p, Point3 *o)
 {
  Plist *TempP;
 
@@ -64,10 +82,7 @@ Plist *AddPoint(Plist *P, Point3 *p)
  if(!TempP)
    Error("Insufficient memory to add a point to point list of the UG cell!!\n", EXIT);
 
- TempP->p=p;
- TempP->next=P;
-
- return TempP;
+ return InitPlist(TempP,P,p,o);
 }
 
 void ErasePlist(Plist *P)
@@ -111,6 +126,82 @@ boolean UGIsMarked(UG *G, int Index)
 }
 
 
+/***************************************************************************
+*									   *
+* TuneUG								   *
+*									   *
+* Choose the number of cells of the UG for the n points of v.		   *
+*									   *
+* S = min(n,UG_SAMPLE) points, evenly spaced in v, are binned in a coarse  *
+* grid of about S/UG_SAMPLE_CELL cells over their bounding box. If c is    *
+* the count of a coarse cell, the sum of c(c-1) is the number of ordered   *
+* pairs of sampled points that are near; in a uniform set it is about	   *
+* S(S-1)/cells, so the clustering index					   *
+*									   *
+*		 K = sum c(c-1) * cells / (S(S-1))			   *
+*									   *
+* is 1 for uniform sets and grows with the clustering (it is the density   *
+* seen by the average point over the mean density). The UG gets		   *
+* n * K^UGCluster / UGOccupancy cells, see UG tuning in dewall.h.	   *
+*									   *
+* It costs O(S), so it can be called for every DeWall subproblem.	   *
+*									   *
+***************************************************************************/
+
+int TuneUG(Point3 *v[], pindex n)
+{
+ Point3 vn, vp, *p;
+ pindex i, j, S;
+ int x, y, z, ix, iy, iz, *Count;
+ double volume, side, sum=0, K, m;
+
+ S=MIN(n,UG_SAMPLE);
+ if(S<2*UG_SAMPLE_CELL) return UG_CELLS(n);
+
+ vn=vp=*(v[0]);
+ for(i=0;i<S;i++)		/* Bounding Box del campione */
+  {
+   p=v[(pindex)((double)i*n/S)];
+   if(p->x < vn.x) vn.x=p->x;
+   if(p->y < vn.y) vn.y=p->y;
+   if(p->z < vn.z) vn.z=p->z;
+   if(p->x > vp.x) vp.x=p->x;
+   if(p->y > vp.y) vp.y=p->y;
+   if(p->z > vp.z) vp.z=p->z;
+  }
+
+ volume=(vp.x-vn.x)*(vp.y-vn.y)*(vp.z-vn.z);
+ if(volume<=0) return UG_CELLS(n);		/* Punti complanari, come BuildUG */
+
+ side=pow(volume*UG_SAMPLE_CELL/S,1.0/3.0);
+ x=MAX((int)ceil((vp.x-vn.x)/side),1);
+ y=MAX((int)ceil((vp.y-vn.y)/side),1);
+ z=MAX((int)ceil((vp.z-vn.z)/side),1);
+
+ Count=(int *)calloc((size_t)x*y*z,sizeof(int));
+ if(!Count) Error("TuneUG, Not enough memory to sample the points!!\n",EXIT);
+
+ for(i=0;i<S;i++)
+  {
+   p=v[(pindex)((double)i*n/S)];
+   ix=MIN((int)((p->x-vn.x)/side),x-1);
+   iy=MIN((int)((p->y-vn.y)/side),y-1);
+   iz=MIN((int)((p->z-vn.z)/side),z-1);
+   Count[ix + iy*x + iz*x*y]++;
+  }
+ for(j=0;j<(pindex)x*y*z;j++) sum+=(double)Count[j]*(Count[j]-1);
+ free(Count);
+
+ K=sum*(volume/(side*side*side))/((double)S*(S-1));
+ SI.Cluster=K;
+
+ m=n*pow(K,UGCluster)/UGOccupancy;
+ m=MAX(m,n*UG_MIN_SCALE);
+ m=MIN(m,n*UG_MAX_SCALE);
+ return UG_CELLS(m);
+}
+
+
 /***************************************************************************
 *									   *
 * BuildUG								   *
@@ -170,19 +261,44 @@ boolean UGIsMarked(UG *G, int Index)
 *    |	 | * |	*|   |							   *
 *    +---+---+*--+---+							   *
 *									   *
-*									   *
+* The cells are sized by the SizeGrid of OList, shared with the E^d	   *
+* programs, that also enlarges the cells of nearly flat point sets.	   *
 *									   *
 ***************************************************************************/
 
-UG *BuildUG(Point3 *v[], int *UsedPoint, int n, int m, UG *G)
+/*
+ * GridUG
+ *
+ * Le celle della UG di m celle nel bounding box G->vn-G->vp, calcolate da
+ * SizeGrid, che allarga il box a un numero intero di celle.
+ */
+
+static void GridUG(UG *G, int m)
 {
- int i;
- int indx, indy, indz, index;
- int CellNumber;
- double volume;
- double xoffset,yoffset,zoffset;
+ double vn[3], vp[3];
+ int c[3];
+
+ vn[0]=G->vn.x; vn[1]=G->vn.y; vn[2]=G->vn.z;
+ vp[0]=G->vp.x; vp[1]=G->vp.y; vp[2]=G->vp.z;
+
+ G->n=(int)SizeGrid(vn,vp,3,(double)m,c,&(G->side));
+
+ G->x=c[0]; G->y=c[1]; G->z=c[2];
+ G->vn.x=vn[0]; G->vn.y=vn[1]; G->vn.z=vn[2];
+ G->vp.x=vp[0]; G->vp.y=vp[1]; G->vp.z=vp[2];
+}
+
+
+/*
+ * SizeUG
+ *
+ * Il bounding box degli n punti di v e le dimensioni della UG di m celle.
+ */
+
+static void SizeUG(Point3 *v[], pindex n, int m, UG *G)
+{
+ pindex i;
 
- G->UsedPoint = UsedPoint;
  G->vn.x=v[0]->x;
  G->vn.y=v[0]->y;
  G->vn.z=v[0]->z;
@@ -202,55 +318,47 @@ UG *BuildUG(Point3 *v[], int *UsedPoint, int n, int m, UG *G)
   if(v[i]->z > G->vp.z) G->vp.z=v[i]->z;
  }
 
- volume=(G->vp.x - G->vn.x)*(G->vp.y - G->vn.y)*(G->vp.z - G->vn.z);
- G->side = pow(volume/(double)m,0.3333333);
+ GridUG(G,m);			/* How many cell per side */
  SI.CellEdge=G->side;
 
- G->x=(int)ceil((G->vp.x - G->vn.x)/G->side);  /* How many cell per side */
- G->y=(int)ceil((G->vp.y - G->vn.y)/G->side);
- G->z=(int)ceil((G->vp.z - G->vn.z)/G->side);
-
- xoffset = G->x*G->side - (G->vp.x-G->vn.x);
- yoffset = G->y*G->side - (G->vp.y-G->vn.y);
- zoffset = G->z*G->side - (G->vp.z-G->vn.z);
-
-
- G->vn.x -= xoffset/2;
- G->vn.y -= yoffset/2;
- G->vn.z -= zoffset/2;
-
- G->vp.x += xoffset/2;
- G->vp.y += yoffset/2;
- G->vp.z += zoffset/2;
+ G->o.x=(G->vn.x+G->vp.x)/2;
+ G->o.y=(G->vn.y+G->vp.y)/2;
+ G->o.z=(G->vn.z+G->vp.z)/2;
 
+ SI.Cell=G->n;
+}
 
- CellNumber=G->x*G->y*G->z;
- G->n=CellNumber;
 
- SI.Cell=CellNumber;
+/*
+ * FillUG
+ *
+ * Mette i punti nelle celle della UG, che devono essere vuote. I nodi
+ * delle liste sono quelli del vettore Node, uno per punto, se c'e',
+ * altrimenti sono allocati uno per uno.
+ */
 
- G->C  =  (Plist **)calloc((size_t)CellNumber, sizeof(Plist *));
- G->Marked = (int *)calloc((size_t)CellNumber, sizeof(int));
- if(!G->C || !G->Marked) Error("BuildUG, Not enough memory to build UG!!\n",EXIT);
+static void FillUG(Point3 *v[], pindex n, Plist *Node, UG *G)
+{
+ pindex i;
+ int indx, indy, indz, index;
 
  for(i=0;i<n;i++)
  {
-  indx=(int)((v[i]->x - G->vn.x)/G->side);
-  indy=(int)((v[i]->y - G->vn.y)/G->side);
-  indz=(int)((v[i]->z - G->vn.z)/G->side);
+  indx=GridCoord(v[i]->x, G->vn.x, G->side, G->x);
+  indy=GridCoord(v[i]->y, G->vn.y, G->side, G->y);
+  indz=GridCoord(v[i]->z, G->vn.z, G->side, G->z);
   index=indx + indy*G->x + indz*G->y*G->x;
-  G->C[index] = AddPoint((G->C)[index], v[i]);
+  if(Node) G->C[index] = InitPlist(&Node[i], (G->C)[index], v[i], &(G->o));
+      else G->C[index] = AddPoint((G->C)[index], v[i], &(G->o));
  }
 
- G->Mark=0;
-
 
  if(StatFlag)	  /* Calculate Statistical Information only if needed */
  {
   int c;
   SI.EmptyCell=0;
 
-  for(i=0;i<CellNumber;i++)
+  for(i=0;i<G->n;i++)
    {
     c=0;
     if(!G->C[i]) SI.EmptyCell++;	/* How many cell are empty?  */
@@ -267,9 +375,92 @@ UG *BuildUG(Point3 *v[], int *UsedPoint, int n, int m, UG *G)
      }
    }
  }
+}
+
+UG *BuildUG(Point3 *v[], int *UsedPoint, pindex n, int m, UG *G)
+{
+ G->UsedPoint = UsedPoint;
+ SizeUG(v,n,m,G);
+
+ G->C  =  (Plist **)calloc((size_t)G->n, sizeof(Plist *));
+ G->Marked = (int *)calloc((size_t)G->n, sizeof(int));
+ if(!G->C || !G->Marked) Error("BuildUG, Not enough memory to build UG!!\n",EXIT);
+
+ G->Mark=0;
+ FillUG(v,n,NULL,G);
+ return G;
+}
+
+
+/***************************************************************************
+*									   *
+* ReuseUG								   *
+*									   *
+* As BuildUG, but the cells, their marks and the nodes of the point lists  *
+* are taken from S, that grows to the largest UG built in it and is never  *
+* freed by EraseUG. A thread that builds many small UG one after the other *
+* (see batch.c) allocates nothing after the first few. G must be the same  *
+* UG for all the calls with S, or a zeroed one on the first call: the cell *
+* marks are not cleared, it keeps increasing its Mark instead.		   *
+*									   *
+***************************************************************************/
+
+UG *ReuseUG(Point3 *v[], int *UsedPoint, pindex n, int m, UG *G, UGSpace *S)
+{
+ G->UsedPoint = UsedPoint;
+ SizeUG(v,n,m,G);
+
+ if(G->n > S->Cells)
+   {
+    free(S->C);
+    free(S->Marked);
+    S->Cells=MAX(G->n,2*S->Cells);
+    S->C=(Plist **)malloc((size_t)S->Cells*sizeof(Plist *));
+    S->Marked=(int *)calloc((size_t)S->Cells,sizeof(int));
+    if(!S->C || !S->Marked) Error("ReuseUG, Not enough memory to build UG!!\n",EXIT);
+    G->Mark=0;
+   }
+ if(n > S->Nodes)
+   {
+    free(S->Node);
+    S->Nodes=MAX(n,2*S->Nodes);
+    S->Node=(Plist *)malloc((size_t)S->Nodes*sizeof(Plist));
+    if(!S->Node) Error("ReuseUG, Not enough memory to build UG!!\n",EXIT);
+   }
+ if(G->Mark > INT_MAX/2)		/* Far from the overflow of Mark */
+   {
+    memset(S->Marked,0,(size_t)S->Cells*sizeof(int));
+    G->Mark=0;
+   }
+
+ memset(S->C,0,(size_t)G->n*sizeof(Plist *));
+ G->C=S->C;
+ G->Marked=S->Marked;
+ FillUG(v,n,S->Node,G);
  return G;
 }
 
+
+/***************************************************************************
+*									   *
+* EraseUGSpace								   *
+*									   *
+* Free the memory of the UG built in S by ReuseUG.			   *
+*									   *
+***************************************************************************/
+
+void EraseUGSpace(UGSpace *S)
+{
+ free(S->C);
+ free(S->Marked);
+ free(S->Node);
+ S->C=NULL;
+ S->Marked=NULL;
+ S->Node=NULL;
+ S->Cells=0;
+ S->Nodes=0;
+}
+
 void EraseUG(UG *G)
 {
  int i;
@@ -318,14 +509,14 @@ void EraseUG(UG *G)
 *									   *
 ***************************************************************************/
 
-double CalcBox(Face *f, Line *Lc, UG *G,
+double CalcBox(Face *f, Point3 *BaseV, Line *Lc, UG *G,
 				IntPoint3 *vn, IntPoint3 *vp, double Radius)
 {
  Point3 BoxCenter;
  double FaceRadius;
  double offset;
 
- FaceRadius=V3DistanceBetween2Points(&(Lc->Lu), f->v[0]);
+ FaceRadius=V3DistanceBetween2Points(&(Lc->Lu), &(BaseV[f->v[0]]));
 
  offset=sqrt(Radius*Radius - FaceRadius*FaceRadius);
 
@@ -333,20 +524,13 @@ double CalcBox(Face *f, Line *Lc, UG *G,
  BoxCenter.y=Lc->Lu.y+Lc->Lv.y*offset;
  BoxCenter.z=Lc->Lu.z+Lc->Lv.z*offset;
 
- vn->x = (int)((BoxCenter.x - G->vn.x - Radius)/G->side);
- vn->y = (int)((BoxCenter.y - G->vn.y - Radius)/G->side);
- vn->z = (int)((BoxCenter.z - G->vn.z - Radius)/G->side);
-
- vp->x = (int)((BoxCenter.x - G->vn.x + Radius)/G->side);
- vp->y = (int)((BoxCenter.y - G->vn.y + Radius)/G->side);
- vp->z = (int)((BoxCenter.z - G->vn.z + Radius)/G->side);
+ vn->x = GridCoord(BoxCenter.x - Radius, G->vn.x, G->side, G->x);
+ vn->y = GridCoord(BoxCenter.y - Radius, G->vn.y, G->side, G->y);
+ vn->z = GridCoord(BoxCenter.z - Radius, G->vn.z, G->side, G->z);
 
- vn->x=max(0,vn->x);
- vn->y=max(0,vn->y);
- vn->z=max(0,vn->z);
- vp->x=min(G->x-1,vp->x);
- vp->y=min(G->y-1,vp->y);
- vp->z=min(G->z-1,vp->z);
+ vp->x = GridCoord(BoxCenter.x + Radius, G->vn.x, G->side, G->x);
+ vp->y = GridCoord(BoxCenter.y + Radius, G->vn.y, G->side, G->y);
+ vp->z = GridCoord(BoxCenter.z + Radius, G->vn.z, G->side, G->z);
 
  return(Radius*Radius);
 }
@@ -362,7 +546,7 @@ double CalcBox(Face *f, Line *Lc, UG *G,
 * performance of the algorithm, so this function is actually unused.	   *
 *									   *
 ***************************************************************************/
-double CalcBestBox(Face *f, Line *Lc, UG *G,
+double CalcBestBox(Face *f, Point3 *BaseV, Line *Lc, UG *G,
 				IntPoint3 *vn, IntPoint3 *vp, double Radius)
 {
  IntPoint3 tvn,tvp;
@@ -370,7 +554,7 @@ double CalcBestBox(Face *f, Line *Lc, UG *G,
  int i;
  double MaxRadius,TestRadius,MinRadius,CalcRadius,NewRadius;
 
- CalcRadius=CalcBox(f,Lc,G,vn,vp,Radius);
+ CalcRadius=CalcBox(f,BaseV,Lc,G,vn,vp,Radius);
 
  MaxSide=	      vp->x - vn->x + 1;
  MaxSide=min(MaxSide,(vp->y - vn->y + 1));
@@ -386,7 +570,7 @@ double CalcBestBox(Face *f, Line *Lc, UG *G,
  {
   TestRadius=(MinRadius+MaxRadius)/2;
 
-  NewRadius=CalcBox(f,Lc,G,&tvn,&tvp,TestRadius);
+  NewRadius=CalcBox(f,BaseV,Lc,G,&tvn,&tvp,TestRadius);
   if((tvn.x==vn->x)&&(tvn.y==vn->y)&&(tvn.z==vn->z)&&
      (tvp.x==vp->x)&&(tvp.y==vp->y)&&(tvp.z==vp->z))
 		       {
@@ -492,6 +676,33 @@ boolean ExaminableCell(int x, int y, int z, Plane *p, UG *c)
 
 }
 
+/***************************************************************************
+*									   *
+* DDRadius								   *
+*									   *
+* Given a point of a cell and the DDForm of a face, it calculates the	   *
+* squared radius of the sphere through the face and the point, negative if *
+* the center is not on the right side of the face. It uses the coords and  *
+* the lifted coord kept in the Plist node, not the point itself.	   *
+* It returns FALSE if the point is not on the right side of the face.	   *
+*									   *
+***************************************************************************/
+
+static boolean DDRadius(Plist *P, DDForm *d, double *Radius)
+{
+ double h, t;
+
+ h=d->N.x*P->r.x + d->N.y*P->r.y + d->N.z*P->r.z - d->off;
+ if(h <= EPSILON) return FALSE;
+
+ t=(P->w + d->A.x*P->r.x + d->A.y*P->r.y + d->A.z*P->r.z + d->K)/(2*h);
+ SI.TestedPoint++;
+
+ *Radius=d->R2+t*t;			/* t is the offset of the center  */
+ if(t <= EPSILON) *Radius=-*Radius;	/* from the face plane		  */
+ return TRUE;
+}
+
 /***************************************************************************
 *									   *
 * ScanCellBox								   *
@@ -505,14 +716,12 @@ boolean ExaminableCell(int x, int y, int z, Plane *p, UG *c)
 *									   *
 ***************************************************************************/
 
-boolean ScanCellBox(IntPoint3 *vn, IntPoint3 *vp,
-	Face *f, Line *Lc, Plane *p, UG *G, Point3 **index, double *MinRadius)
+boolean ScanCellBox(IntPoint3 *vn, IntPoint3 *vp, Point3 *BaseV,
+	Face *f, DDForm *d, UG *G, Point3 **index, double *MinRadius)
 {
  int i,j,k;
  int CellIndex;
  Plist *P;
- Plane Mp;
- Point3 c;
  double Radius;
  Point3 *pntptr=NULL;
  boolean Found=FALSE;
@@ -530,25 +739,17 @@ boolean ScanCellBox(IntPoint3 *vn, IntPoint3 *vp,
 	      {
 	       pntptr=P->p;
 	       if(pntptr->mark!=0)
-	       if((pntptr!=f->v[0]) &&
-		  (pntptr!=f->v[1]) &&
-		  (pntptr!=f->v[2]) &&
-		   RightSide(p,pntptr) )
+	       if((pntptr-BaseV!=f->v[0]) &&
+		  (pntptr-BaseV!=f->v[1]) &&
+		  (pntptr-BaseV!=f->v[2]) &&
+		   DDRadius(P,d,&Radius) )
 		   {
-		    CalcMiddlePlane(pntptr,f->v[0],&Mp);
-		    if(CalcLinePlaneInter(Lc,&Mp,&c))
+		    if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
+		    if(Radius<*MinRadius)
 		      {
-			Radius=V3SquaredDistanceBetween2Points(&c, pntptr);
-			if(!RightSide(p,&c)) Radius=-Radius;
-
-			if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
-			if(Radius<*MinRadius)
-				{
-				 *MinRadius=Radius;
-				 *index=pntptr;
-				 Found=TRUE;
-				}
-
+		       *MinRadius=Radius;
+		       *index=pntptr;
+		       Found=TRUE;
 		      }
 		   }
 	       P=P->next;
@@ -568,14 +769,12 @@ boolean ScanCellBox(IntPoint3 *vn, IntPoint3 *vp,
 *									   *
 ***************************************************************************/
 
-boolean MakeLastScan(IntPoint3 *Start, IntPoint3 *End, IntPoint3 *Inc,
-	 Face *f, Line *Lc, Plane *p, UG *G, Point3 **index, double *MinRadius)
+boolean MakeLastScan(IntPoint3 *Start, IntPoint3 *End, IntPoint3 *Inc, Point3 *BaseV,
+	 Face *f, DDForm *d, Plane *p, UG *G, Point3 **index, double *MinRadius)
 {
  int i,j,k;
  int CellIndex;
  Plist *P;
- Plane Mp;
- Point3 c;
  double Radius;
  Point3* pntptr=NULL;
 
@@ -597,24 +796,17 @@ boolean MakeLastScan(IntPoint3 *Start, IntPoint3 *End, IntPoint3 *Inc,
 			while(P)
 			 {
 			  pntptr=P->p;
-			  if((pntptr!=f->v[0]) &&
-			     (pntptr!=f->v[1]) &&
-			     (pntptr!=f->v[2]) &&
-			     RightSide(p, pntptr) )
+			  if((pntptr-BaseV!=f->v[0]) &&
+			     (pntptr-BaseV!=f->v[1]) &&
+			     (pntptr-BaseV!=f->v[2]) &&
+			     DDRadius(P,d,&Radius) )
 			   {
-			    CalcMiddlePlane(pntptr, f->v[0],&Mp);
-			    if(CalcLinePlaneInter(Lc,&Mp,&c))
-			     {
-			      Radius=V3SquaredDistanceBetween2Points(&c, pntptr);
-
-			      if(!RightSide(p,&c)) Radius=-Radius;
-			      if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
-			      if(Radius<*MinRadius)
-				{
-				 *MinRadius=Radius;
-				 *index=pntptr;
-				}
-			     }
+			    if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
+			    if(Radius<*MinRadius)
+			      {
+			       *MinRadius=Radius;
+			       *index=pntptr;
+			      }
 			   }
 			  P=P->next;
 			 }   /* end while		  */
@@ -652,7 +844,7 @@ boolean MakeLastScan(IntPoint3 *Start, IntPoint3 *End, IntPoint3 *Inc,
 *									   *
 ***************************************************************************/
 
-Tetra *FastMakeTetra(Face *f, Point3 *v[], int n, UG *G)
+Tetra *FastMakeTetra(Face *f, Point3 *v[], Point3 *BaseV, pindex n, UG *G)
 {
  Plane p;
  Tetra *t;
@@ -662,6 +854,7 @@ Tetra *FastMakeTetra(Face *f, Point3 *v[], int n, UG *G)
 	MinRadius=BIGNUMBER;
 
  Line Lc;
+ DDForm d;
  IntPoint3 vn,vp, start, end, inc;
  Point3 *Index=NULL;
  boolean Found=FALSE;
@@ -670,18 +863,19 @@ Tetra *FastMakeTetra(Face *f, Point3 *v[], int n, UG *G)
 
  UGResetMark(G);
 
- if(!CalcPlane(f->v[0], f->v[1], f->v[2], &p))
+ if(!CalcPlane(&(BaseV[f->v[0]]), &(BaseV[f->v[1]]), &(BaseV[f->v[2]]), &p))
 		Error("Faccia composta da tre punti allineati!!\n",EXIT);
 
- CalcLineofCenter(f->v[0], f->v[1], f->v[2], &Lc);
+ CalcLineofCenter(&(BaseV[f->v[0]]), &(BaseV[f->v[1]]), &(BaseV[f->v[2]]), &Lc);
 
- FaceRadius=V3DistanceBetween2Points(&(Lc.Lu), f->v[0]);
+ FaceRadius=V3DistanceBetween2Points(&(Lc.Lu), &(BaseV[f->v[0]]));
+ CalcDDForm(&p,&Lc,FaceRadius,&(G->o),&d);
 
  do
  {
   CellBoxRadius++;
-  BoxRadius=CalcBox(f,&Lc,G,&vn,&vp, CellBoxRadius*FaceRadius);
-  Found=ScanCellBox(&vn, &vp, f, &Lc, &p, G, &Index, &MinRadius);
+  BoxRadius=CalcBox(f,BaseV,&Lc,G,&vn,&vp, CellBoxRadius*FaceRadius);
+  Found=ScanCellBox(&vn, &vp, BaseV, f, &d, G, &Index, &MinRadius);
  }
  while(!Found && CellBoxRadius <= 1);
 
@@ -689,8 +883,8 @@ Tetra *FastMakeTetra(Face *f, Point3 *v[], int n, UG *G)
  {double oldMinRadius=MinRadius;
 
   SI.SecondBox++;
-  BoxRadius=CalcBox(f,&Lc,G,&vn,&vp, sqrt(MinRadius));
-  ScanCellBox(&vn, &vp, f, &Lc, &p, G, &Index, &MinRadius);
+  BoxRadius=CalcBox(f,BaseV,&Lc,G,&vn,&vp, sqrt(MinRadius));
+  ScanCellBox(&vn, &vp, BaseV, f, &d, G, &Index, &MinRadius);
   if(oldMinRadius>MinRadius) SI.UsefulSecondBox++;
  }
 
@@ -698,7 +892,7 @@ Tetra *FastMakeTetra(Face *f, Point3 *v[], int n, UG *G)
  {
   SI.EmptyBox++;
   CalcLastScan(G, &start, &end, &inc, &p);
-  Found=MakeLastScan(&start, &end, &inc, f, &Lc, &p, G, &Index,&MinRadius);
+  Found=MakeLastScan(&start, &end, &inc, BaseV, f, &d, &p, G, &Index,&MinRadius);
  }
 
  if(!Found) return NULL;
@@ -709,14 +903,12 @@ Tetra *FastMakeTetra(Face *f, Point3 *v[], int n, UG *G)
  }
 
 
- t=BuildTetra(f,Index);
+ t=BuildTetra(f,(pindex)(Index-BaseV));
  if(StatFlag)
  {Point3 C;
-  CalcSphereCenter(f->v[0], f->v[1], f->v[2], Index,&C);
+  CalcSphereCenter(&(BaseV[f->v[0]]), &(BaseV[f->v[1]]), &(BaseV[f->v[2]]), Index,&C);
   SI.Radius+=V3DistanceBetween2Points(&C, Index);
  }
 
- if(CheckFlag)  CheckTetra(t,v,n);
-
  return t;
 }
@@ -0,0 +1,158 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      wall.c                                                     *
+*                                                                          *
+* PURPOSE:      Building the tetrahedra of a wall in parallel.             *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               FastMakeTetra                                              *
+*                                                                          *
+* EXPORTS:      InitWallJob     Prepare the parallel build of a wall       *
+*               WallBatch       Build the tetrahedra of a batch of faces   *
+*               EraseWallJob    Free the job and sum its counters          *
+*                                                                          *
+*   NOTES:      The faces of La are taken in batches of WALL_BATCH, in     *
+*               FIFO order, and the tetrahedron of each face is searched   *
+*               in parallel: FastMakeTetra only reads the UG and the       *
+*               points, if each thread has its own cell marks. DeWall      *
+*               then commits the tetrahedra one at a time, in the order of *
+*               the faces, as the sequential loop would do. The faces of   *
+*               the batch still waiting for the commit are kept in the     *
+*               List Pending: when a committed tetrahedron has one of them *
+*               the face is closed, exactly as if it were found in La, and *
+*               its speculative tetrahedron, a copy of the committed one,  *
+*               is thrown away. So the tetrahedra are the same, in the     *
+*               same order, of the sequential DeWall.                      *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+
+#include "graphics.h"
+#include "dewall.h"
+
+
+/* Global for Statistic Infomations */
+
+extern PARALLEL_LOCAL StatInfo SI;
+
+
+/***************************************************************************
+*									   *
+* InitWallJob								   *
+*									   *
+* Prepare W for building in parallel the wall of the n points of v, with   *
+* the UG G of those points. The cell marks of each thread are allocated    *
+* by the first batch it works on.					   *
+*									   *
+***************************************************************************/
+
+void InitWallJob(Point3 *v[], Point3 *BaseV, pindex n, UG *G, WallJob *W)
+{
+ int i;
+
+ W->v=v;
+ W->BaseV=BaseV;
+ W->n=n;
+ W->G=G;
+ W->nf=0;
+ for(i=0;i<MAX_THREADS;i++)
+   {
+    W->Marked[i]=NULL;
+    W->Mark[i]=0;
+   }
+ memset(W->S,0,sizeof(W->S));
+}
+
+
+/*
+ * WallBody
+ *
+ * Cerca in parallelo i tetraedri delle facce del batch. Ogni thread usa
+ * una copia della UG con i propri marcatori di cella; i contatori di SI
+ * sono accumulati in S e SI torna come prima.
+ */
+
+static void WallBody(long from, long to, int thread, void *arg)
+{
+ WallJob *W=(WallJob *)arg;
+ StatInfo Base;
+ UG G;
+ long i;
+
+ if(!W->Marked[thread])
+   {
+    W->Marked[thread]=(int *)calloc((size_t)W->G->n,sizeof(int));
+    if(!W->Marked[thread]) Error("WallBatch, Not enough memory for the cell marks!!\n",EXIT);
+   }
+
+ G=*(W->G);
+ G.Marked=W->Marked[thread];
+ G.Mark=W->Mark[thread];
+ Base=SI;
+
+ for(i=from;i<to;i++)
+   W->T[i]=FastMakeTetra(W->F[i],W->v,W->BaseV,W->n,&G);
+
+ W->Mark[thread]=G.Mark;
+ AddStat(&SI,&Base,&(W->S[thread]));
+ SI=Base;
+}
+
+
+/***************************************************************************
+*									   *
+* WallBatch								   *
+*									   *
+* Extract from La up to WALL_BATCH faces, put them also in Pending, and    *
+* build in parallel the tetrahedron of each of them in W->T (NULL for a    *
+* convex hull face). It returns the number of faces, 0 if La is empty.	   *
+*									   *
+***************************************************************************/
+
+long WallBatch(List La, List Pending, WallJob *W)
+{
+ W->nf=0;
+ while(W->nf<WALL_BATCH && ExtractList(&(W->F[W->nf]),La))
+   {
+    InsertList(W->F[W->nf],Pending);
+    W->nf++;
+   }
+
+ ParallelFor(W->nf, 0, WallBody, W);
+ return W->nf;
+}
+
+
+/***************************************************************************
+*									   *
+* EraseWallJob								   *
+*									   *
+* Free the cell marks of the threads and add their counters to SI.	   *
+*									   *
+***************************************************************************/
+
+void EraseWallJob(WallJob *W)
+{
+ StatInfo Zero;
+ int i;
+
+ memset(&Zero,0,sizeof(StatInfo));
+ for(i=0;i<MAX_THREADS;i++)
+   {
+    AddStat(&(W->S[i]),&Zero,&SI);
+    free(W->Marked[i]);
+   }
+}
@@ -0,0 +1,154 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      check.c                                                    *
+*                                                                          *
+* PURPOSE:      Verification that the built simplices are Delaunay ones.   *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               UG built on all the points of the dataset                  *
+*                                                                          *
+* EXPORTS:      CheckSimplexUG      Check one simplex using the UG         *
+*               CheckTriangulation  Check all the built simplices          *
+*                                                                          *
+*   NOTES:      The same check of the 3d triangulators: only the UG cells  *
+*               that overlap the circumsphere are scanned, in parallel     *
+*               over the list of built simplices.                          *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/delaunay.h>
+
+#include "ed.h"
+
+#define MAX_REPORTED 10		/* Bad simplices described on stderr */
+
+
+/***************************************************************************
+*									   *
+* CheckSimplexUG							   *
+*									   *
+* Test that simplex s is positively oriented and that no point of the UG G *
+* lies inside its circumsphere. Only the cells of the box containing the   *
+* sphere are scanned, and among them only those that intersect the sphere. *
+*									   *
+* It returns -1 if s is Delaunay, the index of a point inside its sphere   *
+* otherwise (or the index of its first vertex if s is flat or negatively   *
+* oriented). It does not use the cell marks of the UG, so it can be called *
+* at the same time by many threads.					   *
+*									   *
+***************************************************************************/
+
+pindex CheckSimplexUG(ShortSimplex *s, Point *BaseV, UG *G)
+{
+ Point *p[DIM+1];
+ double Center[DIM], Radius, MinDist, dist;
+ int lo[DIM], hi[DIM], i[DIM], d, j;
+ pindex q;
+ Plist *P;
+
+ for(j=0;j<=DIM;j++) p[j]=BaseV+s->v[j];
+ if(Orient(p)<=0 || !CircumCenter(p,DIM,Center,&Radius)) return s->v[0];
+
+ Radius=sqrt(Radius);
+ if(Radius<=EPSILON) return -1;
+ MinDist = (Radius-EPSILON)*(Radius-EPSILON);
+
+ GridBox(Center,Radius,G->vn,G->side,G->c,DIM,lo,hi);
+ for(d=0;d<DIM;d++) i[d]=lo[d];
+
+ do
+   if(CellDistance(Center,i,G->vn,G->side,DIM)<MinDist)
+     for(P=G->C[GridIndex(i,G->c,DIM)]; P; P=P->next)
+       {
+	for(dist=0,d=0;d<DIM;d++) dist+=SQR(P->p->x[d]-Center[d]);
+	if(dist<MinDist)
+	  {
+	   q=(pindex)(P->p-BaseV);
+	   for(j=0;j<=DIM && q!=s->v[j];j++);
+	   if(j>DIM) return q;
+	  }
+       }
+ while(NextCell(i,lo,hi,DIM));
+
+ return -1;
+}
+
+
+/***************************************************************************
+*									   *
+* CheckTriangulation							   *
+*									   *
+* Check in parallel all the simplices of the store T. Each violation is	   *
+* counted and the first ones are reported on stderr. It returns the number *
+* of simplices that are not Delaunay.					   *
+*									   *
+***************************************************************************/
+
+typedef struct CheckJobstruct
+{
+ Store T;			/* The simplices to check		  */
+ Point *BaseV;
+ UG *G;
+ long Bad[MAX_THREADS]; 	/* Bad simplices found by each thread	  */
+ int Reported;
+} CheckJob;
+
+static void CheckBody(long from, long to, int thread, void *arg)
+{
+ CheckJob *J=(CheckJob *)arg;
+ ShortSimplex *s;
+ long i;
+ pindex p;
+ int d;
+
+ for(i=from;i<to;i++)
+   {
+    s=(ShortSimplex *)StoreElem(i,J->T);
+    p=CheckSimplexUG(s,J->BaseV,J->G);
+    if(p<0) continue;
+
+    J->Bad[thread]++;
+    LockParallel();
+    if(J->Reported++ < MAX_REPORTED)
+      {
+       if(p==s->v[0])
+	 Errorf(NO_EXIT,"CheckTriangulation, flat or reversed simplex");
+       else
+	 Errorf(NO_EXIT,"CheckTriangulation, point %" IDX " inside the sphere of",p);
+       for(d=0;d<=DIM;d++) fprintf(stderr," %" IDX,s->v[d]);
+       fprintf(stderr,"\n");
+      }
+    UnlockParallel();
+   }
+}
+
+long CheckTriangulation(Store T, Point *BaseV, UG *G)
+{
+ CheckJob J;
+ long i, Bad=0;
+
+ J.T=T;
+ J.BaseV=BaseV;
+ J.G=G;
+ J.Reported=0;
+ for(i=0;i<MAX_THREADS;i++) J.Bad[i]=0;
+
+ ParallelFor(CountStore(T), 0, CheckBody, &J);
+
+ for(i=0;i<MAX_THREADS;i++) Bad+=J.Bad[i];
+
+ return Bad;
+}
@@ -0,0 +1,452 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      dewall.c                                                   *
+*                                                                          *
+* PURPOSE:      DeWall and InCoDe in E^d.                                  *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*                                                                          *
+* EXPORTS:      FirstSimplex        Build the first Delaunay simplex       *
+*               UpdateAFL           Update the active face lists           *
+*               DeWall              The MergeFirst Divide and Conquer      *
+*               InCoDe              The incremental construction           *
+*                                                                          *
+*   NOTES:      The two algorithms differ only in the way they use the     *
+*               active face lists: InCoDe keeps only one list, DeWall      *
+*               splits the faces with a wall in three lists and builds     *
+*               only the simplices crossing the wall before recurring on   *
+*               the two halves. So InCoDe is DeWall with a wall that every *
+*               face intersects.                                           *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/delaunay.h>
+
+#include "ed.h"
+
+
+/* Global for Statistic Infomations */
+
+extern StatInfo SI;
+
+/* Global Program Flag */
+
+extern boolean UpdateFlag;
+extern boolean SafeSimplexFlag;
+extern float   UGScale;
+
+
+/***************************************************************************
+*									   *
+* SquaredDistance							   *
+* Nearest								   *
+*									   *
+* The squared distance of two points, and the point of v[from..to-1]	   *
+* nearest to p.								   *
+*									   *
+***************************************************************************/
+
+static double SquaredDistance(Point *p, Point *q)
+{
+ double s=0, t;
+ int d;
+
+ for(d=0;d<DIM;d++)
+   {
+    t=p->x[d]-q->x[d];
+    s+=t*t;
+   }
+ return s;
+}
+
+static Point *Nearest(Point *p, Point **v, pindex from, pindex to)
+{
+ double r, MinRadius=BIGNUMBER*BIGNUMBER;
+ Point *q=NULL;
+ pindex i;
+
+ for(i=from;i<to;i++)
+   if(v[i]!=p && (r=SquaredDistance(p,v[i]))<MinRadius)
+     {
+      MinRadius=r;
+      q=v[i];
+     }
+ return q;
+}
+
+
+/***************************************************************************
+*									   *
+* FirstSimplex								   *
+*									   *
+* Build the first Delaunay simplex of the triangulation. The first m	   *
+* points of v are on the negative side of the wall, the others on the	   *
+* positive one (m=0 means no wall).					   *
+*									   *
+* As in DeWall the first face is built one vertex at a time. The first	   *
+* two vertices are a pair of points on opposite sides of the wall, each    *
+* one the nearest to the other among the points of the other side: no	   *
+* point can be inside the sphere having them as diameter, so they are a    *
+* Delaunay edge crossing the wall (the nearest point to the nearest point  *
+* of DeWall has not this property, so we iterate until the pair is	   *
+* stable). Then each new vertex is the one that with the previous ones	   *
+* builds the smallest circumsphere: it is empty too, because all the	   *
+* spheres through the previous vertices that are smaller than it contain   *
+* no point. At last the simplex is completed with the point whose sphere   *
+* is the smallest, on whatever side of the face it is.			   *
+*									   *
+***************************************************************************/
+
+Simplex *FirstSimplex(Point **v, pindex n, pindex m)
+{
+ Point *p[DIM+1], *a, *b;
+ Face f;
+ Plane pl;
+ double c[DIM], r2, s, t, MinRadius;
+ int i,j,k,d;
+
+ if(m>0 && m<n)
+   {
+    a=v[m-1];			/* The nearest to wall on negative side */
+    b=Nearest(a,v,m,n);
+    r2=SquaredDistance(a,b);
+    for(;;)
+      {
+       p[0]=Nearest(b,v,0,m);
+       if(SquaredDistance(p[0],b)>=r2) break;
+       a=p[0];
+       r2=SquaredDistance(a,b);
+
+       p[1]=Nearest(a,v,m,n);
+       if(SquaredDistance(a,p[1])>=r2) break;
+       b=p[1];
+       r2=SquaredDistance(a,b);
+      }
+   }
+ else
+   {
+    a=v[0];
+    b=Nearest(a,v,0,n);
+   }
+
+ p[0]=a;
+ p[1]=b;
+
+ for(k=2;k<DIM;k++)		/* The k-th point is that with previous */
+   {				/* ones builds the smallest sphere.	*/
+    MinRadius=BIGNUMBER*BIGNUMBER;
+    a=NULL;
+    for(i=0;i<n;i++)
+      {
+       for(j=0;j<k && v[i]!=p[j];j++);
+       if(j<k) continue;
+       p[k]=v[i];
+       if(CircumCenter(p,k,c,&r2) && r2<MinRadius)
+	 {
+	  MinRadius=r2;
+	  a=v[i];
+	 }
+      }
+    if(!a) Errorf(EXIT,"FirstSimplex, All the points are on a %i-flat.\n",k-1);
+    p[k]=a;
+   }
+
+ for(d=0;d<DIM;d++) f.v[d]=p[d];
+ if(!CalcPlane(&f,&pl)) Error("FirstSimplex, Degenerate first face.\n",EXIT);
+
+ MinRadius=BIGNUMBER*BIGNUMBER;	/* The last one is analogous to normal	*/
+ a=NULL;			/* MakeSimplex, only we dont limit the	*/
+ b=NULL;			/* search to an halfspace.		*/
+ for(i=0;i<n;i++)
+   {
+    for(j=0;j<DIM && v[i]!=p[j];j++);
+    if(j<DIM) continue;
+
+    s=0;
+    for(d=0;d<DIM;d++) s+=pl.N[d]*v[i]->x[d];
+    s-=pl.off;
+    if(fabs(s)<=EPSILON) continue;
+
+    for(t=0,d=0;d<DIM;d++) t+=(v[i]->x[d]-pl.Lu[d])*(v[i]->x[d]-pl.Lu[d]);
+    t=(t-pl.R2)/(2*s);
+    if(t*t==MinRadius) Errorf(EXIT,"FirstSimplex, Found %i cospherical points!\n",DIM+2);
+    if(t*t<MinRadius)
+      {
+       MinRadius=t*t;
+       a=v[i];
+       b= s>0 ? a : NULL;
+      }
+   }
+
+ if(!a) Errorf(EXIT,"FirstSimplex, Flat dataset, unable to build first simplex.\n");
+ if(!b) ReverseFace(&f);
+
+ return BuildSimplex(&f,a);
+}
+
+
+/***************************************************************************
+*									   *
+* MarkFace								   *
+*									   *
+* Add inc to the count of active faces of the vertices of f. 		   *
+*									   *
+***************************************************************************/
+
+static void MarkFace(Face *f, int inc)
+{
+ int i;
+
+ for(i=0;i<DIM;i++)
+   if(f->v[i]->mark==-1) f->v[i]->mark=inc;
+		    else f->v[i]->mark+=inc;
+}
+
+
+/***************************************************************************
+*									   *
+* UpdateAFL								   *
+*									   *
+* Put the faces from..DIM of the new simplex s in the active face lists.   *
+* L[0], L[1] and L[2] are the lists of the faces on negative side of the   *
+* wall, intersecting it and on its positive side; without a wall all the   *
+* faces go in L[1]. A face already in its list is shared by two simplices: *
+* ToggleFace deletes it from the list.					   *
+*									   *
+***************************************************************************/
+
+void UpdateAFL(Simplex *s, int from, List *L, Wall *w)
+{
+ List l;
+ Face *old;
+ int i;
+
+ for(i=from;i<=DIM;i++)
+   {
+    l= w ? L[Intersect(s->f[i],w)+1] : L[1];
+    if((old=(Face *)ToggleFace(s->f[i],l)))
+      {
+       SI.Face--;
+       MarkFace(old,-1);
+       free(old);
+       free(s->f[i]);
+      }
+    else
+      {
+       SI.Face++;
+       MarkFace(s->f[i],1);
+      }
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* BuildWall								   *
+*									   *
+* Build all the simplices on the faces of the list L[1], until it is	   *
+* empty. It is the main loop of both DeWall and InCoDe. 		   *
+*									   *
+***************************************************************************/
+
+static void BuildWall(List *L, Wall *w, Point **v, Point *BaseV, pindex n,
+		      UG *g, Store T)
+{
+ Face *f;
+ Simplex *s;
+ ShortSimplex ss;
+
+ while(ExtractList(&f,L[1]))
+ {
+  if(g) s=FastMakeSimplex(f,g);
+   else s=MakeSimplex(f,v,n);
+  if(s==NULL) SI.CHFace++;
+  else
+     {
+      Simplex2ShortSimplex(s,BaseV,&ss);
+
+      if(SafeSimplexFlag) if(MemberStore(&ss, T))
+			Error("Cyclic Simplex Creation\n",EXIT);
+      AppendStore(&ss,T);
+      SI.Simplex++;
+
+      if(UpdateFlag)
+	 if(SI.Simplex%50 == 0) printf("Simplices Built %ld\r",SI.Simplex);
+
+      UpdateAFL(s,1,L,w);
+      free(s->f[0]);
+      free(s);
+     }
+  MarkFace(f,-1);
+  free(f);
+ }
+}
+
+
+/***************************************************************************
+*									   *
+* ChooseWall								   *
+*									   *
+* Sort v along the axis and put the wall between the two halves. If the    *
+* median coordinate is shared by more points the wall is moved by	   *
+* SplitWall to the nearest position between two different coordinates, so *
+* that the points of the two halves are always on the two sides of the	   *
+* wall; if all the points have the same coordinate the next axis is tried. *
+* Returns the index of the first point on the positive side.		   *
+*									   *
+***************************************************************************/
+
+static int SortAxis;
+
+static double Coord(pointer p, int axis)
+{
+ return ((Point *)p)->x[axis];
+}
+
+static int AxisComp(const void *E1, const void *E2)
+{
+ Point *e1=*(Point **)E1,
+       *e2=*(Point **)E2;
+
+ if(e1->x[SortAxis] > e2->x[SortAxis])	   return  1;
+ else if(e1->x[SortAxis] < e2->x[SortAxis]) return -1;
+ else if(e1 > e2)	return	1;
+ else if(e1 < e2)	return -1;
+ else return 0;
+}
+
+static pindex ChooseWall(Point **v, pindex n, int axis, Wall *w)
+{
+ pindex m;
+ int k;
+
+ for(k=0;k<DIM;k++,axis=(axis+1)%DIM)
+   {
+    SortAxis=axis;
+    qsort((void *)v, (size_t)n, sizeof(Point *), AxisComp);
+
+    m=SplitWall((pointer *)v,n,n/2,axis,Coord,&(w->off));
+    if(m>0)
+      {
+       w->axis=axis;
+       return m;
+      }
+   }
+
+ Error("ChooseWall, Duplicated points in dataset.\n",EXIT);
+ return 0;
+}
+
+
+/***************************************************************************
+*									   *
+* DeWall								   *
+*									   *
+* Given a vector v of n Points this function adds to T the simplices of    *
+* the Delaunay triangulation of points, using the MergeFirst Divide and    *
+* Conquer algorithm DeWall [Cignoni 92], exactly as the DeWall of the 3d   *
+* triangulator. Q contains the active faces of the points of v; if it is   *
+* empty the first simplex is built.					   *
+*									   *
+* [Cignoni 92]								   *
+* P. Cignoni, C. Montani, R. Scopigno		  d			   *
+*"A Merge-First Divide and Conquer Algorithm for E  Delaunay Triangulation"*
+* CNUCE Internal Report C92/16 Oct 1992					   *
+*									   *
+***************************************************************************/
+
+void DeWall(Point **v, Point *BaseV, pindex n, List Q, Store T, int axis)
+{
+ List L[3];
+ Simplex *s;
+ ShortSimplex ss;
+ Face *f;
+ Wall w;
+ UG g;
+ pindex m;
+ int i;
+
+ m=ChooseWall(v,n,axis,&w);
+
+ if(n>20) BuildUG(v,n,(int)(n*UGScale),&g);	/* Initialize Uniform Grid */
+
+ for(i=0;i<3;i++)			/* Initialize Active Face */
+   {					/* Lists Ln, La, Lp.	  */
+    L[i]=NewList(FIFO,sizeof(Face));
+    ChangeEqualObjectList(EqualFace,L[i]);
+    if(n>40) HashList(HASH_SIZE(n),HashFace,L[i]);
+   }
+
+ if(CountList(Q)==0)
+ {
+  s=FirstSimplex(v,n,m);
+  Simplex2ShortSimplex(s,BaseV,&ss);
+  AppendStore(&ss,T);
+  SI.Simplex++;
+  ReverseFace(s->f[0]);		/* First Face in first Simplex	*/
+  UpdateAFL(s,0,L,&w);		/* must be outward oriented	*/
+  free(s);
+ }
+ else
+  while(ExtractList(&f,Q)) InsertList(f,L[Intersect(f,&w)+1]);
+
+ BuildWall(L,&w,v,BaseV,n, n>20 ? &g : NULL, T);
+
+ if(SI.WallSize==0) SI.WallSize=SI.Simplex;
+ if(n>20) EraseUG(&g);
+
+ if(CountList(L[0])>0) DeWall(v,      BaseV,m,  L[0],T,(w.axis+1)%DIM);
+ if(CountList(L[2])>0) DeWall(&(v[m]),BaseV,n-m,L[2],T,(w.axis+1)%DIM);
+
+ for(i=0;i<3;i++) EraseList(L[i]);
+}
+
+
+/***************************************************************************
+*									   *
+* InCoDe								   *
+*									   *
+* Given a vector v of n Points this function adds to T the simplices of    *
+* the Delaunay triangulation of points, with the incremental construction  *
+* of InCoDe: all the active faces are kept in one list.			   *
+*									   *
+***************************************************************************/
+
+void InCoDe(Point **v, Point *BaseV, pindex n, Store T)
+{
+ List L[3];
+ Simplex *s;
+ ShortSimplex ss;
+ UG g;
+
+ BuildUG(v,n,(int)(n*UGScale),&g);
+
+ L[1]=NewList(FIFO,sizeof(Face));
+ ChangeEqualObjectList(EqualFace,L[1]);
+ if(n>40) HashList(HASH_SIZE(n),HashFace,L[1]);
+ L[0]=L[2]=L[1];
+
+ s=FirstSimplex(v,n,0);
+ AppendStore(Simplex2ShortSimplex(s,BaseV,&ss),T);
+ SI.Simplex++;
+ ReverseFace(s->f[0]);
+ UpdateAFL(s,0,L,NULL);
+ free(s);
+
+ BuildWall(L,NULL,v,BaseV,n,&g,T);
+
+ EraseUG(&g);
+ EraseList(L[1]);
+}
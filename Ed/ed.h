@@ -0,0 +1,228 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	ed.h							   *
+*                                                                          *
+* PURPOSE:      Type definitions and prototyping of the E^d triangulators. *
+*                                                                          *
+* IMPORTS:      OList definitions                                          *
+*                                                                          *
+* EXPORTS:      Point           Definition                                 *
+*               Face            Definition                                 *
+*               Simplex         Definition                                 *
+*               ShortSimplex    Definition                                 *
+*               Plane           Definition                                 *
+*               Wall            Definition                                 *
+*               Plist           Definition                                 *
+*		UG		Definition				   *
+*		StatInfo	Definition				   *
+*                                                                          *
+*   NOTES:	All the code in this directory is written for a generic    *
+*		dimension DIM, that must be defined at compile time	   *
+*		(e.g. -DDIM=2). The Makefile compiles the same sources	   *
+*		once for each dimension, so dewall2, incode2, ... are	   *
+*		built from the same code.				   *
+*		A simplex has DIM+1 vertices and DIM+1 faces, a face has   *
+*		DIM vertices. In 3d the types are the Tetra and the Face   *
+*		of DeWall.						   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#ifndef DIM
+#define DIM 2
+#endif
+
+#if DIM<2
+#error "DIM must be at least 2"
+#endif
+
+#define BIGNUMBER 1000000000.0
+#define EPSILON 0.0000001
+
+/* The average number of simplices for each point of a uniform dataset    */
+/* (2 in 2d, 6.8 in 3d, 31.8 in 4d) sizes the hash tables of the lists,   */
+/* that the 3d programs size n/4. The UG of the subproblems has	  */
+/* UG_SCALE cells for each point: in 4d the spheres are some cells wide  */
+/* and the boxes around them have too many cells with the 3d default.	  */
+
+#if DIM==2
+#define SIMPLEX_PER_POINT 2
+#define UG_SCALE 1.0
+#elif DIM==3
+#define SIMPLEX_PER_POINT 7
+#define UG_SCALE 1.0
+#else
+#define SIMPLEX_PER_POINT (32<<(3*(DIM-4)))
+#define UG_SCALE 0.15
+#endif
+
+#define HASH_SIZE(n) ((int)MIN((long)(n)*SIMPLEX_PER_POINT/8+1,0x7fffffffL))
+
+
+typedef struct Pointstruct	/* A Point of E^d. Mark is the number of  */
+{				/* active faces using the point, or -1 if */
+ double x[DIM];			/* the point is not yet used. Points with */
+ int mark;			/* mark 0 have a complete star and are	  */
+} Point;			/* skipped by the dd-nearest search.	  */
+
+
+typedef struct Facestruct	/* A Face is an array of DIM Point	  */
+{				/* pointers. Faces are oriented: the new  */
+ Point *v[DIM];			/* vertex must be on the positive side	  */
+} Face;				/* (see RightSide in geometry.c).	  */
+
+
+typedef struct Simplexstruct	/* A Simplex is an array of DIM+1 Faces.  */
+{				/* f[0] is the face the simplex is built  */
+ Face *f[DIM+1];		/* on, the others are outward oriented.   */
+} Simplex;
+
+typedef struct ShortSimplexstruct
+{				/* A ShortSimplex contains only the index */
+ pindex v[DIM+1];			/* of its vertices. They are positively   */
+} ShortSimplex; 		/* oriented.				  */
+
+
+typedef struct Planestruct	/* The hyperplane of a face: the unit	  */
+{				/* normal N and its offset from origin.   */
+ double N[DIM]; 		/* Lu is the center of the smallest	  */
+ double off;			/* sphere through the face and R2 its	  */
+ double Lu[DIM];		/* squared radius: the centers of all the */
+ double R2;			/* spheres through the face are on the	  */
+} Plane;			/* line Lu + t N.			  */
+
+
+typedef struct Wallstruct	/* The wall of DeWall: a point p is on the*/
+{				/* positive side if p->x[axis] >= off.	  */
+ int axis;
+ double off;
+} Wall;
+
+
+struct plist {			/* This is a List of Point, as in DeWall. */
+	Point *p;
+	struct plist *next;
+	};
+typedef struct plist Plist;
+
+
+/****************************************************************************
+*									    *
+* UG (Uniform Grid)							    *
+*									    *
+* The Uniform Grid of DeWall in E^d: the cells are hypercubes, c[k] cells   *
+* for each axis. The cell of coords (i0,i1,...) has the position	    *
+* i0 + i1*c[0] + i2*c[0]*c[1] + ...					    *
+*									    *
+****************************************************************************/
+
+typedef struct UGstruct {
+	int c[DIM];	/* Cell number for each axis */
+	int n;		/* Total cell number */
+
+	double vp[DIM]; /* Maximum vertex of UG */
+	double vn[DIM]; /* Minimum vertex of UG */
+
+	double side;	/* Cell Edge */
+
+	Plist **C;	/* Vector of Plist pointers, one for each cell */
+	int *Marked;
+	int Mark;
+	} UG;
+
+
+typedef struct StatInfostruct
+{
+			/* General Stats	*/
+  pindex Point;
+  double Secs;
+  long	 Face;
+  long	 CHFace;
+  long	 Simplex;
+			/* UG Stats		*/
+  int	 Cell;
+  int	 EmptyCell;
+  int	 MaxPointPerCell;
+  double CellEdge;
+			/* dd-nearest Stats	*/
+  long	 MakeSimplex;
+  long	 TestedPoint;
+  long	 TestedCell;
+  long	 EmptyBox;
+  long	 SecondBox;
+
+  long WallSize;
+} StatInfo;
+
+/**************************************************************************
+*									  *
+*				PROTOTYPES				  *
+*									  *
+**************************************************************************/
+
+/**************************************************************************
+*   file.c                                                                *
+**************************************************************************/
+
+Point *ReadPoints(char *filename, pindex *n);
+ShortSimplex *Simplex2ShortSimplex(Simplex *s, Point *BaseV, ShortSimplex *ss);
+void WriteSimplexStore(Store T, FILE *fp);
+
+int HashFace(void *F);
+int HashSimplex(void *S);
+boolean EqualFace(void *F1, void *F2);
+boolean EqualSimplex(void *S1, void *S2);
+
+
+/**************************************************************************
+*   geometry.c                                                            *
+**************************************************************************/
+
+double Det(double m[DIM][DIM], int n);
+boolean CircumCenter(Point **p, int k, double *c, double *r2);
+boolean CalcPlane(Face *f, Plane *p);
+boolean RightSide(Plane *p, Point *v);
+double CenterOffset(Plane *p, Point *v);
+double Orient(Point **p);
+int Intersect(Face *f, Wall *w);
+void ReverseFace(Face *f);
+
+
+/**************************************************************************
+*   unifgrid.c                                                            *
+**************************************************************************/
+
+UG *BuildUG(Point **v, pindex n, int m, UG *G);
+void EraseUG(UG *G);
+Simplex *BuildSimplex(Face *f, Point *p);
+Simplex *MakeSimplex(Face *f, Point **v, pindex n);
+Simplex *FastMakeSimplex(Face *f, UG *G);
+
+
+/**************************************************************************
+*   dewall.c								  *
+**************************************************************************/
+
+Simplex *FirstSimplex(Point **v, pindex n, pindex m);
+void UpdateAFL(Simplex *s, int from, List *L, Wall *w);
+void DeWall(Point **v, Point *BaseV, pindex n, List Q, Store T, int axis);
+void InCoDe(Point **v, Point *BaseV, pindex n, Store T);
+
+
+/**************************************************************************
+*   check.c								  *
+**************************************************************************/
+
+pindex CheckSimplexUG(ShortSimplex *s, Point *BaseV, UG *G);
+long CheckTriangulation(Store T, Point *BaseV, UG *G);
+
+
+/**************************************************************************
+*   stat.c								  *
+**************************************************************************/
+
+void InitStat();
+void PrintStat();
@@ -0,0 +1,224 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      file.c                                                     *
+*                                                                          *
+* PURPOSE:      Functions for I/O and support to list management.          *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*                                                                          *
+* EXPORTS:      ReadPoints            Read a Point file                    *
+*               Simplex2ShortSimplex  Trasform a Simplex in a ShortSimplex *
+*               WriteSimplexStore     Write a simplex store on a file      *
+*               HashFace              Hash key function for Faces          *
+*               EqualFace             Testing equalness of Faces           *
+*               HashSimplex           Hash key function for Simplices      *
+*               EqualSimplex          Testing equalness of Simplices       *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/numfile.h>
+
+#include "ed.h"
+
+/* Global for Statistic Infomations */
+
+extern StatInfo SI;
+
+
+/*
+ * ReadPoints
+ *
+ * Legge un file di punti e restituisce un vettore di punti e il numero n
+ * di punti letti. Il formato e' quello di DeWall con DIM coordinate per
+ * punto, lo stesso scritto da 'bubbles -d DIM':
+ *      N
+ *      X0 X1 ... X(DIM-1)
+ *      ...
+ * Le coordinate sono lette in parallelo da ReadReals (vedi numfile.c).
+ */
+
+Point *ReadPoints(char *filename, pindex *n)
+{
+ NumFile F;
+ long m;
+ pindex i;
+ Point *vec;
+
+ if(!OpenNumFile(filename,&F)) Error("ReadPoints, Unable to open input file.\n",EXIT);
+
+ if(!ReadLong(&F,&m) || m<DIM+1)
+   Errorf(EXIT,"ReadPoints, %s must contain at least %i points.\n",filename,DIM+1);
+ *n=(pindex)m;
+
+ vec=(Point *)calloc((size_t)*n,sizeof(Point));
+ if(!vec) Error("ReadPoints, Not enough memory to load point dataset.\n",EXIT);
+
+ if((m=ReadReals(&F,(long)*n,DIM,vec[0].x,sizeof(Point)))<*n)
+   Errorf(EXIT,"ReadPoints, %s truncated at point %ld.\n",filename,m);
+ CloseNumFile(&F);
+
+ for(i=0;i<*n;i++) vec[i].mark=-1;
+ return vec;
+}
+
+
+/*
+ * Simplex2ShortSimplex
+ *
+ * Dato un simplesso riempie lo ShortSimplex ss con gli indici dei suoi
+ * vertici: i vertici della faccia su cui e' costruito e il nuovo vertice,
+ * che e' il primo vertice della faccia 1. Restituisce ss.
+ */
+
+ShortSimplex *Simplex2ShortSimplex(Simplex *s, Point *BaseV, ShortSimplex *ss)
+{
+ int i;
+
+ for(i=0;i<DIM;i++) ss->v[i]=(pindex)(s->f[0]->v[i]-BaseV);
+ ss->v[DIM]=(pindex)(s->f[1]->v[0]-BaseV);
+
+ return ss;
+}
+
+
+/*
+ * WriteSimplexStore
+ *
+ * Scrive nel file fp i simplessi di T nell'ordine in cui sono stati
+ * costruiti, ogni simplesso e' scritto come DIM+1 vertici. All'inizio
+ * del file viene scritto il numero di simplessi.
+ */
+
+void WriteSimplexStore(Store T, FILE *fp)
+{
+ ShortSimplex *s;
+ long j;
+ int i;
+
+ fprintf(fp,"%ld\n",CountStore(T));
+ for(j=0;j<CountStore(T);j++)
+   {
+    s=(ShortSimplex *)StoreElem(j,T);
+    for(i=0;i<=DIM;i++) fprintf(fp,"%6" IDX " ",s->v[i]);
+    fprintf(fp,"\n");
+   }
+}
+
+
+/*
+ * HashFace
+ *
+ * Data una faccia restituisce la sua chiave hash, che non dipende
+ * dall'ordine dei vertici.
+ *
+ * tecnica usata: somma e XOR degli indirizzi dei vertici divisi per la
+ * dimensione di un Point (gli indirizzi sono allineati e lo XOR da solo
+ * lascerebbe vuoti molti bucket).
+ */
+
+int HashFace(void *F)
+{
+ Face *f=(Face *)F;
+ unsigned long s=0, x=0, a;
+ int i;
+
+ for(i=0;i<DIM;i++)
+   {
+    a=(unsigned long)f->v[i]/sizeof(Point);
+    s+=a;
+    x^=a*2654435761UL;
+   }
+ return (int)((s*31+x) & 0x7fffffff);
+}
+
+
+/*
+ * EqualFace
+ *
+ * Equal testing function for faces list operations
+ * two faces are equals if they have the same vertices
+ * (even in different order).
+ */
+
+boolean EqualFace(void *F1, void *F2)
+{
+ Face *f1=(Face *)F1;
+ Face *f2=(Face *)F2;
+ int i,j;
+
+ for(i=0;i<DIM;i++)
+   {
+    for(j=0;j<DIM;j++)
+      if(f1->v[i]==f2->v[j]) break;
+    if(j==DIM) return FALSE;
+   }
+ return TRUE;
+}
+
+
+/*
+ * HashSimplex
+ *
+ * Hash Function for the simplices store.
+ * It must return the same key for equal simplices (even if vertices are
+ * differentely ordered): the key is computed on the canonical form of the
+ * simplex, its DIM+1 vertices sorted.
+ */
+
+int HashSimplex(void *S)
+{
+ ShortSimplex *s=(ShortSimplex *)S;
+ unsigned long h;
+ pindex a[DIM+1], x;
+ int i, j;
+
+ for(i=0;i<=DIM;i++)			/* Insertion sort dei vertici */
+   {
+    x=s->v[i];
+    for(j=i;j>0 && a[j-1]>x;j--) a[j]=a[j-1];
+    a[j]=x;
+   }
+
+ h=(unsigned long)a[0];
+ for(i=1;i<=DIM;i++) h=h*2654435761UL+(unsigned long)a[i];
+ h^=h>>16;
+ h*=0x45d9f3bUL;
+ h^=h>>16;
+ return (int)(h & 0x7fffffff);
+}
+
+
+/*
+ * EqualSimplex
+ *
+ * Equal testing function for simplices list operations
+ * two simplices are equals if they have the same vertices
+ * (even in different order).
+ */
+
+boolean EqualSimplex(void *S1, void *S2)
+{
+ ShortSimplex *s1=(ShortSimplex *)S1;
+ ShortSimplex *s2=(ShortSimplex *)S2;
+ int i,j;
+
+ for(i=0;i<=DIM;i++)
+   {
+    for(j=0;j<=DIM;j++)
+      if(s1->v[i]==s2->v[j]) break;
+    if(j>DIM) return FALSE;
+   }
+ return TRUE;
+}
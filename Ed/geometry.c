@@ -0,0 +1,318 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      geometry.c                                                 *
+*                                                                          *
+* PURPOSE:      Geometric functions in E^d.                                *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*                                                                          *
+* EXPORTS:      Det                 Determinant of a n x n matrix          *
+*               CircumCenter        Smallest sphere through k+1 points     *
+*               CalcPlane           Hyperplane and line of centers of a    *
+*                                   face                                   *
+*               RightSide           A point is on RightSide of a plane     *
+*               CenterOffset        Where the sphere through a face and a  *
+*                                   point is centered on line of centers   *
+*               Orient              Orientation of a simplex               *
+*               Intersect           Position of a face respect a wall      *
+*		ReverseFace	    Given a face reverse it		   *
+*                                                                          *
+*   NOTES:      In 3d DeWall intersects the middle planes with the line of *
+*               centers. In E^d the same line is Lu + t N, and the center  *
+*               of the sphere through the face and a point p is at	   *
+*									   *
+*			    |p - Lu|^2 - R^2				   *
+*		       t = ------------------				   *
+*			     2 (N.p - off)				   *
+*									   *
+*               The dd distance of p grows with t, so the dd-nearest point *
+*               is the one with the smallest t.                            *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+
+#include "ed.h"
+
+
+/*
+ * Solve
+ *
+ * Risolve il sistema lineare n x n  a x = b con l'eliminazione di Gauss e
+ * pivoting parziale. Restituisce falso se la matrice e' singolare rispetto
+ * a scale. La matrice a e il vettore b vengono modificati.
+ */
+
+static boolean Solve(double a[DIM][DIM], double *b, int n, double *x, double scale)
+{
+ int i,j,k,piv;
+ double t;
+
+ for(k=0;k<n;k++)
+   {
+    piv=k;
+    for(i=k+1;i<n;i++)
+      if(fabs(a[i][k])>fabs(a[piv][k])) piv=i;
+    if(fabs(a[piv][k])<=scale*1e-12) return FALSE;
+    if(piv!=k)
+      {
+       for(j=0;j<n;j++) { t=a[k][j]; a[k][j]=a[piv][j]; a[piv][j]=t; }
+       t=b[k]; b[k]=b[piv]; b[piv]=t;
+      }
+    for(i=k+1;i<n;i++)
+      {
+       t=a[i][k]/a[k][k];
+       for(j=k;j<n;j++) a[i][j]-=t*a[k][j];
+       b[i]-=t*b[k];
+      }
+   }
+
+ for(k=n-1;k>=0;k--)
+   {
+    t=b[k];
+    for(j=k+1;j<n;j++) t-=a[k][j]*x[j];
+    x[k]=t/a[k][k];
+   }
+ return TRUE;
+}
+
+
+/*
+ * Det
+ *
+ * Determinante della sottomatrice n x n di m (n <= DIM), calcolato con
+ * l'eliminazione di Gauss. La matrice m non viene modificata.
+ */
+
+double Det(double m[DIM][DIM], int n)
+{
+ double a[DIM][DIM], t, d=1;
+ int i,j,k,piv;
+
+ for(i=0;i<n;i++)
+   for(j=0;j<n;j++) a[i][j]=m[i][j];
+
+ for(k=0;k<n;k++)
+   {
+    piv=k;
+    for(i=k+1;i<n;i++)
+      if(fabs(a[i][k])>fabs(a[piv][k])) piv=i;
+    if(a[piv][k]==0) return 0;
+    if(piv!=k)
+      {
+       for(j=k;j<n;j++) { t=a[k][j]; a[k][j]=a[piv][j]; a[piv][j]=t; }
+       d= -d;
+      }
+    d*=a[k][k];
+    for(i=k+1;i<n;i++)
+      {
+       t=a[i][k]/a[k][k];
+       for(j=k+1;j<n;j++) a[i][j]-=t*a[k][j];
+      }
+   }
+ return d;
+}
+
+
+/*
+ * CircumCenter
+ *
+ * Dati k+1 punti p[0..k] (k <= DIM) calcola il centro c e il raggio al
+ * quadrato r2 della piu' piccola sfera passante per essi. Il centro e'
+ * c = p0 + Sum l_i (p_i - p0) e i coefficienti l risolvono il sistema
+ *
+ *	Sum l_j (p_i - p0).(p_j - p0) = |p_i - p0|^2 / 2
+ *
+ * Restituisce falso se i punti non sono affinemente indipendenti.
+ */
+
+boolean CircumCenter(Point **p, int k, double *c, double *r2)
+{
+ double a[DIM][DIM], e[DIM][DIM], b[DIM], l[DIM], scale=0;
+ int i,j,d;
+
+ for(i=0;i<k;i++)
+   for(d=0;d<DIM;d++) e[i][d]=p[i+1]->x[d]-p[0]->x[d];
+
+ for(i=0;i<k;i++)
+   for(j=0;j<=i;j++)
+     {
+      a[i][j]=0;
+      for(d=0;d<DIM;d++) a[i][j]+=e[i][d]*e[j][d];
+      a[j][i]=a[i][j];
+     }
+ for(i=0;i<k;i++)
+   {
+    b[i]=a[i][i]/2;
+    scale=MAX(scale,a[i][i]);
+   }
+
+ if(k>0 && !Solve(a,b,k,l,scale)) return FALSE;
+
+ *r2=0;
+ for(d=0;d<DIM;d++)
+   {
+    double off=0;
+    for(i=0;i<k;i++) off+=l[i]*e[i][d];
+    c[d]=p[0]->x[d]+off;
+    *r2+=off*off;
+   }
+ return TRUE;
+}
+
+
+/*
+ * CalcPlane
+ *
+ * Dato una faccia calcola il suo iperpiano e la retta dei centri delle
+ * sfere passanti per i suoi vertici. La normale e' il prodotto vettoriale
+ * generalizzato dei lati v[i]-v[0]: le sue componenti sono i cofattori
+ * dell'ultima riga della matrice dei lati, cosi' che N.(p-v[0]) e' il
+ * determinante [v1-v0, ..., p-v0]. Restituisce falso se la faccia e'
+ * degenere.
+ */
+
+boolean CalcPlane(Face *f, Plane *p)
+{
+ double e[DIM][DIM], m[DIM][DIM], len=0, scale=1;
+ int i,j,k,d;
+
+ for(i=0;i<DIM-1;i++)
+   {
+    double l=0;
+    for(d=0;d<DIM;d++)
+      {
+       e[i][d]=f->v[i+1]->x[d]-f->v[0]->x[d];
+       l+=e[i][d]*e[i][d];
+      }
+    scale*=sqrt(l);
+   }
+
+ for(k=0;k<DIM;k++)
+   {
+    for(i=0;i<DIM-1;i++)
+      for(j=0,d=0;d<DIM;d++)
+	if(d!=k) m[i][j++]=e[i][d];
+    p->N[k]=Det(m,DIM-1);
+    if((DIM-1+k)%2) p->N[k]= -p->N[k];
+    len+=p->N[k]*p->N[k];
+   }
+
+ len=sqrt(len);
+ if(len<=scale*1e-12) return FALSE;
+
+ p->off=0;
+ for(d=0;d<DIM;d++)
+   {
+    p->N[d]/=len;
+    p->off+=p->N[d]*f->v[0]->x[d];
+   }
+
+ return CircumCenter(f->v,DIM-1,p->Lu,&(p->R2));
+}
+
+
+/*
+ * RightSide
+ *
+ * Dato un piano ed un punto restituisce vero se il punto si trova nel
+ * semispazio indicato dalla normale.
+ */
+
+boolean RightSide(Plane *p, Point *v)
+{
+ double s=0;
+ int d;
+
+ for(d=0;d<DIM;d++) s+=p->N[d]*v->x[d];
+ if(s > p->off + EPSILON) return TRUE;
+		     else return FALSE;
+}
+
+
+/*
+ * CenterOffset
+ *
+ * Dato il piano di una faccia ed un punto v sul suo lato destro restituisce
+ * la posizione t sulla retta dei centri del centro della sfera passante
+ * per la faccia e per v (vedi le note in testa al file).
+ */
+
+double CenterOffset(Plane *p, Point *v)
+{
+ double h=0, q=0, t;
+ int d;
+
+ for(d=0;d<DIM;d++)
+   {
+    t=v->x[d]-p->Lu[d];
+    q+=t*t;
+    h+=p->N[d]*v->x[d];
+   }
+ return (q-p->R2)/(2*(h-p->off));
+}
+
+
+/*
+ * Orient
+ *
+ * Restituisce il determinante [p1-p0, ..., pDIM-p0] dei DIM+1 punti p:
+ * e' positivo se il simplesso e' orientato positivamente.
+ */
+
+double Orient(Point **p)
+{
+ double m[DIM][DIM];
+ int i,d;
+
+ for(i=0;i<DIM;i++)
+   for(d=0;d<DIM;d++) m[i][d]=p[i+1]->x[d]-p[0]->x[d];
+ return Det(m,DIM);
+}
+
+
+/*
+ * Intersect
+ *
+ * Restituisce 1 se la faccia e' tutta dal lato positivo del muro, -1 se e'
+ * tutta dal lato negativo e 0 se lo attraversa.
+ */
+
+int Intersect(Face *f, Wall *w)
+{
+ int i, pos=0;
+
+ for(i=0;i<DIM;i++)
+   if(f->v[i]->x[w->axis] >= w->off) pos++;
+
+ if(pos==DIM) return  1;
+ if(pos==0)   return -1;
+ return 0;
+}
+
+
+/*
+ * ReverseFace
+ *
+ * Inverte l'orientazione di una faccia scambiando due vertici.
+ */
+
+void ReverseFace(Face *f)
+{
+ Point *t;
+
+ t=f->v[0];
+ f->v[0]=f->v[1];
+ f->v[1]=t;
+}
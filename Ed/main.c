@@ -0,0 +1,184 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      main.c                                                     *
+*                                                                          *
+* PURPOSE:      The E^d Delaunay triangulators dewallD and incodeD.        *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*                                                                          *
+* EXPORTS:      ProgramName to error.c                                     *
+*               Statistic variables and program flags                      *
+*                                                                          *
+*   NOTES:      Compiled with -DINCODE this file gives the main of InCoDe, *
+*               otherwise of DeWall. DIM is the dimension of the space.    *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/chronos.h>
+#include <OList/parallel.h>
+
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ed.h"
+
+#define XSTR(s) STR(s)
+#define STR(s)	#s
+
+#ifdef INCODE
+#define PROGRAM "incode" XSTR(DIM)
+#else
+#define PROGRAM "dewall" XSTR(DIM)
+#endif
+
+#define USAGE_MESSAGE "\nUsage: " PROGRAM " [-s] [-u <x>] [-p] [-c] [-t] [-j nnn] filein [fileout]\n\
+	-s	Turn on statistic informations\n\
+	-u <x>	Set Uniform Grid scale ug size of <x>)\n\
+	-p	print the number of simplices built while processing\n\
+	-c	Check every simplex is a Delaunay one\n\
+	-t	Check for double creating Simplices (caused by num. errors)\n\
+	-j nnn	Use nnn threads for the check (default one for each processor)\n\
+"
+
+
+/***************************************************************************
+*									   *
+* Global Variables:							   *
+*									   *
+*     -	Statistic Informations						   *
+*     -	Program Flags							   *
+*									   *
+***************************************************************************/
+
+StatInfo SI;			/* Statistic Infomations */
+
+				/************** Program Flags **************/
+
+boolean CheckFlag	= OFF;	/* Whether checking each built simplex is  */
+				/* a Delaunay one.			   */
+
+boolean StatFlag	= OFF;	/* Whether printing Statistic Infomations. */
+
+float	UGScale		= UG_SCALE; /* The UG size user proposed	   */
+
+boolean UpdateFlag	= OFF;	/* Whether printing the increasing number  */
+				/* of builded simplices while processing.  */
+
+boolean SafeSimplexFlag = OFF;	/* Whether checking each new simplex is a  */
+				/* real new one, not twice inserted for	   */
+				/* numerical errors.			   */
+
+
+/***************************************************************************
+*									   *
+* main									   *
+*									   *
+* Do the usual command line parsing, file I/O and timing matters.	   *
+*									   *
+***************************************************************************/
+
+main(int argc, char *argv[])
+{
+ char buf[80];
+ Point **v;
+ Point *BaseV;
+#ifndef INCODE
+ List	Q;
+#endif
+ Store	T;
+ UG g;
+ pindex n,i=1;
+ long bad=0;
+ FILE *fp=stdout;
+
+ SetProgramName(PROGRAM);
+ if((argc<2) ||
+    (strcmp(argv[i],"/?")==0)||
+    (strcmp(argv[i],"-?")==0)||
+    (strcmp(argv[i],"/h")==0)||
+    (strcmp(argv[i],"-h")==0)  ) Error(USAGE_MESSAGE, EXIT);
+
+ while(i<argc && *argv[i]=='-')
+   {
+    switch(argv[i][1])
+      {
+       case 'p' : UpdateFlag=ON;			break;
+       case 'c' : CheckFlag=ON; 			break;
+       case 't' : SafeSimplexFlag=ON;			break;
+       case 's' : StatFlag=ON;				break;
+
+       case 'u' : if(argv[i][2]==0 && i+1<argc && isdigit(argv[i+1][0]))
+			 UGScale=atof(argv[++i]);
+		    else UGScale=atof(argv[i]+2);
+		  break;
+
+       case 'j' : if(argv[i][2]==0 && i+1<argc && isdigit(argv[i+1][0]))
+			 SetThreadNum(atoi(argv[++i]));
+		    else SetThreadNum(atoi(argv[i]+2));
+		  break;
+
+       default	: sprintf(buf,"Unknown options '%s'\n",argv[i]);
+		  Error(buf,NO_EXIT);
+      }
+    i++;
+   }
+
+ if(i>=argc) Error(USAGE_MESSAGE, EXIT);
+ BaseV=ReadPoints(argv[i++],&n);
+
+ if(argc>i) fp=fopen(argv[i],"w");
+ if(!fp) Error("Unable to open output file\n",EXIT);
+
+ InitStat();
+ SI.Point=n;
+
+ v=(Point **)malloc((size_t)n*sizeof(Point *));
+ if(!v) Error("Unable to allocate memory for Points\n",EXIT);
+ for(i=0;i<n;i++) v[i]=&(BaseV[i]);
+
+ T=NewStore(sizeof(ShortSimplex));		/* Initialize Built Sim-  */
+ if(SafeSimplexFlag)				/* plices Store T.	  */
+   HashStore((long)n*SIMPLEX_PER_POINT,HashSimplex,EqualSimplex,T);
+
+ ResetChronos(USER_CHRONOS);
+ StartChronos(USER_CHRONOS);
+
+#ifdef INCODE
+ InCoDe(v,BaseV,n,T);
+#else
+ Q=NewList(FIFO,sizeof(Face));
+ DeWall(v,BaseV,n,Q,T,0);
+ EraseList(Q);
+#endif
+
+ StopChronos(USER_CHRONOS);
+ SI.Secs=ReadChronos(USER_CHRONOS);
+ SI.Simplex=CountStore(T);
+
+ if(StatFlag) PrintStat();
+	 else printf("Points:%7" IDX " Secs:%6.2f Simplices:%7ld\n",SI.Point,SI.Secs,SI.Simplex);
+
+ if(CheckFlag)
+   {
+    BuildUG(v,n,n,&g);
+    bad=CheckTriangulation(T,BaseV,&g);
+    EraseUG(&g);
+    if(bad) Errorf(NO_EXIT,"%ld of %ld simplices are not Delaunay!\n",bad,SI.Simplex);
+       else printf("Checked %ld simplices, all Delaunay.\n",SI.Simplex);
+   }
+
+ WriteSimplexStore(T,fp);
+
+ return bad ? 1 : 0;
+}
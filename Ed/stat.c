@@ -0,0 +1,64 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	stat.c							   *
+*                                                                          *
+* PURPOSE:	Functions for Statistics evaluations.			   *
+*                                                                          *
+* IMPORTS:                                                                 *
+*                                                                          *
+* EXPORTS:	InitStat	Reset the statistic informations	   *
+*		PrintStat	Print them				   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ed.h"
+
+extern StatInfo SI;
+
+void InitStat()
+{
+ SI.Simplex=0;
+ SI.Face=0;
+ SI.CHFace=0;
+ SI.MakeSimplex=0;
+ SI.MaxPointPerCell=0;
+ SI.EmptyBox=0;
+ SI.SecondBox=0;
+ SI.TestedCell=0;
+ SI.TestedPoint=0;
+ SI.WallSize=0;
+}
+
+void PrintStat()
+{
+ printf("+----- Statistical Informations (E^%i) ----------------------------------+\n",DIM);
+
+ printf("|Points     |Time (sec.)|Simplices  |Faces      |CH Faces   |Cell Edge  |");
+ printf("\n");
+ printf("|%7" IDX "    |%7.3f    |%7ld    |%7ld    |%7ld    |%7.3f    |",
+	SI.Point,SI.Secs,SI.Simplex,SI.Face,SI.CHFace,SI.CellEdge);
+ printf("\n");
+
+ printf("|UGMakeSimp.|Empty Box  | 2nd Box   |PntPerFace |CellPerFace|WallSize   |");
+ printf("\n");
+ printf("|%7ld    |%7ld    |%7ld    |%7.2f    |%7.2f    |%7ld    |",
+	SI.MakeSimplex,SI.EmptyBox,SI.SecondBox,
+	(double)SI.TestedPoint/MAX(SI.MakeSimplex,1),
+	(double)SI.TestedCell/MAX(SI.MakeSimplex,1),SI.WallSize);
+ printf("\n");
+ printf("Cell Num %7i   Empty Cell %7i MaxPoint %7i   \n",
+	SI.Cell, SI.EmptyCell, SI.MaxPointPerCell);
+}
@@ -0,0 +1,353 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      unifgrid.c                                                 *
+*                                                                          *
+* PURPOSE:      Uniform Grid and simplex construction in E^d.              *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               Statistic Variables                                        *
+*                                                                          *
+* EXPORTS:	BuildUG		Initialize the UG data structure	   *
+*		EraseUG		Free the UG				   *
+*		BuildSimplex	Join a face and a point 		   *
+*		MakeSimplex	Build a new simplex scanning all the points*
+*		FastMakeSimplex Build a new simplex using UG to speed up   *
+*                                                                          *
+*   NOTES:      The dd-nearest search is the one of DeWall, with boxes of  *
+*               cells around the spheres through the face. It rests on a   *
+*               simple property: the spheres through a face, moving their  *
+*               center along the line of centers, enclose on the positive  *
+*               side of the face larger and larger regions. So once a      *
+*               point with center offset t is found the dd-nearest point   *
+*               is inside the sphere of offset t, and only the cells of    *
+*               its box must be scanned.                                   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/delaunay.h>
+
+#include "ed.h"
+
+
+/* Global for Statistic Infomations */
+
+extern StatInfo SI;
+
+/* Global Program Flag */
+
+extern boolean StatFlag;
+
+
+/***************************************************************************
+*									   *
+* AddPoint								   *
+* ErasePlist								   *
+*									   *
+* Add a point to the point list of a cell, free a whole list.		   *
+*									   *
+***************************************************************************/
+
+static Plist *AddPoint(Plist *P, Point *p)
+{
+ Plist *TempP;
+
+ TempP=(Plist *)malloc(sizeof(Plist));
+ if(!TempP)
+   Error("Insufficient memory to add a point to point list of the UG cell!!\n", EXIT);
+
+ TempP->p=p;
+ TempP->next=P;
+
+ return TempP;
+}
+
+static void ErasePlist(Plist *P)
+{
+ Plist *ElemToFree;
+
+ while(P)
+ {
+  ElemToFree=P;
+  P=P->next;
+  free(ElemToFree);
+ }
+}
+
+
+/***************************************************************************
+*									   *
+* BuildUG								   *
+*									   *
+* Given a vector v of n points this functions setup a Uniform Grid G of    *
+* about m cells. The cells are sized by the SizeGrid of OList, as for the  *
+* UG of DeWall.								   *
+*									   *
+***************************************************************************/
+
+UG *BuildUG(Point **v, pindex n, int m, UG *G)
+{
+ pindex i;
+ int d,index,c[DIM];
+
+ for(d=0;d<DIM;d++) G->vn[d]=G->vp[d]=v[0]->x[d];
+
+ for(i=0;i<n;i++)     /* Find the Bounding Box */
+   for(d=0;d<DIM;d++)
+     {
+      if(v[i]->x[d] < G->vn[d]) G->vn[d]=v[i]->x[d];
+      if(v[i]->x[d] > G->vp[d]) G->vp[d]=v[i]->x[d];
+     }
+
+ G->n=(int)SizeGrid(G->vn,G->vp,DIM,(double)m,G->c,&(G->side));
+ SI.CellEdge=G->side;
+ SI.Cell=G->n;
+
+ G->C  =  (Plist **)calloc((size_t)G->n, sizeof(Plist *));
+ G->Marked = (int *)calloc((size_t)G->n, sizeof(int));
+ if(!G->C || !G->Marked) Error("BuildUG, Not enough memory to build UG!!\n",EXIT);
+
+ for(i=0;i<n;i++)
+   {
+    for(d=0;d<DIM;d++) c[d]=GridCoord(v[i]->x[d],G->vn[d],G->side,G->c[d]);
+    index=GridIndex(c,G->c,DIM);
+    G->C[index] = AddPoint(G->C[index], v[i]);
+   }
+
+ G->Mark=0;
+
+ if(StatFlag)	  /* Calculate Statistical Information only if needed */
+ {
+  int c;
+  Plist *P;
+
+  SI.EmptyCell=0;
+  for(i=0;i<G->n;i++)
+   {
+    if(!G->C[i]) SI.EmptyCell++;
+    for(c=0,P=G->C[i];P;P=P->next) c++;
+    if(c>SI.MaxPointPerCell) SI.MaxPointPerCell=c;
+   }
+ }
+ return G;
+}
+
+void EraseUG(UG *G)
+{
+ int i;
+
+ for(i=0;i<G->n;i++)
+  ErasePlist(G->C[i]);
+
+ free(G->C);
+ free(G->Marked);
+}
+
+
+/***************************************************************************
+*									   *
+* BuildSimplex								   *
+*									   *
+* Given a face and a point return the simplex built joining face to point. *
+* The face i+1 is the face f with the vertex i replaced by p: it has the   *
+* vertex i on its negative side, so all the faces (except the first) are   *
+* outward oriented. The simplex f->v[0],...,f->v[DIM-1],p is positively    *
+* oriented.								   *
+*									   *
+***************************************************************************/
+
+Simplex *BuildSimplex(Face *f, Point *p)
+{
+ Simplex *s;
+ int i;
+
+ s=(Simplex *)malloc(sizeof(Simplex));
+ if(!s) Error("BuildSimplex, Not enough memory for a new simplex\n",EXIT);
+
+ for(i=0;i<=DIM;i++)
+   {
+    s->f[i]=(Face *)malloc(sizeof(Face));
+    if(!s->f[i]) Error("BuildSimplex, Not enough memory for a new simplex\n",EXIT);
+    *(s->f[i])=*f;
+   }
+ for(i=0;i<DIM;i++) s->f[i+1]->v[i]=p;
+
+ return s;
+}
+
+
+/***************************************************************************
+*									   *
+* TestPoint								   *
+*									   *
+* The test of a candidate point q for face f, shared by MakeSimplex and    *
+* FastMakeSimplex. Returns TRUE if q is better than the current best one.  *
+*									   *
+***************************************************************************/
+
+static boolean TestPoint(Point *q, Face *f, Plane *p, Point **best, double *tmin)
+{
+ double t;
+ int i;
+
+ if(q->mark==0) return FALSE;
+ for(i=0;i<DIM;i++)
+   if(q==f->v[i]) return FALSE;
+
+ SI.TestedPoint++;
+ if(!RightSide(p,q)) return FALSE;
+
+ t=CenterOffset(p,q);
+ if(t==*tmin) Errorf(EXIT,"Found %i cospherical points!!\n",DIM+2);
+ if(t>*tmin) return FALSE;
+
+ *tmin=t;
+ *best=q;
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* MakeSimplex								   *
+*									   *
+* Given a face find the dd-nearest point to it among the n points of v and *
+* joining it to the face build a new Delaunay simplex. Used when the	   *
+* points are too few to build a UG.					   *
+*									   *
+***************************************************************************/
+
+Simplex *MakeSimplex(Face *f, Point **v, pindex n)
+{
+ Plane p;
+ Point *best=NULL;
+ double tmin=BIGNUMBER;
+ int i;
+
+ SI.MakeSimplex++;
+ if(!CalcPlane(f,&p)) Error("MakeSimplex, Degenerate face!\n",EXIT);
+
+ for(i=0;i<n;i++) TestPoint(v[i],f,&p,&best,&tmin);
+
+ if(!best) return NULL;
+ return BuildSimplex(f,best);
+}
+
+
+/***************************************************************************
+*									   *
+* ScanSphere								   *
+*									   *
+* Scan the not yet marked cells of the box containing the sphere through   *
+* the face whose center is at offset t on the line of centers. The cells   *
+* that are all on the negative side of the face are skipped (as the	   *
+* ExaminableCell of DeWall they are tested on their vertex farthest along  *
+* the normal). Returns TRUE if the box is the whole UG.			   *
+*									   *
+* If Clip is set also the cells of the box that do not intersect the	   *
+* sphere are skipped, but they are left unmarked: a later scan of a larger *
+* sphere may need them. In E^d the sphere fills a smaller and smaller part *
+* of its box (about 1/3 in 4d), so this saves most of the tested points.   *
+*									   *
+***************************************************************************/
+
+static boolean ScanSphere(UG *G, Face *f, Plane *p, double t, boolean Clip,
+			  Point **best, double *tmin)
+{
+ int lo[DIM], hi[DIM], i[DIM], d, index;
+ double r, c[DIM], s;
+ boolean whole=TRUE;
+ Plist *P;
+
+ r=sqrt(p->R2+t*t);
+ for(d=0;d<DIM;d++) c[d]=p->Lu[d]+t*p->N[d];
+ GridBox(c,r,G->vn,G->side,G->c,DIM,lo,hi);
+ for(d=0;d<DIM;d++)
+   {
+    if(lo[d]>0 || hi[d]<G->c[d]-1) whole=FALSE;
+    i[d]=lo[d];
+   }
+
+ do
+   {
+    index=GridIndex(i,G->c,DIM);
+    s= Clip ? CellDistance(c,i,G->vn,G->side,DIM) : 0;
+
+    if(G->Marked[index]!=G->Mark && s<r*r)
+      {
+       G->Marked[index]=G->Mark;
+       SI.TestedCell++;
+
+       for(s=0,d=0;d<DIM;d++)
+	 s+=p->N[d]*(G->vn[d]+(i[d]+(p->N[d]>0))*G->side);
+
+       if(s > p->off)
+	 for(P=G->C[index];P;P=P->next) TestPoint(P->p,f,p,best,tmin);
+      }
+   }
+ while(NextCell(i,lo,hi,DIM));
+
+ return whole;
+}
+
+
+/***************************************************************************
+*									   *
+* FastMakeSimplex							   *
+*									   *
+* Given a face and a UG, finds the dd-nearest point to face f:		   *
+*									   *
+*    scan the box of the smallest sphere through the face		   *
+*									   *
+*    while found nothing and the box is not the whole UG		   *
+*	double the center offset and scan the new box			   *
+*									   *
+*    if we found a point make a security scan of the box of its sphere	   *
+*									   *
+* Marked cells are never scanned twice, and if we find nothing the face is *
+* on the convex hull.							   *
+*									   *
+***************************************************************************/
+
+Simplex *FastMakeSimplex(Face *f, UG *G)
+{
+ Plane p;
+ Point *best=NULL;
+ double t, tmin=BIGNUMBER;
+
+ SI.MakeSimplex++;
+ G->Mark++;
+
+ if(!CalcPlane(f,&p)) Error("FastMakeSimplex, Degenerate face!\n",EXIT);
+
+ ScanSphere(G,f,&p,0.0,TRUE,&best,&tmin);
+
+ if(!best)
+   {
+    SI.EmptyBox++;
+    t=MAX(sqrt(p.R2),G->side);
+    while(!ScanSphere(G,f,&p,t,FALSE,&best,&tmin) && !best) t*=2;
+   }
+
+ if(!best) return NULL;
+
+ if(tmin>0)
+   {
+    SI.SecondBox++;
+    ScanSphere(G,f,&p,tmin,TRUE,&best,&tmin);
+   }
+
+ return BuildSimplex(f,best);
+}
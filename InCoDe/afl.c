@@ -0,0 +1,204 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      afl.c                                                      *
+*                                                                          *
+* PURPOSE:      The Active Face List of InCoDe, scheduled by UG blocks.    *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               UG built for the triangulation                             *
+*                                                                          *
+* EXPORTS:      NewAFL          Initialize an empty AFL                    *
+*               InsertAFL       Insert a face                              *
+*               DeleteAFL       Delete a face equal to the given one       *
+*               ExtractAFL      Extract the next face to process           *
+*               EraseAFL        Free the AFL                               *
+*                                                                          *
+*   NOTES:      With a single FIFO List consecutive faces can be anywhere  *
+*               in the space and each FastMakeTetra scans cold cells. Here *
+*               the faces are kept in a List for each block of UG cells    *
+*               and a block is drained before moving to the next one, in   *
+*               the order the blocks got their first face. The result does *
+*               not depend on the order the faces are processed, only the  *
+*               order of the tetrahedra in the output changes.             *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/delaunay.h>
+
+#include "graphics.h"
+#include "incode.h"
+
+
+/*
+ * BlockAFL
+ *
+ * Restituisce il blocco di una faccia: quello della cella del suo vertice
+ * di indice minimo, che non dipende dall'ordine dei vertici.
+ */
+
+static int BlockAFL(Face *f, AFL *A)
+{
+ Point3 *p;
+ UG *G=A->G;
+ pindex m=f->v[0];
+ int i,j,k;
+
+ if(f->v[1]<m) m=f->v[1];
+ if(f->v[2]<m) m=f->v[2];
+ p=&(A->v[m]);
+
+ i=GridCoord(p->x, G->vn.x, G->side, G->x)/AFL_BLOCK;
+ j=GridCoord(p->y, G->vn.y, G->side, G->y)/AFL_BLOCK;
+ k=GridCoord(p->z, G->vn.z, G->side, G->z)/AFL_BLOCK;
+
+ return i + j*A->x + k*A->y*A->x;
+}
+
+
+/***************************************************************************
+*									   *
+* NewAFL								   *
+*									   *
+* Initialize an empty AFL over the UG G of the points v. The List of each  *
+* block is built only when the block gets its first face.		   *
+*									   *
+***************************************************************************/
+
+AFL *NewAFL(Point3 *v, UG *G, AFL *A)
+{
+ int n;
+
+ A->x=(G->x+AFL_BLOCK-1)/AFL_BLOCK;
+ A->y=(G->y+AFL_BLOCK-1)/AFL_BLOCK;
+ A->z=(G->z+AFL_BLOCK-1)/AFL_BLOCK;
+ n=A->x*A->y*A->z;
+
+ A->B=(List *)calloc((size_t)n,sizeof(List));
+ A->Queued=(char *)calloc((size_t)n,sizeof(char));
+ A->Next=(int *)malloc((size_t)n*sizeof(int));
+ if(!A->B || !A->Queued || !A->Next)
+   Error("NewAFL, Not enough memory to build the Active Face List!!\n",EXIT);
+
+ A->Head=0;
+ A->Count=0;
+ A->Curr=-1;
+ A->v=v;
+ A->G=G;
+ return A;
+}
+
+
+/***************************************************************************
+*									   *
+* InsertAFL								   *
+*									   *
+* Insert a face in the List of its block. A block that is neither waiting  *
+* nor being drained is queued at the end of the ring.			   *
+*									   *
+***************************************************************************/
+
+void InsertAFL(Face *f, AFL *A)
+{
+ int b=BlockAFL(f,A), n=A->x*A->y*A->z;
+
+ if(!A->B[b])
+   {
+    A->B[b]=NewList(FIFO,sizeof(Face));
+    ChangeEqualObjectList(EqualFace,A->B[b]);
+    HashList(AFL_HASH,HashFace,A->B[b]);
+   }
+ InsertList(f,A->B[b]);
+
+ if(!A->Queued[b])
+   {
+    A->Queued[b]=1;
+    A->Next[(A->Head+A->Count)%n]=b;
+    A->Count++;
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* DeleteAFL								   *
+*									   *
+* If a face equal to f is in the AFL delete it and return it, otherwise    *
+* return NULL. An emptied block stays in the ring and is skipped by	   *
+* ExtractAFL.								   *
+*									   *
+***************************************************************************/
+
+Face *DeleteAFL(Face *f, AFL *A)
+{
+ List l=A->B[BlockAFL(f,A)];
+ Face *old;
+
+ if(!l || !MemberList(f,l)) return NULL;
+ CurrList(&old,l);
+ DeleteCurrList(l);
+ return old;
+}
+
+
+/***************************************************************************
+*									   *
+* ExtractAFL								   *
+*									   *
+* Extract a face of the block being drained; when it is empty go on with   *
+* the first block of the ring. It returns FALSE when the AFL is empty.	   *
+*									   *
+***************************************************************************/
+
+boolean ExtractAFL(Face **f, AFL *A)
+{
+ int n=A->x*A->y*A->z;
+
+ for(;;)
+   {
+    if(A->Curr>=0)
+      {
+       if(ExtractList(f,A->B[A->Curr])) return TRUE;
+       A->Queued[A->Curr]=0;
+      }
+    if(A->Count==0)
+      {
+       A->Curr=-1;
+       return FALSE;
+      }
+    A->Curr=A->Next[A->Head];
+    A->Head=(A->Head+1)%n;
+    A->Count--;
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* EraseAFL								   *
+*									   *
+* Free the Lists of the blocks and the AFL vectors.			   *
+*									   *
+***************************************************************************/
+
+void EraseAFL(AFL *A)
+{
+ int i, n=A->x*A->y*A->z;
+
+ for(i=0;i<n;i++)
+   if(A->B[i]) EraseList(A->B[i]);
+
+ free(A->B);
+ free(A->Queued);
+ free(A->Next);
+}
@@ -0,0 +1,156 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      check.c                                                    *
+*                                                                          *
+* PURPOSE:      Verification that the built tetrahedra are Delaunay ones.  *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               UG built for the triangulation                             *
+*                                                                          *
+* EXPORTS:      CheckTetraUG        Check one tetrahedron using the UG     *
+*               CheckTriangulation  Check all the built tetrahedra         *
+*                                                                          *
+*   NOTES:      The old check compared each circumsphere against all the   *
+*               n points, making the -c option quadratic. Here we scan     *
+*               only the UG cells that overlap the circumsphere, so the    *
+*               whole check costs about as much as the triangulation and   *
+*               it is done in parallel over the list of built tetrahedra.  *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/delaunay.h>
+
+#include "graphics.h"
+#include "incode.h"
+
+#define MAX_REPORTED 10		/* Bad tetrahedra described on stderr */
+
+
+/***************************************************************************
+*									   *
+* CheckTetraUG								   *
+*									   *
+* Test that no point of the UG G lies inside the sphere circumscribed to   *
+* tetrahedron t. Only the cells of the box containing the sphere are	   *
+* scanned, and among them only those that intersect the sphere.	   *
+*									   *
+* It returns -1 if t is Delaunay, the index of a point inside its sphere   *
+* otherwise (or the index of its first vertex if t is flat).		   *
+*									   *
+* It does not use the cell marks of the UG, so it can be called at the	   *
+* same time by many threads.						   *
+*									   *
+***************************************************************************/
+
+pindex CheckTetraUG(ShortTetra *t, Point3 *v, UG *G)
+{
+ Point3 Center;
+ double Radius, MinDist, o[3], g[3];
+ int lo[3], hi[3], i[3], c[3], k;
+ Plist *P;
+
+ if(!CalcSphereCenter(&(v[t->v[0]]), &(v[t->v[1]]),
+		      &(v[t->v[2]]), &(v[t->v[3]]), &Center))
+			return t->v[0];
+
+ Radius = V3DistanceBetween2Points(&Center, &(v[t->v[0]]));
+ if(Radius<=EPSILON) return -1;
+
+ MinDist = (Radius-EPSILON)*(Radius-EPSILON);
+
+ o[0]=Center.x;  o[1]=Center.y;  o[2]=Center.z;
+ g[0]=G->vn.x;	 g[1]=G->vn.y;	 g[2]=G->vn.z;
+ c[0]=G->x;	 c[1]=G->y;	 c[2]=G->z;
+
+ GridBox(o,Radius,g,G->side,c,3,lo,hi);
+ for(k=0;k<3;k++) i[k]=lo[k];
+
+ do
+   if(CellDistance(o,i,g,G->side,3)<MinDist)	/* The cell meets the sphere */
+     for(P=G->C[GridIndex(i,c,3)]; P; P=P->next)
+       if(V3SquaredDistanceBetween2Points(&Center,&(v[P->p])) < MinDist)
+	 if(P->p!=t->v[0] && P->p!=t->v[1] &&
+	    P->p!=t->v[2] && P->p!=t->v[3]) return P->p;
+ while(NextCell(i,lo,hi,3));
+
+ return -1;
+}
+
+
+/***************************************************************************
+*									   *
+* CheckTriangulation							   *
+*									   *
+* Check in parallel all the tetrahedra of the store T. Each violation is   *
+* counted and the first ones are reported on stderr. It returns the number *
+* of tetrahedra that are not Delaunay.					   *
+*									   *
+***************************************************************************/
+
+typedef struct CheckJobstruct
+{
+ Store T;			/* The tetrahedra to check		  */
+ Point3 *v;
+ UG *G;
+ long Bad[MAX_THREADS]; 	/* Bad tetrahedra found by each thread	  */
+ int Reported;
+} CheckJob;
+
+static void CheckBody(long from, long to, int thread, void *arg)
+{
+ CheckJob *J=(CheckJob *)arg;
+ ShortTetra *t;
+ long i;
+ pindex p;
+
+ for(i=from;i<to;i++)
+   {
+    t=(ShortTetra *)StoreElem(i,J->T);
+    p=CheckTetraUG(t,J->v,J->G);
+    if(p<0) continue;
+
+    J->Bad[thread]++;
+    LockParallel();
+    if(J->Reported++ < MAX_REPORTED)
+      {
+       if(p==t->v[0])
+	 Errorf(NO_EXIT,"CheckTriangulation, flat tetrahedron %" IDX " %" IDX " %" IDX " %" IDX "\n",
+		t->v[0],t->v[1],t->v[2],t->v[3]);
+       else
+	 Errorf(NO_EXIT,"CheckTriangulation, point %" IDX " inside the sphere of %" IDX " %" IDX " %" IDX " %" IDX "\n",
+		p,t->v[0],t->v[1],t->v[2],t->v[3]);
+      }
+    UnlockParallel();
+   }
+}
+
+long CheckTriangulation(Store T, Point3 *v, UG *G)
+{
+ CheckJob J;
+ long i, Bad=0;
+
+ J.T=T;
+ J.v=v;
+ J.G=G;
+ J.Reported=0;
+ for(i=0;i<MAX_THREADS;i++) J.Bad[i]=0;
+
+ ParallelFor(CountStore(T), 0, CheckBody, &J);
+
+ for(i=0;i<MAX_THREADS;i++) Bad+=J.Bad[i];
+
+ return Bad;
+}
@@ -11,7 +11,8 @@
 *                                                                          *
 * EXPORTS:      ReadPoints          Read a Point file                      *
 *               Tetra2ShortTetra    Trasform a Tetra in a ShortTetra       *
-*               WriteTetraList      Write a tetra list on a file           *
+*               WriteTetraStore     Write a tetra store on a file          *
+*               WriteTetraVector    Write a tetra vector on a file         *
 *               HashFace            Hash key function for Faces            *
 *               EqualFace           Testing equalness of Faces             *
 *               HashTetra           Hash key function for Tetras           *
@@ -34,42 +35,75 @@
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/numfile.h>
+#include <OList/cloud.h>
 
 #include "graphics.h"
 #include "incode.h"
 
 /* Global for Statistic Infomations */
 
-extern StatInfo SI;
+extern PARALLEL_LOCAL StatInfo SI;
 
 
 /*
- * ReadPoints
+ * ReadPnt
  *
- * Legge un file di punti e restituisce un vettore di punti e il numero n di punti letti.
+ * Legge un file di punti nel formato di DeWall e InCoDe e restituisce un
+ * vettore di punti e il numero n di punti letti.
  * Formato del File:
  *      N
  *      X Y Z
  *      X Y Z
  *      ...
  *
+ * Le coordinate sono lette in parallelo da ReadReals (vedi numfile.c).
  */
 
-Point3 *ReadPoints(char *filename, int *n)
+static Point3 *ReadPnt(char *filename, long *n)
 {
- FILE *fp;
- int i;
+ NumFile F;
+ long m;
  Point3 *vec;
 
- fp=fopen(filename,"r");
- if(!fp) Error("ReadPoints, Unable to open input file.\n",EXIT);
+ if(!OpenNumFile(filename,&F)) Error("ReadPoints, Unable to open input file.\n",EXIT);
 
- fscanf(fp,"%d",n);
- vec=(Point3 *)calloc((size_t)*n,sizeof(Point3));
+ if(!ReadLong(&F,n) || *n<0)
+   Errorf(EXIT,"ReadPoints, %s is not a point file.\n",filename);
+
+ vec=(Point3 *)calloc((size_t)MAX(*n,1),sizeof(Point3));
  if(!vec) Error("ReadPoints, Not enough memory to load point dataset.\n",EXIT);
 
- for(i=0;i<*n;i++)
- fscanf(fp,"%lf %lf %lf ",&(vec[i].x),&(vec[i].y),&(vec[i].z));
+ if((m=ReadReals(&F,*n,3,&(vec[0].x),sizeof(Point3)))<*n)
+   Errorf(EXIT,"ReadPoints, %s truncated at point %ld.\n",filename,m);
+ CloseNumFile(&F);
+
+ return vec;
+}
+
+
+/*
+ * ReadPoints
+ *
+ * Legge i punti di un file .pnt (vedi ReadPnt) oppure PLY, LAS o XYZ
+ * (vedi cloud.c), tenendo solo quelli che passano il filtro PF, e
+ * restituisce il vettore e il numero n di punti.
+ */
+
+Point3 *ReadPoints(char *filename, PointFilter *PF, pindex *n)
+{
+ long m;
+ Point3 *vec;
+
+ vec=(Point3 *)ReadCloud(filename,PF,sizeof(Point3),&m);
+ if(!vec)
+   {
+    vec=ReadPnt(filename,&m);
+    m=FilterPoints(vec,m,sizeof(Point3),PF);
+   }
+ *n=(pindex)m;
 
  return vec;
 }
@@ -79,20 +113,14 @@ Point3 *ReadPoints(char *filename, int *n)
 /*
  * Tetra2ShortTetra
  *
- * Dato un tetra restituisce un puntatore ad un ShortTetra
- * vettore di int con i quattro vertici
+ * Dato un tetra riempie lo ShortTetra st, vettore di int con i quattro
+ * vertici, e lo restituisce.
  *
  */
 
-ShortTetra *Tetra2ShortTetra(Tetra *t)
+ShortTetra *Tetra2ShortTetra(Tetra *t, ShortTetra *st)
 {
  int i;
- ShortTetra *st;
-
- st=(ShortTetra *)malloc(sizeof(ShortTetra));
- if(!st)
-   Error("Tetra2ShortTetra, Unable to allocate memory for ShortTetra\n",EXIT);
-
 
  st->v[0]=t->f[0]->v[0];
  st->v[1]=t->f[0]->v[1];
@@ -108,21 +136,41 @@ ShortTetra *Tetra2ShortTetra(Tetra *t)
 }
 
 /*
- * WriteTetraList
+ * WriteTetraStore
  *
- * Scrive nel file fp una lista di tetraedri,
- * ogni tetraedro e' scritto come 4 vertici.
- * All'inizio del file viene scritto il numero di tetraedri, ricavato dalla
- * variabile globale Tetra.
+ * Scrive nel file fp i tetraedri di T nell'ordine in cui sono stati
+ * costruiti, ogni tetraedro e' scritto come 4 vertici.
+ * All'inizio del file viene scritto il numero di tetraedri.
  */
 
-void WriteTetraList(List TList, FILE *fp)
+void WriteTetraStore(Store T, FILE *fp)
 {
  ShortTetra *t;
+ long i;
+
+ fprintf(fp,"%ld\n",CountStore(T));
+ for(i=0;i<CountStore(T);i++)
+   {
+    t=(ShortTetra *)StoreElem(i,T);
+    fprintf(fp,"%6" IDX " %6" IDX " %6" IDX " %6" IDX "\n",t->v[0],t->v[1],t->v[2],t->v[3]);
+   }
+}
+
+
+/*
+ * WriteTetraVector
+ *
+ * Scrive nel file fp un vettore di n tetraedri, nello stesso formato
+ * di WriteTetraStore.
+ */
 
- fprintf(fp,"%d\n",CountList(TList));
- while(ExtractList(&t,TList))
-   fprintf(fp,"%6i %6i %6i %6i\n",t->v[0],t->v[1],t->v[2],t->v[3]);
+void WriteTetraVector(ShortTetra *t, long n, FILE *fp)
+{
+ long i;
+
+ fprintf(fp,"%ld\n",n);
+ for(i=0;i<n;i++)
+   fprintf(fp,"%6" IDX " %6" IDX " %6" IDX " %6" IDX "\n",t[i].v[0],t[i].v[1],t[i].v[2],t[i].v[3]);
 }
 
 
@@ -131,10 +179,13 @@ void WriteTetraList(List TList, FILE *fp)
 /*
  * HashFace
  *
- * Data una faccia ed un intero indicante la lunghezza del vettore Hash
- * restituisce la posizione nel vettore.
+ * Data una faccia restituisce la sua chiave hash, che non dipende
+ * dall'ordine dei vertici.
  *
- * tecnica usata: XOR dei tre vertici
+ * tecnica usata: somma e XOR dei tre indici moltiplicati per una costante
+ * dispari, poi rimescolati, come in DeWall. Lo XOR dei soli indici di
+ * vertici vicini, che hanno indici simili nei dataset ordinati, riempie
+ * pochi bucket delle hash piccole dei blocchi della AFL.
  *
  */
 
@@ -142,7 +193,20 @@ void WriteTetraList(List TList, FILE *fp)
 int HashFace(void *F)
 {
  Face *f=(Face *)F;
- return (f->v[0]) ^ (f->v[1]) ^ (f->v[2]) ;
+ unsigned long s=0, x=0, a, h;
+ int i;
+
+ for(i=0;i<3;i++)
+   {
+    a=(unsigned long)f->v[i]*2654435761UL;
+    s+=a;
+    x^=a;
+   }
+ h=s*31+x;
+ h^=h>>16;
+ h*=0x45d9f3bUL;
+ h^=h>>16;
+ return (int)(h & 0x7fffffff);
 }
 
 
@@ -213,14 +277,32 @@ boolean EqualTetra(void *T0, void *T1)
 }
 
 /*
- * Hash Function for fast list operation.
+ * HashTetra
+ *
+ * Hash Function for the tetrahedra store.
  * It must return the same key for equal tetrahedra (even if vertices are
- * differentely ordered).
+ * differentely ordered): the key is computed on the canonical form of the
+ * tetrahedron, its four vertices sorted.
  */
 
 int HashTetra(void *T)
 {
  ShortTetra *t=(ShortTetra *)T;
-
- return (t->v[0]*73)^(t->v[1]*73)^(t->v[2]*73)^(t->v[3]*73);
+ unsigned long h;
+ pindex a[4], x;
+ int i, j;
+
+ for(i=0;i<4;i++)			/* Insertion sort dei vertici */
+   {
+    x=t->v[i];
+    for(j=i;j>0 && a[j-1]>x;j--) a[j]=a[j-1];
+    a[j]=x;
+   }
+
+ h=(unsigned long)a[0];
+ for(i=1;i<4;i++) h=h*2654435761UL+(unsigned long)a[i];
+ h^=h>>16;
+ h*=0x45d9f3bUL;
+ h^=h>>16;
+ return (int)(h & 0x7fffffff);
 }
@@ -18,6 +18,8 @@
 *               CalcLineofCenter    Given a face calc the line containing  *
 *                                   centers of spheres touching the face   *
 *                                   vertices.                              *
+*               CalcDDForm          The dd distance from a face as an      *
+*                                   affine form of the lifted coords       *
 *               CalcLinePlaneInter  intersection of a line and a plane     *
 *               PointBelongtoPlane                                         *
 *               PointBelongtoLine                                          *
@@ -41,11 +43,13 @@
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
 
 #include "graphics.h"
 #include "incode.h"
 
-extern StatInfo SI;
+extern PARALLEL_LOCAL StatInfo SI;
 
 /*
  * CalcPlane
@@ -271,6 +275,41 @@ Line *CalcLineofCenter(Point3 *p1, Point3 *p2, Point3 *p3, Line *l)
 }
 
 
+/*
+ * CalcDDForm
+ *
+ * Dati il piano di una faccia, la sua linea dei centri e il raggio del
+ * cerchio per i suoi vertici prepara la forma affine d con cui si calcola
+ * la distanza dd di un punto dalle sue coordinate relative ad o e dal suo
+ * |r|^2 (vedi DDForm). Il centro della sfera per la faccia e per p e' a
+ * Lu + t N con
+ *
+ *	      |p - Lu|^2 - R^2	   w - 2(Lu-o).r + |Lu-o|^2 - R^2
+ *	 t = ------------------ = --------------------------------
+ *	       2 (N.p - off)		   2 (N.r - (off - N.o))
+ *
+ * cosi' per ogni punto bastano due prodotti scalari e una divisione,
+ * invece di un piano di mezzo normalizzato e della sua intersezione con
+ * la linea dei centri.
+ */
+
+DDForm *CalcDDForm(Plane *p, Line *Lc, double FaceRadius, Point3 *o, DDForm *d)
+{
+ Vector3 L;
+
+ V3Sub(&(Lc->Lu),o,&L);
+ d->N=p->N;
+ d->off=p->off-V3Dot(&(p->N),o);
+ d->A.x=-2*L.x;
+ d->A.y=-2*L.y;
+ d->A.z=-2*L.z;
+ d->R2=FaceRadius*FaceRadius;
+ d->K=V3Dot(&L,&L)-d->R2;
+
+ return d;
+}
+
+
 /*
  * CalcLinePlaneInter
  *
@@ -344,7 +383,7 @@ boolean PointBelongtoPlane(Point3 *p, Plane *pl)
 
 boolean ReverseFace(Face *f)
 {
- int index;
+ pindex index;
 
   index  = f->v[0];
  f->v[0] = f->v[1];
@@ -16,6 +16,9 @@
 *               Line            Definition                                 *
 *               Plist           Definition                                 *
 *		UG		Definition				   *
+*		AFL		Definition				   *
+*		StarSpace	Definition				   *
+*		Locator 	Definition				   *
 *                                                                          *
 *   NOTES:      This is the optimized version of the InCoDe algorithm.     *
 *               It use hashing and Uniform Grid techniques to speed up     *
@@ -27,14 +30,18 @@
 ****************************************************************************
 ***************************************************************************/
 
+#include <OList/cloud.h>	/* PointFilter, for ReadPoints		  */
+
 #define BIGNUMBER 1000000000.0
 #define EPSILON 0.0000001
+#define TETRA_PER_POINT 7	/* About 6.8 tetrahedra for each point of */
+				/* a uniform dataset, sizes the -t hash.  */
 
 
 
 typedef struct Facestruct	/* A Face is an array of 3 int indices of */
 {				/* Point3 in the Point3 vector. 	  */
- int v[3];			/* Faces are oriented, top follows right  */
+ pindex v[3];			/* Faces are oriented, top follows right  */
 } Face; 			/* hand rules for vertex ordering	  */
 
 
@@ -45,7 +52,7 @@ typedef struct Tetrastruct	/* A Tetra is an array of 4 Face pointers */
 
 typedef struct Tetra2struct
 {				/* A ShortTetra is an abbreviated type for*/
- int v[4];			/* representing Tetrahedra. It contains   */
+ pindex v[4];			/* representing Tetrahedra. It contains   */
 } ShortTetra;			/* only the four index of its vertices	  */
 
 
@@ -61,10 +68,21 @@ typedef struct Linestruct	/* A Line in the space is the direction   */
  Vector3 Lv;
 } Line;
 
+typedef struct DDFormstruct	/* The dd distance from a face of a point */
+{				/* given as r=p-o and its lifted coord	  */
+ Vector3 N;			/* w=|r|^2 (o is the UG center). With	  */
+ double off;			/* h = N.r - off the height of p on the   */
+ Vector3 A;			/* face and t = (w + A.r + K)/(2h), the   */
+ double K;			/* sphere through face and p has center   */
+ double R2;			/* at Lu + t N and squared radius R2+t^2. */
+} DDForm;
+
 struct plist			/* This is a List of Point. I dont used   */
 {				/* Olist for this structure because it is */
- int p; 			/* really very simple, used many times and*/
+ pindex p;			/* really very simple, used many times and*/
  struct plist *next;		/* I write this code before Olist :-)	  */
+ Point3 r;			/* r and w are the point relative to the  */
+ double w;			/* UG center and its lifted coordinate.   */
 };
 
 typedef struct plist Plist;
@@ -91,6 +109,7 @@ typedef struct UGstruct {
 
 	Point3 vp;	/* Maximum vertex of UG */
 	Point3 vn;	/* Minimum vertex of UG */
+	Point3 o;	/* Center of UG, origin of the Plist r */
 
 	double side;	/* Cell Edge */
 
@@ -104,34 +123,139 @@ typedef struct UGstruct {
 	                /* all the tetra around a point.             */
 	} UG;
 
+/****************************************************************************
+*									    *
+* UG tuning								    *
+*									    *
+* When the user does not give the UG size, TuneUG chooses it from a sample  *
+* of UG_SAMPLE points binned in a coarse grid of UG_SAMPLE_CELL sampled     *
+* points per cell. The clustering index K measures how many more neighbours *
+* a point has than in a uniform set of the same bounding box (1 for uniform *
+* sets). A face costs the visited cells plus the tested points: for uniform *
+* sets the balance is at about UG_OCCUPANCY points per cell, clustered sets *
+* need finer cells, so the UG gets n * K^UG_CLUSTER / UG_OCCUPANCY cells,   *
+* between UG_MIN_SCALE*n and UG_MAX_SCALE*n. The two constants are fitted   *
+* on benchmark runs and can be changed from the command line.		    *
+*									    *
+****************************************************************************/
+
+#define UG_SAMPLE	4096	/* Points sampled by TuneUG		   */
+#define UG_SAMPLE_CELL	8	/* Sampled points per coarse cell	   */
+#define UG_OCCUPANCY	4.0	/* Points per cell for uniform sets	   */
+#define UG_CLUSTER	0.7	/* Exponent of the clustering index	   */
+#define UG_MIN_SCALE	0.125	/* Bounds of the tuned cells/points ratio  */
+#define UG_MAX_SCALE	8.0
+
+				/* m cells as the int of BuildUG, with x*y*z */
+				/* still in an int (needs limits.h)	    */
+#define UG_CELLS(m)	((int)MIN(MAX((double)(m),1.0),(double)INT_MAX/2))
+
+
+
+
+/****************************************************************************
+*									    *
+* AFL (Active Face List)						    *
+*									    *
+* The faces still to be processed, in a FIFO List for each block of	    *
+* AFL_BLOCK^3 cells of the UG. A face belongs to the block of its vertex    *
+* with the smallest index, so equal faces are always in the same List.	    *
+* The faces are extracted one block at a time: the cells and the points    *
+* scanned by consecutive FastMakeTetra are the same few ones and stay in    *
+* the cache. The blocks that have faces wait their turn in the ring Next.   *
+*									    *
+****************************************************************************/
+
+#define AFL_BLOCK 4		/* UG cells for each side of a block	   */
+#define AFL_HASH  512		/* Hash size of the List of a block	   */
+
+typedef struct AFLstruct {
+	int x;		/* Block number for each axis */
+	int y;
+	int z;
+
+	List *B;	/* The faces of each block, NULL if never used */
+	char *Queued;	/* Whether a block is in Next or is Curr       */
+	int *Next;	/* Ring of the blocks waiting to be drained    */
+	int Head;
+	int Count;
+	int Curr;	/* The block being drained, -1 if none         */
+
+	Point3 *v;
+	UG *G;
+	} AFL;
+
+
+/****************************************************************************
+*									    *
+* StarSpace								    *
+*									    *
+* The workspace of a thread building the stars of single points (star.c):  *
+* a copy of the UG with its own cell marks, the open faces around the	    *
+* point, hashed on STAR_HASH entries, the tetrahedra of the star and its    *
+* neighbours.								    *
+*									    *
+****************************************************************************/
+
+#define STAR_HASH 64		/* Hash size of the open faces of a star   */
 
+typedef struct StarSpacestruct {
+	UG G;
+	List Q;
+	ShortTetra *t;	/* The nt tetrahedra of the star, room for Size */
+	long nt;
+	long Size;
+	pindex *nb;	/* The neighbours, room for NbSize	       */
+	long NbSize;
+	} StarSpace;
+
+
+/****************************************************************************
+*									    *
+* Locator								    *
+*									    *
+* The index to find the tetrahedron that contains a point (locate.c): the   *
+* four tetrahedra adjacent to each one and, for each cell of the UG, the    *
+* tetrahedron where the walks of the points of the cell start.		    *
+*									    *
+****************************************************************************/
+
+typedef struct Locatorstruct {
+	Store T;	/* The nt tetrahedra of the points v	       */
+	long nt;
+	Point3 *v;
+	UG *G;
+	long *Adj;	/* Beyond the face opposite to each vertex     */
+	long *Seed;	/* A tetrahedron for each cell of G	       */
+	} Locator;
 
 typedef struct StatInfostruct
 {
 			/* General Stats	*/
-  int	 Point;
+  pindex Point;
   double Secs;
-  int	 Face;
-  int	 CHFace;
-  int	 Tetra;
+  long	 Face;
+  long	 CHFace;
+  long	 Tetra;
 			/* UG Stats		*/
   int	 Cell;
   int	 EmptyCell;
   int	 MaxPointPerCell;
   double CellEdge;
+  double Cluster;	/* Clustering index found by TuneUG */
 			/* List Stats		*/
   int	 QSize;
   int	 EqualTest;
 			/* Incode Stats 	*/
   long	 TestedPoint;
-  int	 MakeTetra;
+  long	 MakeTetra;
   double MinRadius;
   double Radius;
   int	 MinRadiusNum;
 			/* Incode + UG Stats	*/
-  int	 EmptyBox;
-  int	 SecondBox;
-  int	 UsefulSecondBox;
+  long	 EmptyBox;
+  long	 SecondBox;
+  long	 UsefulSecondBox;
   long	 TestedCell;
 
 } StatInfo;
@@ -148,9 +272,10 @@ typedef struct StatInfostruct
 *   file.c                                                                *
 **************************************************************************/
 
-Point3 *ReadPoints(char *filename, int *n);
-void WriteTetraList(List T, FILE *fp);
-ShortTetra *Tetra2ShortTetra(Tetra *t);
+Point3 *ReadPoints(char *filename, PointFilter *PF, pindex *n);
+void WriteTetraStore(Store T, FILE *fp);
+void WriteTetraVector(ShortTetra *t, long n, FILE *fp);
+ShortTetra *Tetra2ShortTetra(Tetra *t, ShortTetra *st);
 
 int HashFace(void *F);
 int HashTetra(void *T);
@@ -170,6 +295,7 @@ Point3 *NormalToFace(Point3 *v, Face *f, Point3 *n);
 Point3 *CalcLinePlaneInter(Line *l, Plane *p, Point3 *c);
 Plane *CalcMiddlePlane(Point3 *p1, Point3 *p2, Plane *p);
 Line *CalcLineofCenter(Point3 *p1, Point3 *p2, Point3 *p3, Line *l);
+DDForm *CalcDDForm(Plane *p, Line *Lc, double FaceRadius, Point3 *o, DDForm *d);
 boolean PointBelongtoLine(Point3 *p, Line *l);
 boolean PointBelongtoPlane(Point3 *p, Plane *pl);
 boolean ReverseFace(Face *f);
@@ -178,16 +304,58 @@ boolean ReverseFace(Face *f);
 *   unifgrid.c                                                            *
 **************************************************************************/
 
-UG *BuildUG(Point3 *v, int n, int m, UG *C);
-Tetra *FastMakeTetra(Face *f,Point3 *v, int n, UG *C);
+int TuneUG(Point3 *v, pindex n);
+UG *BuildUG(Point3 *v, pindex n, int m, UG *C);
+void EraseUG(UG *G);
+Tetra *FastMakeTetra(Face *f,Point3 *v, pindex n, UG *C);
+
+
+/**************************************************************************
+*   afl.c								  *
+**************************************************************************/
+
+AFL *NewAFL(Point3 *v, UG *G, AFL *A);
+void InsertAFL(Face *f, AFL *A);
+Face *DeleteAFL(Face *f, AFL *A);
+boolean ExtractAFL(Face **f, AFL *A);
+void EraseAFL(AFL *A);
 
 
 /**************************************************************************
 *   main.c                                                                *
 **************************************************************************/
 
-void CheckTetra(Tetra *t, Point3 v[], int n);
-Tetra *BuildTetra(Face *f, int p);
+Tetra *BuildTetra(Face *f, pindex p);
+
+
+/**************************************************************************
+*   star.c								  *
+**************************************************************************/
+
+StarSpace *NewStarSpace(UG *G, StarSpace *S);
+void EraseStarSpace(StarSpace *S);
+long PointStar(pindex p, Point3 *v, pindex n, StarSpace *S);
+pindex StarNeighbours(pindex p, StarSpace *S);
+pindex *ReadQuery(char *filename, pindex n, long *m);
+long WriteStars(pindex *q, long m, Point3 *v, pindex n, UG *G, FILE *fp);
+
+
+/**************************************************************************
+*   locate.c								  *
+**************************************************************************/
+
+Locator *BuildLocator(Store T, Point3 *v, pindex n, UG *G, Locator *L);
+long LocatePoint(Point3 *q, Locator *L, double b[4], unsigned long *state);
+long WriteLocations(Point3 *q, long m, Locator *L, FILE *fp);
+void EraseLocator(Locator *L);
+
+
+/**************************************************************************
+*   check.c								  *
+**************************************************************************/
+
+pindex CheckTetraUG(ShortTetra *t, Point3 *v, UG *G);
+long CheckTriangulation(Store T, Point3 *v, UG *G);
 
 
 /**************************************************************************
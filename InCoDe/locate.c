@@ -0,0 +1,360 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      locate.c                                                   *
+*                                                                          *
+* PURPOSE:      Finding the tetrahedra that contain given points, for      *
+*               interpolating on the triangulation.                        *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*                                                                          *
+* EXPORTS:      BuildLocator        Build the index over the tetrahedra    *
+*               LocatePoint         The tetrahedron of a point             *
+*               WriteLocations      Locate and write many points           *
+*               EraseLocator        Free the index                         *
+*                                                                          *
+*   NOTES:      The index is the adjacency of the tetrahedra and, for each *
+*               cell of the UG used to build them, a tetrahedron incident  *
+*               in a point of the cell (or of a near cell, for the empty   *
+*               ones). A query starts from the tetrahedron of its cell     *
+*               and walks toward the point: at each step the four          *
+*               barycentric coordinates of the point are computed together *
+*               and the walk crosses one of the faces with a negative      *
+*               coordinate, chosen from a random one and never the face    *
+*               it came from (remembering stochastic walk, Devillers,      *
+*               Pion and Teillaud 2002). The walk is short, as the cells.  *
+*               The tetrahedra are convex and their union too, so a walk   *
+*               that must cross a face of the convex hull has found a      *
+*               point outside the triangulation.                           *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/delaunay.h>
+
+#include "graphics.h"
+#include "incode.h"
+
+#define LOCATE_BLOCK 65536	/* Query points located at once 	  */
+
+
+/*
+ * Barycentric
+ *
+ * Le coordinate baricentriche di q nel tetraedro t, tutte e quattro con
+ * due prodotti vettoriali: con r_i = v_i - q, il volume con q al posto di
+ * v_i e' il prodotto misto degli altri tre r, con segno alterno. La somma
+ * e' il volume di t, sei volte, che viene restituito.
+ */
+
+static double Barycentric(ShortTetra *t, Point3 *v, Point3 *q, double b[4])
+{
+ Vector3 r[4], c;
+ double V;
+ int i;
+
+ for(i=0;i<4;i++) V3Sub(&v[t->v[i]],q,&r[i]);
+
+ V3Cross(&r[2],&r[3],&c);
+ b[0]= V3Dot(&r[1],&c);
+ b[1]= -V3Dot(&r[0],&c);
+ V3Cross(&r[0],&r[1],&c);
+ b[2]= V3Dot(&c,&r[3]);
+ b[3]= -V3Dot(&c,&r[2]);
+
+ V=b[0]+b[1]+b[2]+b[3];
+ if(V!=0)
+   for(i=0;i<4;i++) b[i]/=V;
+ return V;
+}
+
+
+/*
+ * Random
+ *
+ * Un generatore congruenziale: ogni punto ha il suo stato, cosi' il
+ * cammino non dipende dal thread che lo fa.
+ */
+
+static int Random(unsigned long *state)
+{
+ *state = (*state*1103515245UL + 12345UL) & 0xffffffffUL;
+ return (int)(*state>>16);
+}
+
+
+/***************************************************************************
+*									   *
+* BuildLocator								   *
+*									   *
+* Build in L the index over the Store T of the tetrahedra of the n points  *
+* v. G is the UG of the points: its cells are the cells of the index. The  *
+* tetrahedra must stay unchanged while L is used.			   *
+* Adj[4*i+k] is the tetrahedron beyond the face of the i-th one opposite   *
+* to its vertex k, -1 on the convex hull; Seed[c] is the first tetrahedron *
+* of the walks that start in the cell c.				   *
+*									   *
+***************************************************************************/
+
+typedef struct AdjJobstruct
+{
+ Locator *L;
+ long *start;			/* Tetrahedra incident in each point:	  */
+ long *inc;			/* inc[start[p]] .. inc[start[p+1]-1]	  */
+} AdjJob;
+
+static void AdjBody(long from, long to, int thread, void *arg)
+{
+ AdjJob *J=(AdjJob *)arg;
+ Store T=J->L->T;
+ ShortTetra *t, *s;
+ pindex a, b, c;
+ long i, j, h;
+ int k, l, found;
+
+ for(i=from;i<to;i++)
+   for(t=(ShortTetra *)StoreElem(i,T),k=0;k<4;k++)
+     {
+      a=t->v[(k+1)&3];
+      b=t->v[(k+2)&3];
+      c=t->v[(k+3)&3];
+      J->L->Adj[4*i+k]= -1;
+      for(j=J->start[a];j<J->start[a+1];j++)
+	{
+	 h=J->inc[j];
+	 if(h==i) continue;
+	 s=(ShortTetra *)StoreElem(h,T);
+	 for(found=0,l=0;l<4;l++) found+=(s->v[l]==b)+(s->v[l]==c);
+	 if(found==2)
+	   {
+	    J->L->Adj[4*i+k]=h;
+	    break;
+	   }
+	}
+     }
+}
+
+Locator *BuildLocator(Store T, Point3 *v, pindex n, UG *G, Locator *L)
+{
+ AdjJob J;
+ ShortTetra *t;
+ pindex i;
+ Plist *P;
+ long c, h, step, nt=CountStore(T), *pos;
+ int j, axis, len;
+
+ L->T=T;
+ L->nt=nt;
+ L->v=v;
+ L->G=G;
+ L->Adj=(long *)malloc((size_t)MAX(4*nt,1)*sizeof(long));
+ L->Seed=(long *)malloc((size_t)G->n*sizeof(long));
+ J.L=L;
+ J.start=(long *)calloc((size_t)n+1,sizeof(long));
+ J.inc=(long *)malloc((size_t)MAX(4*nt,1)*sizeof(long));
+ pos=(long *)malloc((size_t)MAX(n,1)*sizeof(long));
+ if(!L->Adj || !L->Seed || !J.start || !J.inc || !pos)
+   Error("BuildLocator, Not enough memory for the index\n",EXIT);
+
+ for(h=0;h<nt;h++)		/* Tetrahedra incident in each point	  */
+   for(t=(ShortTetra *)StoreElem(h,T),j=0;j<4;j++) J.start[t->v[j]+1]++;
+ for(i=0;i<n;i++) J.start[i+1]+=J.start[i];
+ for(i=0;i<n;i++) pos[i]=J.start[i];
+ for(h=0;h<nt;h++)
+   for(t=(ShortTetra *)StoreElem(h,T),j=0;j<4;j++) J.inc[pos[t->v[j]]++]=h;
+ free(pos);
+
+ ParallelFor(nt, 0, AdjBody, &J);
+
+ for(c=0;c<G->n;c++)		/* A tetrahedron of a point of the cell   */
+   {
+    L->Seed[c]= -1;
+    for(P=G->C[c];P && L->Seed[c]<0;P=P->next)
+      if(J.start[P->p+1]>J.start[P->p]) L->Seed[c]=J.inc[J.start[P->p]];
+   }
+
+ for(axis=0;axis<3;axis++)	/* The empty cells take the seed of a	  */
+   {				/* full one along x, then y, then z	  */
+    step= axis==0 ? 1 : axis==1 ? G->x : (long)G->x*G->y;
+    len = axis==0 ? G->x : axis==1 ? G->y : G->z;
+    for(c=0;c<G->n;c++)
+      if((c/step)%len==0)
+	{
+	 for(j=1;j<len;j++)
+	   if(L->Seed[c+j*step]<0) L->Seed[c+j*step]=L->Seed[c+(j-1)*step];
+	 for(j=len-2;j>=0;j--)
+	   if(L->Seed[c+j*step]<0) L->Seed[c+j*step]=L->Seed[c+(j+1)*step];
+	}
+   }
+
+ free(J.start);
+ free(J.inc);
+ return L;
+}
+
+
+/***************************************************************************
+*									   *
+* LocatePoint								   *
+*									   *
+* Return the tetrahedron of L that contains q, with the barycentric	   *
+* coordinates of q in b, or -1 if q is outside the triangulation. state is *
+* the state of the random choices of the walk.				   *
+* A walk longer than the tetrahedra is looping for numerical errors on a   *
+* flat tetrahedron: then all of them are tested, and the one where the	   *
+* smallest coordinate of q is largest is returned.			   *
+*									   *
+***************************************************************************/
+
+static long ScanLocate(Point3 *q, Locator *L, double b[4])
+{
+ double c[4], low, best= -BIGNUMBER;
+ long i, found= -1;
+ int k;
+
+ for(i=0;i<L->nt;i++)
+   if(Barycentric((ShortTetra *)StoreElem(i,L->T),L->v,q,c)!=0)
+     {
+      for(low=c[0],k=1;k<4;k++) low=MIN(low,c[k]);
+      if(low>best)
+	{
+	 best=low;
+	 found=i;
+	 for(k=0;k<4;k++) b[k]=c[k];
+	}
+     }
+ return best>= -EPSILON ? found : -1;
+}
+
+long LocatePoint(Point3 *q, Locator *L, double b[4], unsigned long *state)
+{
+ UG *G=L->G;
+ long t, prev= -1, next, steps;
+ int x, y, z, k, r;
+
+ if(L->nt==0) return -1;
+
+ x=GridCoord(q->x, G->vn.x, G->side, G->x);
+ y=GridCoord(q->y, G->vn.y, G->side, G->y);
+ z=GridCoord(q->z, G->vn.z, G->side, G->z);
+ t=L->Seed[x + y*G->x + z*G->x*G->y];
+ if(t<0) t=0;
+
+ for(steps=0;steps<=L->nt;steps++)
+   {
+    Barycentric((ShortTetra *)StoreElem(t,L->T),L->v,q,b);
+    r=Random(state);
+    for(k=0;k<4;k++)
+      if(b[(r+k)&3]<0 && (prev<0 || L->Adj[4*t+((r+k)&3)]!=prev)) break;
+    if(k==4) return t;
+
+    next=L->Adj[4*t+((r+k)&3)];
+    if(next<0) return -1;
+    prev=t;
+    t=next;
+   }
+
+ return ScanLocate(q,L,b);
+}
+
+
+/***************************************************************************
+*									   *
+* WriteLocations							   *
+*									   *
+* Write on fp the tetrahedra of L that contain the m points q:		   *
+*									   *
+*	m				number of points		   *
+*	t b0 b1 b2 b3			the tetrahedron of the i-th point  *
+*	...				and its barycentric coordinates    *
+*									   *
+* t is the index of the tetrahedron in the output file, -1 (without the    *
+* coordinates) for a point outside the triangulation. The points are	   *
+* located LOCATE_BLOCK at a time, each block in parallel. Return how many  *
+* are outside.								   *
+*									   *
+***************************************************************************/
+
+typedef struct LocateJobstruct
+{
+ Locator *L;
+ Point3 *q;
+ long first;			/* First point of the current block	  */
+ long *t;
+ double *b;
+} LocateJob;
+
+static void LocateBody(long from, long to, int thread, void *arg)
+{
+ LocateJob *J=(LocateJob *)arg;
+ unsigned long state;
+ long i;
+
+ for(i=from;i<to;i++)
+   {
+    state=(unsigned long)(J->first+i);
+    J->t[i]=LocatePoint(&(J->q[J->first+i]),J->L,J->b+4*i,&state);
+   }
+}
+
+long WriteLocations(Point3 *q, long m, Locator *L, FILE *fp)
+{
+ LocateJob J;
+ long i, len, Outside=0;
+ double *b;
+
+ J.L=L;
+ J.q=q;
+ J.t=(long *)malloc(LOCATE_BLOCK*sizeof(long));
+ J.b=(double *)malloc(4*LOCATE_BLOCK*sizeof(double));
+ if(!J.t || !J.b) Error("WriteLocations, Not enough memory for the points\n",EXIT);
+
+ fprintf(fp,"%ld\n",m);
+ for(J.first=0; J.first<m; J.first+=LOCATE_BLOCK)
+   {
+    len=min(LOCATE_BLOCK,m-J.first);
+    ParallelFor(len, 0, LocateBody, &J);
+    for(i=0;i<len;i++)
+      {
+       b=J.b+4*i;
+       if(J.t[i]<0)
+	 {
+	  fprintf(fp,"-1\n");
+	  Outside++;
+	 }
+       else fprintf(fp,"%ld %.10g %.10g %.10g %.10g\n",J.t[i],b[0],b[1],b[2],b[3]);
+      }
+   }
+
+ free(J.t);
+ free(J.b);
+ return Outside;
+}
+
+
+/***************************************************************************
+*									   *
+* EraseLocator								   *
+*									   *
+* Free the index L, not its tetrahedra, points and UG.			   *
+*									   *
+***************************************************************************/
+
+void EraseLocator(Locator *L)
+{
+ free(L->Adj);
+ free(L->Seed);
+ memset(L,0,sizeof(Locator));
+}
@@ -25,7 +25,12 @@
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
 #include <OList/chronos.h>
+#include <OList/parallel.h>
+#include <OList/tetpack.h>
+#include <OList/serve.h>
+#include <OList/voronoi.h>
 
 #include <ctype.h>
 #include <math.h>
@@ -36,15 +41,32 @@
 #include "graphics.h"
 #include "incode.h"
 
-#define USAGE_MESSAGE "\nUsage: incode [-s[1|2]] [-u nnn] [-p] [-c] [-f|-t] Filein [Fileout]\n\t\
+#define USAGE_MESSAGE "\nUsage: incode [-s[1|2]] [-u nnn|a] [-p] [-c] [-f|-t] [-j nnn] [-v filevor] [-k filevtk] [-a] [-z] [-l filepnt fileloc] [-b box] [-m classes] Filein [Fileout]\n\
+       incode -g filequery [-u nnn|a] [-j nnn] [-b box] [-m classes] Filein [Fileout]\n\
+       incode -d socket\n\t\
  -s\tTurn on statistic informations \n\t\
  -s1\tTurn on only numerical statistical informations \n\t\
  -s2\tAdd a description line to numerical statistical informations\n\t\
  -u nnn\t Set Uniform Grid size = nnn cell\n\t\
+ -u a[o[,e]] Tune the UG size on a sample of the points (default),\n\t\
+\toptionally with o points per cell and cluster exponent e\n\t\
  -p print the number of built tetrahedra while processing\n\t\
  -c\tCheck every tetrahedron is a Delaunay one\n\t\
  -f\tCheck for double creating Face (caused by numerical errors) \n\t\
- -t\tCheck for double creating Tetrahedra (caused by num. errors) \n\
+ -t\tCheck for double creating Tetrahedra (caused by num. errors) \n\t\
+ -j nnn\tUse nnn threads (default one for each processor)\n\t\
+ -v filevor\tWrite the Voronoi diagram on filevor\n\t\
+ -k filevtk\tWrite points and tetrahedra as a VTK unstructured grid\n\t\
+ -a\tAdd face areas and cell volumes to the Voronoi diagram,\n\t\
+\tradius and volume of the tetrahedra to the VTK grid\n\t\
+ -z\tWrite the tetrahedra packed (see tetpack.h)\n\t\
+ -l filepnt fileloc Write on fileloc the tetrahedra containing the points\n\t\
+\tof filepnt and their barycentric coordinates\n\t\
+ -b x0,y0,z0,x1,y1,z1 Load only the points inside the box\n\t\
+ -m c1,c2,... Load only the LAS points of these classes\n\t\
+ -g filequery Write only the Delaunay neighbours of the query points\n\
+\n\t\
+ -d socket Run the command lines sent on the socket (see serve.h)\n\
  "
 
 /***************************************************************************
@@ -58,7 +80,8 @@
 ***************************************************************************/
 
 
-StatInfo SI;			/* Statistic Infomations */
+PARALLEL_LOCAL StatInfo SI;	/* Statistic Infomations, a copy for   */
+				/* each thread answering star queries  */
 
 				/************** Program Flags **************/
 
@@ -67,6 +90,23 @@ boolean CheckFlag	= OFF;	/* Whether checking each built tetrahedron */
 
 boolean StatFlag	= OFF;	/* Whether printing Statistic Infomations. */
 
+char   *VoronoiFile	= NULL; /* Where writing the Voronoi diagram	   */
+
+boolean AreaFlag	= OFF;	/* Whether adding areas and volumes to the */
+				/* Voronoi diagram.			   */
+
+boolean PackFlag	= OFF;	/* Whether writing the tetrahedra packed.  */
+
+char   *VTKFile		= NULL; /* Where writing the VTK grid		   */
+
+char   *LocateFile	= NULL; /* The points to locate in the tetrahedra  */
+char   *LocationFile	= NULL; /* and where writing their tetrahedra	   */
+
+char   *QueryFile	= NULL; /* The points whose neighbours are written */
+				/* instead of the whole triangulation.	   */
+
+PointFilter Filter;		/* Which points of the input are loaded    */
+
 boolean NumStatFlag	= OFF;	/* Whether printing only numerical values  */
 				/* of Statistic Infomations.		   */
 
@@ -74,6 +114,8 @@ boolean NumStatTitleFlag= OFF;	/* Whether add title to previuos Statistics*/
 
 boolean UGSizeFlag	= OFF;	/* Whether UG size is user defined	   */
 int	UGSize		= 1;	/* The UG size user proposed		   */
+double	UGOccupancy	= UG_OCCUPANCY; /* The constants of the UG tuning  */
+double	UGCluster	= UG_CLUSTER;	/* cost model, see incode.h.	   */
 
 boolean UpdateFlag	= OFF;	/* Whether printing the increasing number  */
 				/* of builded tetrahedra while processing. */
@@ -86,40 +128,78 @@ boolean SafeFaceFlag	= OFF;	/* Whether Testing AFL inserted Face to not*/
 boolean SafeTetraFlag	= OFF;	/* Analogous to SafeFaceFlag but check the */
 				/* tetrahedra instead of faces (Faster!)   */
 
+
+				/********* Memory of the running job *******/
+
+static struct
+{
+ Point3 *v;
+ UG	 g;
+ Store	 T;
+ ShortTetra *tv;
+ pindex *q;
+ Point3 *lv;
+ Locator L;
+ FILE	*fp;
+} Job;
+
+
 /***************************************************************************
 *									   *
-* CheckTetra								   *
+* DefaultFlags								   *
 *									   *
-* Test that all the points are out of the sphere circumscribed to	   *
-* tetrahedron t. This test need a O(n) time and is made only on explicit   *
-* user request (-c parameter).						   *
+* Give to the program flags and statistics their initial values, as a new  *
+* process would have them, before a job.				   *
 *									   *
 ***************************************************************************/
 
-void CheckTetra(Tetra *t, Point3 v[], int n)
+static void DefaultFlags(void)
 {
- int i;
- Point3 Center;
- double Radius;
- double d;
-
- if(!CalcSphereCenter(&(v[t->f[0]->v[0]]),
-		      &(v[t->f[0]->v[1]]),
-		      &(v[t->f[0]->v[2]]),
-		      &(v[t->f[1]->v[1]]), &Center ))
-			  Error("CheckTetra, Bad Tetrahedron, CalcSphereCenter Failed!\n",EXIT);
-
- Radius = V3DistanceBetween2Points(&Center,&(v[t->f[0]->v[0]]));
- for(i=0;i<n;i++)
- {
-   d=V3DistanceBetween2Points(&Center,&(v[i]));
-   if( d < Radius - EPSILON)
-     Error("CheckTetra, A not Delaunay Tetrahedron was built!\n",EXIT);
- }
+ CheckFlag=OFF;
+ StatFlag=OFF;
+ VoronoiFile=NULL;
+ AreaFlag=OFF;
+ PackFlag=OFF;
+ VTKFile=NULL;
+ LocateFile=NULL;
+ LocationFile=NULL;
+ QueryFile=NULL;
+ InitFilter(&Filter);
+ NumStatFlag=OFF;
+ NumStatTitleFlag=OFF;
+ UGSizeFlag=OFF;
+ UGSize=1;
+ UGOccupancy=UG_OCCUPANCY;
+ UGCluster=UG_CLUSTER;
+ UpdateFlag=OFF;
+ SafeFaceFlag=OFF;
+ SafeTetraFlag=OFF;
+ SetThreadNum(0);
+ memset(&SI,0,sizeof(SI));
 }
 
 
+/***************************************************************************
+*									   *
+* EndJob								   *
+*									   *
+* Free the memory and close the output of a job; called at its end and,    *
+* for a job ended by an error, before the next one.			   *
+*									   *
+***************************************************************************/
 
+static void EndJob(void)
+{
+ if(Job.v) free(Job.v);
+ if(Job.g.C) EraseUG(&Job.g);
+ if(Job.T) EraseStore(Job.T);
+ if(Job.tv) free(Job.tv);
+ if(Job.q) free(Job.q);
+ if(Job.lv) free(Job.lv);
+ if(Job.L.Adj) EraseLocator(&Job.L);
+ if(Job.fp && Job.fp!=stdout) fclose(Job.fp);
+ memset(&Job,0,sizeof(Job));
+}
 
 /***************************************************************************
 *									   *
@@ -130,7 +210,7 @@ void CheckTetra(Tetra *t, Point3 v[], int n)
 *									   *
 ***************************************************************************/
 
-Tetra *BuildTetra(Face *f, int p)
+Tetra *BuildTetra(Face *f, pindex p)
 {
  Tetra *t;
  Face *f0, *f1,*f2,*f3;
@@ -178,16 +258,16 @@ Tetra *BuildTetra(Face *f, int p)
 *									   *
 ***************************************************************************/
 
-Tetra *MakeTetra(Face *f,Point3 *v,int n)
+Tetra *MakeTetra(Face *f,Point3 *v,pindex n)
 {
  Plane p,Mp;
  boolean found=FALSE;
  double Radius=BIGNUMBER,  rad;
  Line Lc;
- int pind=0;
+ pindex pind=0;
  Tetra *t;
  Point3 Center, c;
- int i;
+ pindex i;
 
  if(!CalcPlane(&(v[f->v[0]]),&(v[f->v[1]]),&(v[f->v[2]]),&p))
 		Error("MakeTetra, Face with collinar vertices!\n",EXIT);
@@ -223,8 +303,6 @@ Tetra *MakeTetra(Face *f,Point3 *v,int n)
 
  t=BuildTetra(f,pind);
 
- if(CheckFlag)  CheckTetra(t,v,n);
-
  return t;
 }
 
@@ -236,9 +314,9 @@ Tetra *MakeTetra(Face *f,Point3 *v,int n)
 *									   *
 ***************************************************************************/
 
-Tetra *FirstTetra(Point3 *v, int n)
+Tetra *FirstTetra(Point3 *v, pindex n)
 {
- int i, MinIndex=0;
+ pindex i, MinIndex=0;
  double Radius, MinRadius=BIGNUMBER;
 
  Tetra *t;
@@ -322,8 +400,6 @@ Tetra *FirstTetra(Point3 *v, int n)
 
  t=BuildTetra(&f, MinIndex);
 
- CheckTetra(t,v,n);
-
  ReverseFace(t->f[0]); /* First Face in first Tetra   */
 		       /* must be outward oriented    */
  return t;
@@ -352,21 +428,17 @@ Tetra *FirstTetra(Point3 *v, int n)
 *									   *
 ***************************************************************************/
 
-List InCoDe(Point3 *v, int n)
+Store InCoDe(Point3 *v, pindex n, UG *g)
 {
- List Q=NULL_LIST;
- List T=NULL_LIST;
+ AFL Q;
+ Store T;
  List OldFace=NULL_LIST;
 
  Tetra *t;
- ShortTetra *st;
- Face  *f;
- int i,j;
- UG g;
- 
- Q=NewList(FIFO,sizeof(Face));			/* Initialize Active Face */
- ChangeEqualObjectList(EqualFace,Q);		/* List Q.		  */
- HashList(n/4,HashFace,Q);
+ ShortTetra st;
+ Face  *f, *old;
+ pindex i;
+ int j;
 
  if(SafeFaceFlag)
    {						/* Initialize list for	  */
@@ -375,69 +447,75 @@ List InCoDe(Point3 *v, int n)
     HashList(n/4,HashFace,OldFace);		/* errors		  */
    }
 
- T=NewList(FIFO,sizeof(ShortTetra));		/* Initialize Built Tetra-*/
- ChangeEqualObjectList(EqualTetra,T);		/* hedra List T.	  */
- if(SafeTetraFlag) HashList(n/4,HashTetra,T);
+ T=NewStore(sizeof(ShortTetra));		/* Initialize Built Tetra-*/
+ if(SafeTetraFlag)				/* hedra Store T.	  */
+   HashStore((long)n*TETRA_PER_POINT,HashTetra,EqualTetra,T);
+
 
+ if(UGSizeFlag) BuildUG(v,n,UGSize,g);	/* Initialize Uniform Grid */
+	   else BuildUG(v,n,TuneUG(v,n),g);
 
- if(UGSizeFlag) BuildUG(v,n,UGSize,&g); 	/* Initialize Uniform Grid */
-	   else BuildUG(v,n,n	  ,&g);
+ NewAFL(v,g,&Q);				/* Initialize Active Face */
+						/* List Q on the UG.	  */
 
  t=FirstTetra(v,n);
 
  for(i=0;i<4;i++)
   {
-   InsertList(t->f[i],Q);
+   InsertAFL(t->f[i],&Q);
    if(SafeFaceFlag)  InsertList(t->f[i],OldFace);
    for(j=0;j<3;j++)
-     if(g.UsedPoint[t->f[i]->v[j]]==-1) 
-       g.UsedPoint[t->f[i]->v[j]]=1;
+     if(g->UsedPoint[t->f[i]->v[j]]==-1) 
+       g->UsedPoint[t->f[i]->v[j]]=1;
      else 
-       g.UsedPoint[t->f[i]->v[j]]++; 
+       g->UsedPoint[t->f[i]->v[j]]++; 
  }
 
  SI.Face=4;
 
- st=Tetra2ShortTetra(t);
+ Tetra2ShortTetra(t,&st);
+ i=st.v[0];		/* FirstTetra reversed t->f[0], swap two vertices */
+ st.v[0]=st.v[1];	/* to give st the same orientation of the other   */
+ st.v[1]=i;		/* tetrahedra.					  */
 
  free(t);
 
- InsertList(st,T);
+ AppendStore(&st,T);
 
- while(ExtractList(&f,Q))
+ while(ExtractAFL(&f,&Q))
    {
-     t=FastMakeTetra(f,v,n,&g);
+     t=FastMakeTetra(f,v,n,g);
      
      if(t==NULL) SI.CHFace++;
      else
        {
-	 st=Tetra2ShortTetra(t);
+	 Tetra2ShortTetra(t,&st);
 	 
-	 if(SafeTetraFlag) if(MemberList(st, T))
+	 if(SafeTetraFlag) if(MemberStore(&st, T))
 	   Error("Cyclic Tetrahedra Creation\n",EXIT);
-	 InsertList(st,T);
+	 AppendStore(&st,T);
 	 
 	 if(UpdateFlag)
-	   if(++SI.Tetra%50 == 0) printf("Tetrahedra Built %i\r",SI.Tetra++);
+	   if(++SI.Tetra%50 == 0) printf("Tetrahedra Built %ld\r",SI.Tetra++);
 	 
 	 for(i=1;i<4;i++)
-	   if(MemberList(t->f[i],Q))
+	   if((old=DeleteAFL(t->f[i],&Q)))
 	     {
-	       DeleteCurrList(Q);
-	       free(t->f[i]);
 	       
 	       for(j=0;j<3;j++)
-		 g.UsedPoint[t->f[i]->v[j]]--;
+		 g->UsedPoint[t->f[i]->v[j]]--;
+	       free(t->f[i]);
+	       if(!SafeFaceFlag) free(old);
 	     }
 	   else
 	     {
-	       InsertList(t->f[i],Q);
+	       InsertAFL(t->f[i],&Q);
 	       SI.Face++;
 	       
 	       for(j=0;j<3;j++)
-		 if(g.UsedPoint[t->f[i]->v[j]]==-1) 
-		   g.UsedPoint[t->f[i]->v[j]]=1;
-		 else g.UsedPoint[t->f[i]->v[j]]++;
+		 if(g->UsedPoint[t->f[i]->v[j]]==-1) 
+		   g->UsedPoint[t->f[i]->v[j]]=1;
+		 else g->UsedPoint[t->f[i]->v[j]]++;
 		   
 	       if(SafeFaceFlag)
 		 {
@@ -451,36 +529,112 @@ List InCoDe(Point3 *v, int n)
        }
      for(i=0;i<3;i++)                   
        {
-	 g.UsedPoint[f->v[i]]--;
-	/*  if(g.UsedPoint[f->v[i]]==0) printf("Point %i completed\n",f->v[i]);*/
+	 g->UsedPoint[f->v[i]]--;
+	/*  if(g->UsedPoint[f->v[i]]==0) printf("Point %i completed\n",f->v[i]);*/
        }
      if(!SafeFaceFlag) free(f);
    }
- 
+ EraseAFL(&Q);
+ if(SafeFaceFlag)
+   {
+    while(ExtractList(&f,OldFace)) free(f);
+    EraseList(OldFace);
+   }
 
  return T;
 }
 
 /***************************************************************************
 *									   *
-* main									   *
+* QueryStars								   *
 *									   *
-* Do the usual command line parsing, file I/O and timing matters.	   *
+* The query mode: build the UG of the n points v and write on fp the	   *
+* Delaunay neighbours of the points in QueryFile, each from its own star,  *
+* without triangulating the other points.				   *
 *									   *
 ***************************************************************************/
 
+static int QueryStars(Point3 *v, pindex n, FILE *fp)
+{
+ UG *g=&Job.g;
+ long m, Failed;
+
+ Job.q=ReadQuery(QueryFile,n,&m);
 
+ ResetChronos(USER_CHRONOS);
+ StartChronos(USER_CHRONOS);
+ if(UGSizeFlag) BuildUG(v,n,UGSize,g);
+	   else BuildUG(v,n,TuneUG(v,n),g);
+ Failed=WriteStars(Job.q,m,v,n,g,fp);
+ StopChronos(USER_CHRONOS);
 
-main(int argc, char *argv[])
+ SI.Secs=ReadChronos(USER_CHRONOS);
+ printf("Points:%7" IDX " Queries:%7ld Secs:%6.2f\n",n,m,SI.Secs);
+ if(Failed)
+   Errorf(NO_EXIT,"%ld of %ld query points have no tetrahedra\n",Failed,m);
+
+ EndJob();
+ return 0;
+}
+
+
+/***************************************************************************
+*									   *
+* LocatePoints								   *
+*									   *
+* Index the tetrahedra T of the n points v, built on the UG g, and	   *
+* write on LocationFile the tetrahedra containing the points of 	   *
+* LocateFile.								   *
+*									   *
+***************************************************************************/
+
+static void LocatePoints(Store T, Point3 *v, pindex n, UG *g)
 {
- char buf[80];
+ PointFilter All;
+ FILE *lfp;
+ pindex m;
+ long Outside;
+
+ InitFilter(&All);
+ Job.lv=ReadPoints(LocateFile,&All,&m);
+ lfp=fopen(LocationFile,"w");
+ if(!lfp) Error("Unable to open location output file\n",EXIT);
+
+ ResetChronos(USER_CHRONOS);
+ StartChronos(USER_CHRONOS);
+ BuildLocator(T,v,n,g,&Job.L);
+ Outside=WriteLocations(Job.lv,(long)m,&Job.L,lfp);
+ StopChronos(USER_CHRONOS);
+ fclose(lfp);
+
+ printf("Located:%7" IDX " Secs:%6.2f Outside:%7ld\n",m,ReadChronos(USER_CHRONOS),Outside);
+}
+
+
+/***************************************************************************
+*									   *
+* Triangulate								   *
+*									   *
+* Do the usual command line parsing, file I/O and timing matters; the	   *
+* whole program for a command line, or a job of the server.		   *
+*									   *
+***************************************************************************/
+
+static int Triangulate(int argc, char *argv[])
+{
+ char buf[80], *s;
  Point3 *v;
- List   T=NULL_LIST;
- int n,i=1;
- FILE *fp=stdout;
+ Store  T;
+ UG *g=&Job.g;
+ pindex n,i=1;
+ long bad=0;
+ FILE *fp=stdout, *vfp;
+ ShortTetra *tv;
+ long nt;
  double sec;
 
- SetProgramName("InCoDe");
+ EndJob();
+ DefaultFlags();
 
  if((argc<2) ||
     (strcmp(argv[i],"/?")==0)||
@@ -488,7 +642,7 @@ main(int argc, char *argv[])
     (strcmp(argv[i],"/h")==0)||
     (strcmp(argv[i],"-h")==0)  ) Error(USAGE_MESSAGE, EXIT);
 
-  while(*argv[i]=='-')
+  while(i<argc && *argv[i]=='-')
    {
     switch(argv[i][1])
       {
@@ -505,10 +659,51 @@ main(int argc, char *argv[])
 				}
 		  break;
 
-       case 'u' : UGSizeFlag=ON;
-		  if(argv[i][2]==0 && isdigit(argv[i+1][0]))
-			 UGSize=atoi(argv[++i]);
-		    else UGSize=atoi(argv[i]+2);
+       case 'u' : if(argv[i][2]==0 && argv[i+1] && strchr("0123456789a",argv[i+1][0]))
+			 s=argv[++i];
+		    else s=argv[i]+2;
+		  if(*s=='a')
+		    {
+		     if(s[1]) sscanf(s+1,"%lf,%lf",&UGOccupancy,&UGCluster);
+		    }
+		  else
+		    {
+		     UGSizeFlag=ON;
+		     UGSize=atoi(s);
+		    }
+		  break;
+
+       case 'a' : AreaFlag=ON;				break;
+       case 'z' : PackFlag=ON;				break;
+       case 'k' : if(argv[i][2]==0) VTKFile=argv[++i];
+		    else VTKFile=argv[i]+2;
+		  break;
+
+       case 'b' : if(!SetFilterBox(&Filter,argv[i][2]==0 ? argv[++i] : argv[i]+2))
+		    Error("Wrong box, give -b xmin,ymin,zmin,xmax,ymax,zmax\n",EXIT);
+		  break;
+       case 'm' : if(!SetFilterClass(&Filter,argv[i][2]==0 ? argv[++i] : argv[i]+2))
+		    Error("Wrong classes, give -m c1,c2,...\n",EXIT);
+		  break;
+
+       case 'l' : if(argv[i][2]==0) LocateFile=argv[++i];
+		    else LocateFile=argv[i]+2;
+		  if(LocateFile) LocationFile=argv[++i];
+		  if(!LocateFile || !LocationFile)
+		    Error("Give the points to locate and the output, -l filepnt fileloc\n",EXIT);
+		  break;
+
+       case 'g' : if(argv[i][2]==0) QueryFile=argv[++i];
+		    else QueryFile=argv[i]+2;
+		  break;
+
+       case 'v' : if(argv[i][2]==0) VoronoiFile=argv[++i];
+		    else VoronoiFile=argv[i]+2;
+		  break;
+
+       case 'j' : if(argv[i][2]==0 && argv[i+1] && isdigit(argv[i+1][0]))
+			 SetThreadNum(atoi(argv[++i]));
+		    else SetThreadNum(atoi(argv[i]+2));
 		  break;
 
        default	: sprintf(buf,"Unknown options '%s'\n",argv[i]);
@@ -516,19 +711,23 @@ main(int argc, char *argv[])
       }
     i++;
     }
+ if(i>=argc) Error(USAGE_MESSAGE, EXIT);
 
- v=ReadPoints(argv[i++],&n);
+ Job.v=v=ReadPoints(argv[i++],&Filter,&n);
 
- if(argc>i) fp=fopen(argv[i],"w");
+ if(argc>i) Job.fp=fp=fopen(argv[i],PackFlag ? "wb" : "w");
+ if(!fp) Error("Unable to open output file\n",EXIT);
+
+ if(QueryFile) return QueryStars(v,n,fp);
 
  SI.Point=n;
 
  ResetChronos(USER_CHRONOS);
  StartChronos(USER_CHRONOS);
- T=InCoDe(v,n);
+ Job.T=T=InCoDe(v,n,g);
  StopChronos(USER_CHRONOS);
 
- SI.Tetra=CountList(T);
+ SI.Tetra=CountStore(T);
  
  sec=ReadChronos(USER_CHRONOS);
 
@@ -538,9 +737,67 @@ main(int argc, char *argv[])
  if(StatFlag && NumStatFlag && NumStatTitleFlag) PrintNumStatTitle();
  if(StatFlag && NumStatFlag) PrintNumStat();
  if(!StatFlag)
-     printf("Points:%7i Secs:%6.2f Tetras:%7i\n",SI.Point,SI.Secs,SI.Tetra);
+     printf("Points:%7" IDX " Secs:%6.2f Tetras:%7ld\n",SI.Point,SI.Secs,SI.Tetra);
 
- WriteTetraList(T,fp);
+ if(CheckFlag)
+   {
+    bad=CheckTriangulation(T,v,g);
+    if(bad) Errorf(NO_EXIT,"%ld of %ld tetrahedra are not Delaunay!\n",bad,SI.Tetra);
+       else printf("Checked %ld tetrahedra, all Delaunay.\n",SI.Tetra);
+   }
 
- return 0;
+ if(VTKFile)
+   {
+    vfp=fopen(VTKFile,"wb");
+    if(!vfp) Error("Unable to open VTK output file\n",EXIT);
+    WriteVTK(T,v,sizeof(Point3),n,AreaFlag,vfp);
+    fclose(vfp);
+   }
+
+ if(PackFlag)
+   {
+    nt=CountStore(T);
+    Job.tv=tv=(ShortTetra *)Store2Vector(T);	/* Held twice for a moment */
+    Job.T=NULL;
+    WriteTetPack(tv[0].v,nt,n,fp);		/* Sorts tv		  */
+    if(VoronoiFile || LocateFile)
+      {
+       Job.T=T=Vector2Store(tv,nt,sizeof(ShortTetra));	/* Packed order */
+       Job.tv=NULL;
+       if(!T) Error("Unable to allocate memory for Tetrahedra\n",EXIT);
+      }
+   }
+ else WriteTetraStore(T,fp);
+
+ if(VoronoiFile)
+   {
+    vfp=fopen(VoronoiFile,"w");
+    if(!vfp) Error("Unable to open Voronoi output file\n",EXIT);
+    WriteVoronoi(T,v,sizeof(Point3),n,AreaFlag,vfp);
+    fclose(vfp);
+   }
+ if(LocateFile) LocatePoints(T,v,n,g);
+
+ EndJob();
+ return bad ? 1 : 0;
+}
+
+
+/***************************************************************************
+*									   *
+* main									   *
+*									   *
+* Triangulate the command line, or serve the jobs sent on a socket.	   *
+*									   *
+***************************************************************************/
+
+main(int argc, char *argv[])
+{
+ SetProgramName("InCoDe");
+ if(argc==3 && strcmp(argv[1],"-d")==0)
+   {
+    ServeJobs(argv[2],argv[0],Triangulate);
+    return 0;
+   }
+ return Triangulate(argc,argv);
 }
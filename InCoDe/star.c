@@ -0,0 +1,567 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      star.c                                                     *
+*                                                                          *
+* PURPOSE:      Delaunay tetrahedra and neighbours of single points,       *
+*               without the whole triangulation.                           *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               FastMakeTetra                                              *
+*                                                                          *
+* EXPORTS:      NewStarSpace        Prepare the workspace of a thread      *
+*               EraseStarSpace      Free it                                *
+*               PointStar           Build the tetrahedra around a point    *
+*               StarNeighbours      The Delaunay neighbours of a point     *
+*               ReadQuery           Read the indices of the query points   *
+*               WriteStars          Write the neighbours of query points   *
+*                                                                          *
+*   NOTES:      The star of p, the tetrahedra incident in p, is built as   *
+*               InCoDe builds the whole triangulation, but only from the   *
+*               faces that contain p. The first face is p, its nearest     *
+*               point q (pq is a Delaunay edge) and the point r met first  *
+*               by a sphere through p and q grown from the middle of pq:   *
+*               that sphere is empty, so pqr is a Delaunay face. Both are  *
+*               found scanning the UG cells in rings around p, so a query  *
+*               costs the points near p, not the size of the dataset.      *
+*               The UG must be built but not used by InCoDe: its points    *
+*               must have UsedPoint -1 (see FastMakeTetra).                *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/numfile.h>
+#include <OList/delaunay.h>
+
+#include "graphics.h"
+#include "incode.h"
+
+#define STAR_BLOCK 4096 	/* Query points answered at once	  */
+
+
+/***************************************************************************
+*									   *
+* RingSearch								   *
+*									   *
+* A search of the UG cells in rings of growing distance from the cell of   *
+* p. The visit of a cell updates Found and Bound: no point farther than    *
+* Bound from p can improve Found, so the search stops when the next ring   *
+* is farther.								   *
+*									   *
+***************************************************************************/
+
+typedef struct RingSearchstruct
+{
+ Point3 *v;
+ pindex p, q;			/* The point and its nearest one	  */
+ Point3 m;			/* The middle of pq and the direction	  */
+ Vector3 u;			/* where the sphere grows		  */
+ double pm2;			/* |m-p|^2				  */
+ double Best;			/* Squared distance or center offset of   */
+ pindex Found;			/* the best point found, -1 if none	  */
+ double Bound;
+} RingSearch;
+
+typedef void (*CellVisit)(Plist *P, RingSearch *R);
+
+
+/*
+ * ScanRing
+ *
+ * Visita le celle a distanza k (in celle) dalla cella c, cioe' il bordo
+ * del cubo di lato 2k+1 centrato in c.
+ */
+
+static void ScanRing(UG *G, IntPoint3 *c, int k, CellVisit visit, RingSearch *R)
+{
+ int x, y, z, step;
+
+ for(z=c->z-k;z<=c->z+k;z++)
+   if(z>=0 && z<G->z)
+     for(y=c->y-k;y<=c->y+k;y++)
+       if(y>=0 && y<G->y)
+	 {
+	  step=(z==c->z-k || z==c->z+k || y==c->y-k || y==c->y+k) ? 1 : 2*k;
+	  for(x=c->x-k;x<=c->x+k;x+=step)
+	    if(x>=0 && x<G->x)
+	      visit(G->C[x + y*G->x + z*G->x*G->y],R);
+	 }
+}
+
+
+/*
+ * SearchRings
+ *
+ * Visita gli anelli attorno alla cella di p finche' possono contenere
+ * punti entro R->Bound da p: i punti dell'anello k distano almeno
+ * (k-1)*side.
+ */
+
+static void SearchRings(UG *G, CellVisit visit, RingSearch *R)
+{
+ IntPoint3 c;
+ Point3 *p=&(R->v[R->p]);
+ int k, last;
+
+ c.x=GridCoord(p->x, G->vn.x, G->side, G->x);
+ c.y=GridCoord(p->y, G->vn.y, G->side, G->y);
+ c.z=GridCoord(p->z, G->vn.z, G->side, G->z);
+ last=MAX(G->x,MAX(G->y,G->z));
+
+ R->Found= -1;
+ R->Best=R->Bound=BIGNUMBER;
+ for(k=0;k<=last && (k==0 || (k-1)*G->side<=R->Bound);k++)
+   ScanRing(G,&c,k,visit,R);
+}
+
+
+/*
+ * NearVisit
+ *
+ * Il punto della cella piu' vicino a p.
+ */
+
+static void NearVisit(Plist *P, RingSearch *R)
+{
+ double d;
+
+ for(;P;P=P->next)
+   if(P->p!=R->p)
+     {
+      d=V3SquaredDistanceBetween2Points(&(R->v[P->p]),&(R->v[R->p]));
+      if(d<R->Best)
+	{
+	 R->Best=d;
+	 R->Found=P->p;
+	 R->Bound=sqrt(d);
+	}
+     }
+}
+
+
+/*
+ * SphereVisit
+ *
+ * La sfera per p e q di centro m+s*u passa per x quando
+ * s = (|x-m|^2 - |p-m|^2) / (2 u.(x-m)): il punto della cella con s minimo
+ * fra quelli dalla parte di u. La sfera trovata sta entro 2R da p.
+ */
+
+static void SphereVisit(Plist *P, RingSearch *R)
+{
+ Vector3 d;
+ double a, s;
+
+ for(;P;P=P->next)
+   if(P->p!=R->p && P->p!=R->q)
+     {
+      V3Sub(&(R->v[P->p]),&(R->m),&d);
+      a=V3Dot(&(R->u),&d);
+      if(a<=EPSILON*sqrt(R->pm2)) continue;
+      s=(V3Dot(&d,&d)-R->pm2)/(2*a);
+      if(s<R->Best)
+	{
+	 R->Best=s;
+	 R->Found=P->p;
+	 R->Bound=2*sqrt(R->pm2+s*s);
+	}
+     }
+}
+
+
+/*
+ * SeedFace
+ *
+ * La prima faccia della stella di p, FALSE se p non ha vicini o i punti
+ * vicini sono allineati. La sfera cresce prima verso il centro della UG,
+ * dove per un punto del bordo ci sono gli altri punti.
+ */
+
+static boolean SeedFace(pindex p, Point3 *v, UG *G, Face *f)
+{
+ RingSearch R;
+ Vector3 pq, w, dir[4];
+ int i;
+
+ R.v=v;
+ R.p=p;
+ SearchRings(G,NearVisit,&R);
+ if(R.Found<0 || R.Best==0) return FALSE;
+ R.q=R.Found;
+
+ V3Sub(&v[R.q],&v[p],&pq);
+ R.m.x=(v[p].x+v[R.q].x)/2;
+ R.m.y=(v[p].y+v[R.q].y)/2;
+ R.m.z=(v[p].z+v[R.q].z)/2;
+ R.pm2=V3SquaredDistanceBetween2Points(&(R.m),&v[p]);
+
+ V3Sub(&(G->o),&(R.m),&w);
+ V3Cross(&pq,&w,&dir[2]);
+ if(V3Length(&dir[2])<=EPSILON*V3Length(&pq)*V3Length(&w))
+   {
+    w.x=w.y=w.z=0;			/* The axis farthest from pq */
+    if(fabs(pq.x)<=fabs(pq.y) && fabs(pq.x)<=fabs(pq.z)) w.x=1;
+    else if(fabs(pq.y)<=fabs(pq.z)) w.y=1;
+    else w.z=1;
+    V3Cross(&pq,&w,&dir[2]);
+   }
+ V3Normalize(&dir[2]);
+ V3Cross(&dir[2],&pq,&dir[0]);	/* dir[0] is w without its part along pq */
+ V3Normalize(&dir[0]);
+ dir[1]=dir[0];
+ V3Negate(&dir[1]);
+ dir[3]=dir[2];
+ V3Negate(&dir[3]);
+
+ for(i=0;i<4;i++)
+   {
+    R.u=dir[i];
+    SearchRings(G,SphereVisit,&R);
+    if(R.Found>=0) break;
+   }
+ if(R.Found<0) return FALSE;
+
+ f->v[0]=p;
+ f->v[1]=R.q;
+ f->v[2]=R.Found;
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* NewStarSpace, EraseStarSpace						   *
+*									   *
+* Prepare in S the workspace of a thread for the stars of the points of G: *
+* a copy of G with its own cell marks, the list of the open faces and the  *
+* tetrahedra of the current star. EraseStarSpace frees it, not G.	   *
+* NewStarSpace must not run inside a parallel loop: HashList uses the	   *
+* global stack of the current elements of listscan.c.			   *
+*									   *
+***************************************************************************/
+
+StarSpace *NewStarSpace(UG *G, StarSpace *S)
+{
+ memset(S,0,sizeof(StarSpace));
+ S->G=*G;
+ S->G.Marked=(int *)calloc((size_t)G->n,sizeof(int));
+ S->G.Mark=0;
+ S->Q=NewList(FIFO,sizeof(Face));
+ if(!S->G.Marked || !S->Q)
+   Error("NewStarSpace, Not enough memory for a star\n",EXIT);
+ ChangeEqualObjectList(EqualFace,S->Q);
+ HashList(STAR_HASH,HashFace,S->Q);
+ return S;
+}
+
+void EraseStarSpace(StarSpace *S)
+{
+ Face *f;
+
+ if(!S->Q) return;
+ while(ExtractList(&f,S->Q)) free(f);
+ EraseList(S->Q);
+ free(S->G.Marked);
+ free(S->t);
+ free(S->nb);
+ memset(S,0,sizeof(StarSpace));
+}
+
+
+/*
+ * OpenStarFace
+ *
+ * Come in InCoDe: una faccia di p gia' aperta ha ora i tetraedri da tutte
+ * e due le parti ed e' chiusa, altrimenti resta aperta. Le facce senza p
+ * non servono.
+ */
+
+static void OpenStarFace(Face *f, pindex p, StarSpace *S)
+{
+ Face *old;
+
+ if(f->v[0]!=p && f->v[1]!=p && f->v[2]!=p) free(f);
+ else if((old=(Face *)ToggleFace(f,S->Q)))
+   {
+    free(old);
+    free(f);
+   }
+}
+
+
+/*
+ * AddStarTetra
+ *
+ * Aggiunge t alla stella e ne apre le facce; FALSE se t c'era gia', cosa
+ * che per errori numerici farebbe girare la stella senza fine.
+ */
+
+static boolean AddStarTetra(Tetra *t, pindex p, StarSpace *S)
+{
+ ShortTetra st;
+ long i;
+ int k;
+
+ Tetra2ShortTetra(t,&st);
+ for(i=0;i<S->nt;i++)
+   if(EqualTetra(&st,&(S->t[i])))
+     {
+      for(k=0;k<4;k++) free(t->f[k]);
+      free(t);
+      return FALSE;
+     }
+
+ if(S->nt==S->Size)
+   {
+    S->Size=MAX(2*S->Size,64);
+    S->t=(ShortTetra *)realloc(S->t,(size_t)S->Size*sizeof(ShortTetra));
+    if(!S->t) Error("PointStar, Not enough memory for a star\n",EXIT);
+   }
+ S->t[S->nt++]=st;
+
+ for(k=1;k<4;k++) OpenStarFace(t->f[k],p,S);
+ free(t->f[0]);
+ free(t);
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* PointStar								   *
+*									   *
+* Build in S->t the Delaunay tetrahedra of the n points v incident in p,   *
+* with S prepared by NewStarSpace on the UG of v. Return how many they	   *
+* are, 0 if p has no tetrahedra (less than four points, all coplanar, or   *
+* p repeated) or the star does not close for numerical errors.		   *
+*									   *
+***************************************************************************/
+
+long PointStar(pindex p, Point3 *v, pindex n, StarSpace *S)
+{
+ Face *f, seed;
+ Tetra *t;
+ boolean ok=TRUE;
+ int side;
+
+ S->nt=0;
+ if(n<4 || !SeedFace(p,v,&(S->G),&seed)) return 0;
+
+ for(side=0;side<2 && ok;side++)
+   {
+    if(side) ReverseFace(&seed);
+    t=FastMakeTetra(&seed,v,n,&(S->G));
+    if(t) ok=AddStarTetra(t,p,S);
+   }
+
+ while(ok && ExtractList(&f,S->Q))
+   {
+    t=FastMakeTetra(f,v,n,&(S->G));
+    if(t) ok=AddStarTetra(t,p,S);
+    free(f);
+   }
+
+ if(!ok)
+   {
+    while(ExtractList(&f,S->Q)) free(f);
+    S->nt=0;
+   }
+ return S->nt;
+}
+
+
+/***************************************************************************
+*									   *
+* StarNeighbours							   *
+*									   *
+* Write in S->nb the Delaunay neighbours of p, the other vertices of the   *
+* S->nt tetrahedra of its star, sorted and each once. Return how many.	   *
+*									   *
+***************************************************************************/
+
+static int CompareIndex(const void *a, const void *b)
+{
+ pindex i=*(pindex *)a, j=*(pindex *)b;
+
+ return (i>j)-(i<j);
+}
+
+pindex StarNeighbours(pindex p, StarSpace *S)
+{
+ long i, k=0;
+ pindex m=0;
+ int j;
+
+ if(3*S->nt>S->NbSize)
+   {
+    S->NbSize=MAX(3*S->nt,2*S->NbSize);
+    S->nb=(pindex *)realloc(S->nb,(size_t)S->NbSize*sizeof(pindex));
+    if(!S->nb) Error("StarNeighbours, Not enough memory for the neighbours\n",EXIT);
+   }
+
+ for(i=0;i<S->nt;i++)
+   for(j=0;j<4;j++)
+     if(S->t[i].v[j]!=p) S->nb[k++]=S->t[i].v[j];
+ qsort(S->nb,(size_t)k,sizeof(pindex),CompareIndex);
+
+ for(i=0;i<k;i++)
+   if(m==0 || S->nb[i]!=S->nb[m-1]) S->nb[m++]=S->nb[i];
+ return m;
+}
+
+
+/***************************************************************************
+*									   *
+* ReadQuery								   *
+*									   *
+* Read the query file, the number of points and then their indices:	   *
+*									   *
+*      m								   *
+*      p_1 p_2 ... p_m							   *
+*									   *
+* Each index must be one of the n points. Return the m indices.	   *
+*									   *
+***************************************************************************/
+
+pindex *ReadQuery(char *filename, pindex n, long *m)
+{
+ NumFile F;
+ pindex *q;
+ long i, p;
+
+ if(!OpenNumFile(filename,&F)) Error("ReadQuery, Unable to open query file.\n",EXIT);
+ if(!ReadLong(&F,m) || *m<0)
+   Errorf(EXIT,"ReadQuery, %s is not a query file.\n",filename);
+
+ q=(pindex *)malloc((size_t)MAX(*m,1)*sizeof(pindex));
+ if(!q) Error("ReadQuery, Not enough memory for the queries.\n",EXIT);
+
+ for(i=0;i<*m;i++)
+   {
+    if(!ReadLong(&F,&p))
+      Errorf(EXIT,"ReadQuery, %s truncated at query %ld.\n",filename,i);
+    if(p<0 || p>=n)
+      Errorf(EXIT,"ReadQuery, query %ld is point %ld, out of 0..%" IDX ".\n",i,p,n-1);
+    q[i]=(pindex)p;
+   }
+ CloseNumFile(&F);
+ return q;
+}
+
+
+/***************************************************************************
+*									   *
+* WriteStars								   *
+*									   *
+* Write on fp the Delaunay neighbours of the m query points q of the UG G  *
+* of the n points v:							   *
+*									   *
+*	m				number of queries		   *
+*	p k n1 ... nk			the k neighbours of the point p    *
+*	...								   *
+*									   *
+* in the order of the queries, k=0 when PointStar fails. The queries are   *
+* answered STAR_BLOCK at a time, each block in parallel. Return how many   *
+* queries failed.							   *
+*									   *
+***************************************************************************/
+
+typedef struct StarJobstruct
+{
+ pindex *q;
+ Point3 *v;
+ pindex n;
+ UG *G;
+ long first;			/* First query of the current block	  */
+ pindex *Count; 		/* The neighbours of each query of the	  */
+ long *Start;			/* block, from Start in the buffer of its */
+ int *Thread;			/* thread				  */
+ pindex *Buf[MAX_THREADS];
+ long Len[MAX_THREADS], Size[MAX_THREADS];
+ StarSpace S[MAX_THREADS];
+} StarJob;
+
+static void StarBody(long from, long to, int thread, void *arg)
+{
+ StarJob *J=(StarJob *)arg;
+ StarSpace *S=&(J->S[thread]);
+ pindex p, k;
+ long i;
+
+ for(i=from;i<to;i++)
+   {
+    p=J->q[J->first+i];
+    k=PointStar(p,J->v,J->n,S) ? StarNeighbours(p,S) : 0;
+    if(J->Len[thread]+k>J->Size[thread])
+      {
+       J->Size[thread]=MAX(J->Len[thread]+k,2*J->Size[thread]);
+       J->Buf[thread]=(pindex *)realloc(J->Buf[thread],(size_t)J->Size[thread]*sizeof(pindex));
+       if(!J->Buf[thread]) Error("WriteStars, Not enough memory for the neighbours\n",EXIT);
+      }
+    memcpy(J->Buf[thread]+J->Len[thread],S->nb,(size_t)k*sizeof(pindex));
+    J->Count[i]=k;
+    J->Start[i]=J->Len[thread];
+    J->Thread[i]=thread;
+    J->Len[thread]+=k;
+   }
+}
+
+long WriteStars(pindex *q, long m, Point3 *v, pindex n, UG *G, FILE *fp)
+{
+ StarJob *J;
+ pindex *nb;
+ long i, len, Failed=0;
+ pindex j;
+ int t;
+
+ J=(StarJob *)calloc(1,sizeof(StarJob));
+ if(J) J->Count=(pindex *)malloc(STAR_BLOCK*sizeof(pindex));
+ if(J) J->Start=(long *)malloc(STAR_BLOCK*sizeof(long));
+ if(J) J->Thread=(int *)malloc(STAR_BLOCK*sizeof(int));
+ if(!J || !J->Count || !J->Start || !J->Thread)
+   Error("WriteStars, Not enough memory for the queries\n",EXIT);
+ J->q=q;
+ J->v=v;
+ J->n=n;
+ J->G=G;
+ for(t=0;t<ThreadNum();t++) NewStarSpace(G,&(J->S[t]));
+
+ fprintf(fp,"%ld\n",m);
+ for(J->first=0; J->first<m; J->first+=STAR_BLOCK)
+   {
+    len=min(STAR_BLOCK,m-J->first);
+    for(t=0;t<MAX_THREADS;t++) J->Len[t]=0;
+    ParallelFor(len, 0, StarBody, J);
+    for(i=0;i<len;i++)
+      {
+       nb=J->Buf[J->Thread[i]]+J->Start[i];
+       fprintf(fp,"%" IDX " %" IDX,q[J->first+i],J->Count[i]);
+       for(j=0;j<J->Count[i];j++) fprintf(fp," %" IDX,nb[j]);
+       fprintf(fp,"\n");
+       if(J->Count[i]==0) Failed++;
+      }
+   }
+
+ for(t=0;t<MAX_THREADS;t++)
+   {
+    EraseStarSpace(&(J->S[t]));
+    free(J->Buf[t]);
+   }
+ free(J->Count);
+ free(J->Start);
+ free(J->Thread);
+ free(J);
+ return Failed;
+}
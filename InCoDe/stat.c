@@ -24,6 +24,8 @@
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
 
 #include <math.h>
 #include <stdio.h>
@@ -32,7 +34,7 @@
 #include "graphics.h"
 #include "incode.h"
 
-extern StatInfo SI;
+extern PARALLEL_LOCAL StatInfo SI;
 extern NumStatFlag;
 
 void InitStat()
@@ -49,7 +51,7 @@ void InitStat()
  SI.MinRadius=0;
  SI.MinRadiusNum=0;
  SI.Radius=0;
-
+ SI.Cluster=0;
 }
 
 void PrintStat()
@@ -58,26 +60,26 @@ void PrintStat()
 
  printf("|Points     |Time (sec.)|Tetras     |Faces      |CH Faces   |TetraRadius|");
  printf("\n");
- printf("|%7i    |%7.3f    |%7i    |%7i    |%7i    |%7.3f    |",SI.Point,SI.Secs,SI.Tetra,SI.Face,SI.CHFace,SI.Radius/SI.Tetra);
+ printf("|%7" IDX "    |%7.3f    |%7ld    |%7ld    |%7ld    |%7.3f    |",SI.Point,SI.Secs,SI.Tetra,SI.Face,SI.CHFace,SI.Radius/SI.Tetra);
  printf("\n");
 
  printf("|UGMakeTetra|Empty Box  | 2nd Box   |Useful 2nd |PntPerFace |CellPerFace|");
  printf("\n");
- printf("|%7i    |%7i    |%7i    |%7i    |%7.2f    |%7.2f    ",SI.MakeTetra,SI.EmptyBox,SI.SecondBox,SI.UsefulSecondBox,(double)SI.TestedPoint/SI.Face,(double)SI.TestedCell/SI.Face);
+ printf("|%7ld    |%7ld    |%7ld    |%7ld    |%7.2f    |%7.2f    ",SI.MakeTetra,SI.EmptyBox,SI.SecondBox,SI.UsefulSecondBox,(double)SI.TestedPoint/SI.Face,(double)SI.TestedCell/SI.Face);
  printf("\n");
 
- printf("|Cell       |Empty Cell |MaxPntCell |Cell Side  |");
+ printf("|Cell       |Empty Cell |MaxPntCell |Cell Side  |Cluster    |");
  printf("\n");
- printf("|%7i    |%7i    |%7i    |%7.3f    |",SI.Cell,SI.EmptyCell,SI.MaxPointPerCell,SI.CellEdge);
+ printf("|%7i    |%7i    |%7i    |%7.3f    |%7.3f    |",SI.Cell,SI.EmptyCell,SI.MaxPointPerCell,SI.CellEdge,SI.Cluster);
  printf("\n");
 
 }
 
 void PrintNumStat()
 {
- printf("%7i   , %7.3f   , %7i   , %7i   , %7i   , %7.3f   , ",SI.Point,SI.Secs,SI.Tetra,SI.Face,SI.CHFace,SI.Radius/SI.Tetra);
- printf("%7i   , %7i   , %7i   , %7i   , %7.2f   , %7.2f   , ",SI.MakeTetra,SI.EmptyBox,SI.SecondBox,SI.UsefulSecondBox,(double)SI.TestedPoint/SI.Face,(double)SI.TestedCell/SI.Face);
- printf("%7i   , %7i   , %7i   , %7.3f    \n",SI.Cell,SI.EmptyCell,SI.MaxPointPerCell,SI.CellEdge);
+ printf("%7" IDX "   , %7.3f   , %7ld   , %7ld   , %7ld   , %7.3f   , ",SI.Point,SI.Secs,SI.Tetra,SI.Face,SI.CHFace,SI.Radius/SI.Tetra);
+ printf("%7ld   , %7ld   , %7ld   , %7ld   , %7.2f   , %7.2f   , ",SI.MakeTetra,SI.EmptyBox,SI.SecondBox,SI.UsefulSecondBox,(double)SI.TestedPoint/SI.Face,(double)SI.TestedCell/SI.Face);
+ printf("%7i   , %7i   , %7i   , %7.3f   , %7.3f    \n",SI.Cell,SI.EmptyCell,SI.MaxPointPerCell,SI.CellEdge,SI.Cluster);
 
 }
 
@@ -85,5 +87,5 @@ void PrintNumStatTitle()
 {
  printf("Points    , Time      , Tetras    , Faces     , CH Faces  , TetraRadius,");
  printf("UGMakTetra, Empty Box ,  2nd Box  , Useful 2nd, PntPerFace, CellPerFace,");
- printf("Cell      , Empty Cell, MaxPntCell, Cell Side  \n");
+ printf("Cell      , Empty Cell, MaxPntCell, Cell Side , Cluster   \n");
 }
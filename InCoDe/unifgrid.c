@@ -10,7 +10,9 @@
 * IMPORTS:      OList                                                      *
 *               Statistic Variables                                        *
 *                                                                          *
-* EXPORTS:	BuildUG       Initialize the UG data structure		   *
+* EXPORTS:	TuneUG        Choose the size of the UG			   *
+*		BuildUG       Initialize the UG data structure		   *
+*		EraseUG       Free the UG				   *
 *               FastMakeTetra   Build a new tetra using UG to speed up     *
 *                                                                          *
 *   NOTES:      This is the optimized version of the InCoDe algorithm.     *
@@ -27,23 +29,27 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
 #include "graphics.h"
 
 #include <OList/general.h>
 #include <OList/error.h>
 #include <OList/olist.h>
+#include <OList/store.h>
+#include <OList/delaunay.h>
+#include <OList/parallel.h>
 
 #include "incode.h"
 
 
 /* Global for Statistic Infomations */
 
-extern StatInfo SI;
+extern PARALLEL_LOCAL StatInfo SI;
 
 /* Global Program Flag */
 
-extern boolean CheckFlag;
 extern boolean StatFlag;
+extern double	UGOccupancy, UGCluster;
 
 /***************************************************************************
 *									   *
@@ -56,7 +62,7 @@ extern boolean StatFlag;
 *									   *
 ***************************************************************************/
 
-Plist *AddPoint(Plist *P, int p)
+Plist *AddPoint(Plist *P, pindex p, Point3 *v, Point3 *o)
 {
  Plist *TempP;
 
@@ -65,6 +71,8 @@ Plist *AddPoint(Plist *P, int p)
    Error("Insufficient memory to add a point to point list of the UG cell!!\n", EXIT);
 
  TempP->p=p;
+ V3Sub(v,o,&(TempP->r));
+ TempP->w=V3Dot(&(TempP->r),&(TempP->r));
  TempP->next=P;
 
  return TempP;
@@ -99,6 +107,82 @@ boolean UGIsMarked(UG *G, int Index)
 }
 
 
+/***************************************************************************
+*									   *
+* TuneUG								   *
+*									   *
+* Choose the number of cells of the UG for the n points of v.		   *
+*									   *
+* S = min(n,UG_SAMPLE) points, evenly spaced in v, are binned in a coarse  *
+* grid of about S/UG_SAMPLE_CELL cells over their bounding box. If c is    *
+* the count of a coarse cell, the sum of c(c-1) is the number of ordered   *
+* pairs of sampled points that are near; in a uniform set it is about	   *
+* S(S-1)/cells, so the clustering index					   *
+*									   *
+*		 K = sum c(c-1) * cells / (S(S-1))			   *
+*									   *
+* is 1 for uniform sets and grows with the clustering (it is the density   *
+* seen by the average point over the mean density). The UG gets		   *
+* n * K^UGCluster / UGOccupancy cells, see UG tuning in incode.h.	   *
+*									   *
+* It costs O(S), nothing compared with the triangulation.		   *
+*									   *
+***************************************************************************/
+
+int TuneUG(Point3 *v, pindex n)
+{
+ Point3 vn, vp, *p;
+ pindex i, j, S;
+ int x, y, z, ix, iy, iz, *Count;
+ double volume, side, sum=0, K, m;
+
+ S=MIN(n,UG_SAMPLE);
+ if(S<2*UG_SAMPLE_CELL) return UG_CELLS(n);
+
+ vn=vp=v[0];
+ for(i=0;i<S;i++)		/* Bounding Box del campione */
+  {
+   p=&(v[(pindex)((double)i*n/S)]);
+   if(p->x < vn.x) vn.x=p->x;
+   if(p->y < vn.y) vn.y=p->y;
+   if(p->z < vn.z) vn.z=p->z;
+   if(p->x > vp.x) vp.x=p->x;
+   if(p->y > vp.y) vp.y=p->y;
+   if(p->z > vp.z) vp.z=p->z;
+  }
+
+ volume=(vp.x-vn.x)*(vp.y-vn.y)*(vp.z-vn.z);
+ if(volume<=0) return UG_CELLS(n);		/* Punti complanari, come BuildUG */
+
+ side=pow(volume*UG_SAMPLE_CELL/S,1.0/3.0);
+ x=MAX((int)ceil((vp.x-vn.x)/side),1);
+ y=MAX((int)ceil((vp.y-vn.y)/side),1);
+ z=MAX((int)ceil((vp.z-vn.z)/side),1);
+
+ Count=(int *)calloc((size_t)x*y*z,sizeof(int));
+ if(!Count) Error("TuneUG, Not enough memory to sample the points!!\n",EXIT);
+
+ for(i=0;i<S;i++)
+  {
+   p=&(v[(pindex)((double)i*n/S)]);
+   ix=MIN((int)((p->x-vn.x)/side),x-1);
+   iy=MIN((int)((p->y-vn.y)/side),y-1);
+   iz=MIN((int)((p->z-vn.z)/side),z-1);
+   Count[ix + iy*x + iz*x*y]++;
+  }
+ for(j=0;j<(pindex)x*y*z;j++) sum+=(double)Count[j]*(Count[j]-1);
+ free(Count);
+
+ K=sum*(volume/(side*side*side))/((double)S*(S-1));
+ SI.Cluster=K;
+
+ m=n*pow(K,UGCluster)/UGOccupancy;
+ m=MAX(m,n*UG_MIN_SCALE);
+ m=MIN(m,n*UG_MAX_SCALE);
+ return UG_CELLS(m);
+}
+
+
 /***************************************************************************
 *									   *
 * BuildUG								   *
@@ -158,17 +242,39 @@ boolean UGIsMarked(UG *G, int Index)
 *    |	 | * |	*|   |							   *
 *    +---+---+*--+---+							   *
 *									   *
-*									   *
+* The cells are sized by the SizeGrid of OList, shared with the E^d	   *
+* programs, that also enlarges the cells of nearly flat point sets.	   *
 *									   *
 ***************************************************************************/
 
-UG *BuildUG(Point3 *v, int n, int m, UG *G)
+/*
+ * GridUG
+ *
+ * Le celle della UG di m celle nel bounding box G->vn-G->vp, calcolate da
+ * SizeGrid, che allarga il box a un numero intero di celle.
+ */
+
+static void GridUG(UG *G, int m)
 {
- int i;
+ double vn[3], vp[3];
+ int c[3];
+
+ vn[0]=G->vn.x; vn[1]=G->vn.y; vn[2]=G->vn.z;
+ vp[0]=G->vp.x; vp[1]=G->vp.y; vp[2]=G->vp.z;
+
+ G->n=(int)SizeGrid(vn,vp,3,(double)m,c,&(G->side));
+
+ G->x=c[0]; G->y=c[1]; G->z=c[2];
+ G->vn.x=vn[0]; G->vn.y=vn[1]; G->vn.z=vn[2];
+ G->vp.x=vp[0]; G->vp.y=vp[1]; G->vp.z=vp[2];
+}
+
+
+UG *BuildUG(Point3 *v, pindex n, int m, UG *G)
+{
+ pindex i;
  int indx, indy, indz, index;
  int CellNumber;
- double volume;
- double xoffset,yoffset,zoffset;
 
  G->vn.x=v[0].x;
  G->vn.y=v[0].y;
@@ -189,30 +295,14 @@ UG *BuildUG(Point3 *v, int n, int m, UG *G)
   if(v[i].z > G->vp.z) G->vp.z=v[i].z;
  }
 
- volume=(G->vp.x - G->vn.x)*(G->vp.y - G->vn.y)*(G->vp.z - G->vn.z);
- G->side = pow(volume/(double)m,0.3333333);
+ GridUG(G,m);			/* How many cell per side */
  SI.CellEdge=G->side;
 
- G->x=(int)ceil((G->vp.x - G->vn.x)/G->side);  /* How many cell per side */
- G->y=(int)ceil((G->vp.y - G->vn.y)/G->side);
- G->z=(int)ceil((G->vp.z - G->vn.z)/G->side);
+ G->o.x=(G->vn.x+G->vp.x)/2;
+ G->o.y=(G->vn.y+G->vp.y)/2;
+ G->o.z=(G->vn.z+G->vp.z)/2;
 
- xoffset = G->x*G->side - (G->vp.x-G->vn.x);
- yoffset = G->y*G->side - (G->vp.y-G->vn.y);
- zoffset = G->z*G->side - (G->vp.z-G->vn.z);
-
-
- G->vn.x -= xoffset/2;
- G->vn.y -= yoffset/2;
- G->vn.z -= zoffset/2;
-
- G->vp.x += xoffset/2;
- G->vp.y += yoffset/2;
- G->vp.z += zoffset/2;
-
-
- CellNumber=G->x*G->y*G->z;
- G->n=CellNumber;
+ CellNumber=G->n;
 
  SI.Cell=CellNumber;
 
@@ -222,11 +312,11 @@ UG *BuildUG(Point3 *v, int n, int m, UG *G)
 
  for(i=0;i<n;i++)
  {
-  indx=(int)((v[i].x - G->vn.x)/G->side);
-  indy=(int)((v[i].y - G->vn.y)/G->side);
-  indz=(int)((v[i].z - G->vn.z)/G->side);
+  indx=GridCoord(v[i].x, G->vn.x, G->side, G->x);
+  indy=GridCoord(v[i].y, G->vn.y, G->side, G->y);
+  indz=GridCoord(v[i].z, G->vn.z, G->side, G->z);
   index=indx + indy*G->x + indz*G->y*G->x;
-  G->C[index] = AddPoint((G->C)[index], i);
+  G->C[index] = AddPoint((G->C)[index], i, &(v[i]), &(G->o));
  }
 
  G->Mark=0;
@@ -261,6 +351,32 @@ UG *BuildUG(Point3 *v, int n, int m, UG *G)
 }
 
 
+/***************************************************************************
+*									   *
+* EraseUG								   *
+*									   *
+* Free the point lists, the cells and the used points of a Uniform Grid.   *
+*									   *
+***************************************************************************/
+
+void EraseUG(UG *G)
+{
+ Plist *P, *next;
+ int i;
+
+ for(i=0;i<G->n;i++)
+   for(P=G->C[i];P;P=next)
+     {
+      next=P->next;
+      free(P);
+     }
+
+ free(G->C);
+ free(G->Marked);
+ free(G->UsedPoint);
+}
+
+
 
 /***************************************************************************
 *									   *
@@ -314,20 +430,13 @@ double CalcBox(Face *f, Point3 *v, Line *Lc, UG *G,
  BoxCenter.y=Lc->Lu.y+Lc->Lv.y*offset;
  BoxCenter.z=Lc->Lu.z+Lc->Lv.z*offset;
 
- vn->x = (int)((BoxCenter.x - G->vn.x - Radius)/G->side);
- vn->y = (int)((BoxCenter.y - G->vn.y - Radius)/G->side);
- vn->z = (int)((BoxCenter.z - G->vn.z - Radius)/G->side);
-
- vp->x = (int)((BoxCenter.x - G->vn.x + Radius)/G->side);
- vp->y = (int)((BoxCenter.y - G->vn.y + Radius)/G->side);
- vp->z = (int)((BoxCenter.z - G->vn.z + Radius)/G->side);
+ vn->x = GridCoord(BoxCenter.x - Radius, G->vn.x, G->side, G->x);
+ vn->y = GridCoord(BoxCenter.y - Radius, G->vn.y, G->side, G->y);
+ vn->z = GridCoord(BoxCenter.z - Radius, G->vn.z, G->side, G->z);
 
- vn->x=max(0,vn->x);
- vn->y=max(0,vn->y);
- vn->z=max(0,vn->z);
- vp->x=min(G->x-1,vp->x);
- vp->y=min(G->y-1,vp->y);
- vp->z=min(G->z-1,vp->z);
+ vp->x = GridCoord(BoxCenter.x + Radius, G->vn.x, G->side, G->x);
+ vp->y = GridCoord(BoxCenter.y + Radius, G->vn.y, G->side, G->y);
+ vp->z = GridCoord(BoxCenter.z + Radius, G->vn.z, G->side, G->z);
 
  return(Radius*Radius);
 }
@@ -473,6 +582,33 @@ boolean ExaminableCell(int x, int y, int z, Plane *p, UG *c)
 
 }
 
+/***************************************************************************
+*									   *
+* DDRadius								   *
+*									   *
+* Given a point of a cell and the DDForm of a face, it calculates the	   *
+* squared radius of the sphere through the face and the point, negative if *
+* the center is not on the right side of the face. It uses the coords and  *
+* the lifted coord kept in the Plist node, not the point itself.	   *
+* It returns FALSE if the point is not on the right side of the face.	   *
+*									   *
+***************************************************************************/
+
+static boolean DDRadius(Plist *P, DDForm *d, double *Radius)
+{
+ double h, t;
+
+ h=d->N.x*P->r.x + d->N.y*P->r.y + d->N.z*P->r.z - d->off;
+ if(h <= EPSILON) return FALSE;
+
+ t=(P->w + d->A.x*P->r.x + d->A.y*P->r.y + d->A.z*P->r.z + d->K)/(2*h);
+ SI.TestedPoint++;
+
+ *Radius=d->R2+t*t;			/* t is the offset of the center  */
+ if(t <= EPSILON) *Radius=-*Radius;	/* from the face plane		  */
+ return TRUE;
+}
+
 /***************************************************************************
 *									   *
 * ScanCellBox								   *
@@ -487,15 +623,13 @@ boolean ExaminableCell(int x, int y, int z, Plane *p, UG *c)
 ***************************************************************************/
 
 boolean ScanCellBox(IntPoint3 *vn, IntPoint3 *vp, Point3 *v,
-	Face *f, Line *Lc, Plane *p, UG *G, int *index,double *MinRadius)
+	Face *f, DDForm *d, UG *G, pindex *index, double *MinRadius)
 {
  int i,j,k;
  int CellIndex;
  Plist *P;
- Plane Mp;
- Point3 c;
  double Radius;
- int indpnt=-1;
+ pindex indpnt=-1;
  boolean Found=FALSE;
 
  for(i=vn->x; i<=vp->x; i++)
@@ -514,22 +648,14 @@ boolean ScanCellBox(IntPoint3 *vn, IntPoint3 *vp, Point3 *v,
 	       if((indpnt!=f->v[0]) &&
 		  (indpnt!=f->v[1]) &&
 		  (indpnt!=f->v[2]) &&
-		   RightSide(p,&(v[indpnt])) )
+		   DDRadius(P,d,&Radius) )
 		   {
-		    CalcMiddlePlane(&(v[indpnt]),&(v[f->v[0]]),&Mp);
-		    if(CalcLinePlaneInter(Lc,&Mp,&c))
+		    if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
+		    if(Radius<*MinRadius)
 		      {
-			Radius=V3SquaredDistanceBetween2Points(&c, &(v[indpnt]));
-			if(!RightSide(p,&c)) Radius=-Radius;
-
-			if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
-			if(Radius<*MinRadius)
-				{
-				 *MinRadius=Radius;
-				 *index=indpnt;
-				 Found=TRUE;
-				}
-
+		       *MinRadius=Radius;
+		       *index=indpnt;
+		       Found=TRUE;
 		      }
 		   }
 	       P=P->next;
@@ -550,15 +676,13 @@ boolean ScanCellBox(IntPoint3 *vn, IntPoint3 *vp, Point3 *v,
 ***************************************************************************/
 
 boolean MakeLastScan(IntPoint3 *Start, IntPoint3 *End, IntPoint3 *Inc, Point3 *v,
-	 Face *f, Line *Lc, Plane *p, UG *G, int *index, double *MinRadius)
+	 Face *f, DDForm *d, Plane *p, UG *G, pindex *index, double *MinRadius)
 {
  int i,j,k;
  int CellIndex;
  Plist *P;
- Plane Mp;
- Point3 c;
  double Radius;
- int indpnt=-1;
+ pindex indpnt=-1;
 
  for(i=Start->x; Inc->x*i <= Inc->x*End->x; i+=Inc->x)
    {
@@ -581,21 +705,14 @@ boolean MakeLastScan(IntPoint3 *Start, IntPoint3 *End, IntPoint3 *Inc, Point3 *v
 			  if((indpnt!=f->v[0]) &&
 			     (indpnt!=f->v[1]) &&
 			     (indpnt!=f->v[2]) &&
-			     RightSide(p,&(v[indpnt])) )
+			     DDRadius(P,d,&Radius) )
 			   {
-			    CalcMiddlePlane(&(v[indpnt]),&(v[f->v[0]]),&Mp);
-			    if(CalcLinePlaneInter(Lc,&Mp,&c))
-			     {
-			      Radius=V3SquaredDistanceBetween2Points(&c, &(v[indpnt]));
-
-			      if(!RightSide(p,&c)) Radius=-Radius;
-			      if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
-			      if(Radius<*MinRadius)
-				{
-				 *MinRadius=Radius;
-				 *index=indpnt;
-				}
-			     }
+			    if(Radius==*MinRadius) Error("Cinque punti cocircolari!!\n",EXIT);
+			    if(Radius<*MinRadius)
+			      {
+			       *MinRadius=Radius;
+			       *index=indpnt;
+			      }
 			   }
 			  P=P->next;
 			 }   /* end while		  */
@@ -633,7 +750,7 @@ boolean MakeLastScan(IntPoint3 *Start, IntPoint3 *End, IntPoint3 *Inc, Point3 *v
 *									   *
 ***************************************************************************/
 
-Tetra *FastMakeTetra(Face *f, Point3 *v, int n, UG *G)
+Tetra *FastMakeTetra(Face *f, Point3 *v, pindex n, UG *G)
 {
  Plane p;
  Tetra *t;
@@ -643,8 +760,9 @@ Tetra *FastMakeTetra(Face *f, Point3 *v, int n, UG *G)
 	MinRadius=BIGNUMBER;
 
  Line Lc;
+ DDForm d;
  IntPoint3 vn,vp, start, end, inc;
- int Index=-1;
+ pindex Index=-1;
  boolean Found=FALSE;
 
  SI.MakeTetra++;
@@ -657,12 +775,13 @@ Tetra *FastMakeTetra(Face *f, Point3 *v, int n, UG *G)
  CalcLineofCenter(&(v[f->v[0]]),&(v[f->v[1]]),&(v[f->v[2]]),&Lc);
 
  FaceRadius=V3DistanceBetween2Points(&(Lc.Lu), &(v[f->v[0]]));
+ CalcDDForm(&p,&Lc,FaceRadius,&(G->o),&d);
 
  do
  {
   CellBoxRadius++;
   BoxRadius=CalcBox(f,v,&Lc,G,&vn,&vp, CellBoxRadius*FaceRadius);
-  Found=ScanCellBox(&vn, &vp, v, f, &Lc, &p, G, &Index, &MinRadius);
+  Found=ScanCellBox(&vn, &vp, v, f, &d, G, &Index, &MinRadius);
  }
  while(!Found && CellBoxRadius <= 1);
 
@@ -671,7 +790,7 @@ Tetra *FastMakeTetra(Face *f, Point3 *v, int n, UG *G)
 
   SI.SecondBox++;
   BoxRadius=CalcBox(f,v,&Lc,G,&vn,&vp, sqrt(MinRadius));
-  ScanCellBox(&vn, &vp, v, f, &Lc, &p, G, &Index, &MinRadius);
+  ScanCellBox(&vn, &vp, v, f, &d, G, &Index, &MinRadius);
   if(oldMinRadius>MinRadius) SI.UsefulSecondBox++;
  }
 
@@ -679,7 +798,7 @@ Tetra *FastMakeTetra(Face *f, Point3 *v, int n, UG *G)
  {
   SI.EmptyBox++;
   CalcLastScan(G, &start, &end, &inc, &p);
-  Found=MakeLastScan(&start, &end, &inc, v, f, &Lc, &p, G, &Index,&MinRadius);
+  Found=MakeLastScan(&start, &end, &inc, v, f, &d, &p, G, &Index,&MinRadius);
  }
 
  if(!Found) return NULL;
@@ -696,7 +815,5 @@ Tetra *FastMakeTetra(Face *f, Point3 *v, int n, UG *G)
   CalcSphereCenter(&(v[f->v[0]]),&(v[f->v[1]]),&(v[f->v[2]]),&(v[Index]),&C);
   SI.Radius+=V3DistanceBetween2Points(&C, &(v[Index]));
  }
- if(CheckFlag)  CheckTetra(t,v,n);
-
  return t;
 }
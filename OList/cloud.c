@@ -0,0 +1,536 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*									   *
+*    FILE:	cloud.c							   *
+*									   *
+* PURPOSE:	Reading point clouds in the PLY, LAS and XYZ formats.	   *
+*									   *
+* EXPORTS:	InitFilter     Loading all the points.			   *
+*		SetFilterBox   Loading only the points inside a box.	   *
+*		SetFilterClass Loading only some LAS classes.		   *
+*		FilterPoints   Removing from a vector the points filtered. *
+*		ReadCloud      Reading a PLY, LAS or XYZ file.		   *
+*									   *
+* IMPORTS:	ParallelFor, numfile					   *
+*									   *
+* GLOBALS:								   *
+*									   *
+*   NOTES:	The binary files (LAS and binary PLY) are made of records  *
+*		of fixed length: they are read CLOUD_CHUNK records at a    *
+*		time, the records of a chunk are decoded in parallel and   *
+*		the points that pass the filter are appended to the	   *
+*		vector, so only a chunk of the file is in memory. The text *
+*		files (ASCII PLY and XYZ) are parsed in parallel by	   *
+*		ReadReals.						   *
+*		LAS 1.0 to 1.4, point formats 0 to 10, are read; the	   *
+*		compressed LAZ files are not. Of a PLY file only the	   *
+*		properties x, y, z of the vertex element, that must be the *
+*		first, are read. A XYZ file has a point for each line, the *
+*		first three numbers of the line, and no count.		   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/parallel.h>
+#include <OList/numfile.h>
+#include <OList/cloud.h>
+
+
+enum CloudType { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+static int TypeSize[]={1, 1, 2, 2, 4, 4, 4, 8};
+
+typedef struct Fieldtag 	/* A number in a record 		   */
+{
+ long offset;
+ enum CloudType type;
+ double scale, shift;		/* The value is scale*number+shift	   */
+} Field;
+
+typedef struct CloudJobtag
+{
+ unsigned char *buf;		/* A chunk of records			   */
+ long len;			/* Bytes of a record			   */
+ Field f[3];			/* The coordinates			   */
+ boolean swap;			/* Whether their byte order is not ours    */
+ long cls;			/* Offset of the class, -1 if none	   */
+ int mask;			/* Bits of the class			   */
+ PointFilter *F;
+ double *x;			/* The coordinates of the chunk 	   */
+ char *keep;			/* Whether each point passes the filter    */
+} CloudJob;
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	InitFilter, SetFilterBox, SetFilterClass		   *
+*									   *
+*  PURPOSE:	Build a PointFilter: InitFilter loads all the points,	   *
+*		SetFilterBox only those inside the box given as		   *
+*		"xmin,ymin,zmin,xmax,ymax,zmax", SetFilterClass only the   *
+*		LAS points of the classes given as "c1,c2,...".		   *
+*									   *
+*   RETURN:	TRUE if the string is correct,				   *
+*		FALSE else.						   *
+*									   *
+***************************************************************************/
+
+void InitFilter(PointFilter *F)
+{
+ memset(F,0,sizeof(PointFilter));
+}
+
+boolean SetFilterBox(PointFilter *F, char *s)
+{
+ int k;
+
+ if(!s || sscanf(s,"%lf,%lf,%lf,%lf,%lf,%lf",&F->min[0],&F->min[1],&F->min[2],
+				       &F->max[0],&F->max[1],&F->max[2])!=6)
+   return FALSE;
+ for(k=0;k<3;k++)
+   if(F->min[k]>F->max[k]) return FALSE;
+ F->BoxFlag=TRUE;
+ return TRUE;
+}
+
+boolean SetFilterClass(PointFilter *F, char *s)
+{
+ char *end;
+ long c;
+
+ if(!s) return FALSE;
+ memset(F->Class,0,sizeof(F->Class));
+ for(;;)
+   {
+    c=strtol(s,&end,10);
+    if(end==s || c<0 || c>255) return FALSE;
+    F->Class[c>>3]|=1<<(c&7);
+    if(*end==0) break;
+    if(*end!=',') return FALSE;
+    s=end+1;
+   }
+ F->ClassFlag=TRUE;
+ return TRUE;
+}
+
+
+/*
+ * Keep
+ *
+ * Vero se il punto x, di classe c (-1 se il formato non ha classi),
+ * passa il filtro.
+ */
+
+static boolean Keep(PointFilter *F, double *x, int c)
+{
+ int k;
+
+ if(!F) return TRUE;
+ if(F->BoxFlag)
+   for(k=0;k<3;k++)
+     if(x[k]<F->min[k] || x[k]>F->max[k]) return FALSE;
+ if(F->ClassFlag && c>=0 && !(F->Class[c>>3]&(1<<(c&7)))) return FALSE;
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	FilterPoints						   *
+*									   *
+*  PURPOSE:	Remove from a vector of n objects of the given size the    *
+*		points outside the box of F.				   *
+*									   *
+*   RETURN:	The number of points left, at the beginning of vec.	   *
+*									   *
+***************************************************************************/
+
+long FilterPoints(void *vec, long n, size_t size, PointFilter *F)
+{
+ char *p=(char *)vec;
+ long i, m=0;
+
+ if(!F || !F->BoxFlag) return n;
+ for(i=0;i<n;i++)
+   if(Keep(F,(double *)(p+i*size),-1))
+     {
+      if(m<i) memcpy(p+m*size,p+i*size,size);
+      m++;
+     }
+ return m;
+}
+
+
+/*
+ * GetField, U16, U32
+ *
+ * Leggono un numero di un record nell'ordine di byte del file; U16 e U32
+ * leggono gli interi little endian dell'header LAS.
+ */
+
+static double GetField(unsigned char *r, Field *f, boolean swap)
+{
+ unsigned char b[8];
+ int i, s=TypeSize[f->type];
+ signed char c;
+ short h;
+ unsigned short uh;
+ int w;
+ unsigned int uw;
+ float x;
+ double d;
+
+ if(swap)
+   for(i=0;i<s;i++) b[i]=r[f->offset+s-1-i];
+ else memcpy(b,r+f->offset,(size_t)s);
+
+ switch(f->type)
+   {
+    case INT8	: memcpy(&c,b,1);  d=c;  break;
+    case UINT8	: d=b[0];		 break;
+    case INT16	: memcpy(&h,b,2);  d=h;  break;
+    case UINT16 : memcpy(&uh,b,2); d=uh; break;
+    case INT32	: memcpy(&w,b,4);  d=w;  break;
+    case UINT32 : memcpy(&uw,b,4); d=uw; break;
+    case FLOAT32: memcpy(&x,b,4);  d=x;  break;
+    default	: memcpy(&d,b,8);	 break;
+   }
+ return f->scale*d+f->shift;
+}
+
+static unsigned long U16(unsigned char *p)
+{
+ return (unsigned long)p[0] | (unsigned long)p[1]<<8;
+}
+
+static unsigned long U32(unsigned char *p)
+{
+ return U16(p) | U16(p+2)<<16;
+}
+
+static boolean BigEndian(void)
+{
+ int one=1;
+
+ return *(char *)&one==0;
+}
+
+
+/*
+ * DecodeBody, ReadRecords
+ *
+ * ReadRecords legge nrec record di J->len byte, un blocco alla volta; i
+ * record di un blocco sono decodificati in parallelo da DecodeBody e i
+ * punti che passano il filtro sono copiati nel vettore.
+ */
+
+static void DecodeBody(long from, long to, int thread, void *arg)
+{
+ CloudJob *J=(CloudJob *)arg;
+ unsigned char *r;
+ long i;
+ int k;
+
+ for(i=from;i<to;i++)
+   {
+    r=J->buf+i*J->len;
+    for(k=0;k<3;k++) J->x[3*i+k]=GetField(r,&(J->f[k]),J->swap);
+    J->keep[i]=Keep(J->F,J->x+3*i,J->cls>=0 ? r[J->cls]&J->mask : -1);
+   }
+}
+
+static void *ReadRecords(char *filename, FILE *fp, long nrec, CloudJob *J,
+			 size_t size, long *n)
+{
+ char *vec;
+ long i, j, k;
+
+ vec=(char *)calloc((size_t)MAX(nrec,1),size);
+ J->buf=(unsigned char *)malloc((size_t)(CLOUD_CHUNK*J->len));
+ J->x=(double *)malloc(CLOUD_CHUNK*3*sizeof(double));
+ J->keep=(char *)malloc(CLOUD_CHUNK);
+ if(!vec || !J->buf || !J->x || !J->keep)
+   Error("ReadCloud, Not enough memory to load point dataset.\n",EXIT);
+
+ *n=0;
+ for(i=0;i<nrec;i+=k)
+   {
+    k=MIN(CLOUD_CHUNK,nrec-i);
+    if((j=(long)fread(J->buf,(size_t)J->len,(size_t)k,fp))!=k)
+      Errorf(EXIT,"ReadCloud, %s truncated at point %ld.\n",filename,i+j);
+    ParallelFor(k, 0, DecodeBody, J);
+    for(j=0;j<k;j++)
+      if(J->keep[j]) memcpy(vec+(*n)++*size,J->x+3*j,3*sizeof(double));
+   }
+
+ free(J->buf);
+ free(J->x);
+ free(J->keep);
+ return realloc(vec,(size_t)MAX(*n,1)*size);
+}
+
+
+/*
+ * PickPoints
+ *
+ * Dai vettori di k numeri letti da un file di testo prende le coordinate
+ * (le colonne c[0], c[1], c[2]) dei punti che passano il filtro.
+ */
+
+static void *PickPoints(double *t, long nv, int k, int *c, PointFilter *F,
+			size_t size, long *n)
+{
+ char *vec;
+ double x[3];
+ long i;
+ int j;
+
+ vec=(char *)calloc((size_t)MAX(nv,1),size);
+ if(!vec) Error("ReadCloud, Not enough memory to load point dataset.\n",EXIT);
+
+ *n=0;
+ for(i=0;i<nv;i++)
+   {
+    for(j=0;j<3;j++) x[j]=t[i*k+c[j]];
+    if(Keep(F,x,-1)) memcpy(vec+(*n)++*size,x,sizeof(x));
+   }
+ free(t);
+ return realloc(vec,(size_t)MAX(*n,1)*size);
+}
+
+
+/*
+ * ReadLAS
+ *
+ * Legge l'header LAS, di cui servono il formato e la lunghezza dei record,
+ * il loro numero e posizione, scala e offset delle coordinate.
+ */
+
+static void *ReadLAS(char *filename, FILE *fp, PointFilter *F, size_t size, long *n)
+{
+ unsigned char h[375];
+ unsigned long nrec, fmt;
+ CloudJob J;
+ long hsize;
+ int k;
+
+ memset(h,0,sizeof(h));
+ hsize=(long)fread(h,1,sizeof(h),fp);
+ if(hsize<227 || U16(h+94)<227)
+   Errorf(EXIT,"ReadCloud, %s has a wrong LAS header.\n",filename);
+
+ fmt=h[104];
+ if(fmt & 0xC0) Errorf(EXIT,"ReadCloud, %s is compressed (LAZ), not supported.\n",filename);
+ if(fmt>10) Errorf(EXIT,"ReadCloud, %s has the unknown point format %lu.\n",filename,fmt);
+
+ nrec=U32(h+107);
+ if(h[25]>=4 && U16(h+94)>=375 && nrec==0)
+   {
+    if(U32(h+251)) Errorf(EXIT,"ReadCloud, %s has too many points.\n",filename);
+    nrec=U32(h+247);
+   }
+
+ J.len=(long)U16(h+105);
+ J.swap=BigEndian();
+ J.F=F;
+ J.cls= fmt<6 ? 15 : 16;
+ J.mask= fmt<6 ? 0x1f : 0xff;
+ for(k=0;k<3;k++)
+   {
+    J.f[k].offset=4*k;
+    J.f[k].type=INT32;
+    J.f[k].scale=1;
+    J.f[k].shift=0;
+   }
+ for(k=0;k<3;k++)	/* Scale and offset are little endian doubles */
+   {
+    Field d;
+
+    d.offset=131+8*k; d.type=FLOAT64; d.scale=1; d.shift=0;
+    J.f[k].scale=GetField(h,&d,J.swap);
+    d.offset=155+8*k;
+    J.f[k].shift=GetField(h,&d,J.swap);
+   }
+ if(J.len<J.cls+1 || fseek(fp,(long)U32(h+96),SEEK_SET))
+   Errorf(EXIT,"ReadCloud, %s has a wrong LAS header.\n",filename);
+
+ return ReadRecords(filename,fp,(long)nrec,&J,size,n);
+}
+
+
+/*
+ * ReadPLY
+ *
+ * Legge l'header PLY: il formato e le proprieta' dell'elemento vertex,
+ * di cui si cercano x, y e z. I file binari sono letti a blocchi, quelli
+ * ASCII da ReadReals a partire dalla fine dell'header.
+ */
+
+static void *ReadPLY(char *filename, FILE *fp, PointFilter *F, size_t size, long *n)
+{
+ static char *Name[]={"char", "uchar", "short", "ushort", "int", "uint",
+		      "float", "double", "int8", "uint8", "int16", "uint16",
+		      "int32", "uint32", "float32", "float64"};
+ char line[256], a[64], b[64], *xyz="xyz";
+ int format=-1, k, t, c[3]={-1,-1,-1}, np=0, elem=0;
+ long nv=0, off=0, got;
+ CloudJob J;
+ NumFile NF;
+ double *tmp;
+
+ J.len=0;
+ while(fgets(line,sizeof(line),fp) && strncmp(line,"end_header",10))
+   {
+    if(sscanf(line,"format %63s",a)==1)
+      format= !strcmp(a,"ascii") ? 0 : !strcmp(a,"binary_little_endian") ? 1 :
+	      !strcmp(a,"binary_big_endian") ? 2 : -1;
+    else if(sscanf(line,"element %63s %ld",a,&got)==2 && elem++==0)
+      {
+       if(strcmp(a,"vertex"))
+	 Errorf(EXIT,"ReadCloud, %s: the first PLY element must be vertex.\n",filename);
+       nv=got;
+      }
+    else if(elem==1 && sscanf(line,"property %63s %63s",a,b)==2)
+      {
+       if(!strcmp(a,"list"))
+	 Errorf(EXIT,"ReadCloud, %s: list properties of vertex not supported.\n",filename);
+       for(t=0;t<16 && strcmp(a,Name[t]);t++);
+       if(t==16) Errorf(EXIT,"ReadCloud, %s: unknown PLY type %s.\n",filename,a);
+       for(k=0;k<3;k++)
+	 if(b[0]==xyz[k] && b[1]==0)
+	   {
+	    c[k]=np;
+	    J.f[k].offset=off;
+	    J.f[k].type=(enum CloudType)(t%8);
+	    J.f[k].scale=1;
+	    J.f[k].shift=0;
+	   }
+       off+=TypeSize[t%8];
+       np++;
+      }
+   }
+ if(format<0 || nv<0 || c[0]<0 || c[1]<0 || c[2]<0)
+   Errorf(EXIT,"ReadCloud, %s: PLY without format or vertex x, y, z.\n",filename);
+
+ if(format>0)
+   {
+    J.len=off;
+    J.swap= (format==2)!=BigEndian();
+    J.cls= -1;
+    J.mask=0;
+    J.F=F;
+    return ReadRecords(filename,fp,nv,&J,size,n);
+   }
+
+ off=ftell(fp);
+ if(!OpenNumFile(filename,&NF)) Errorf(EXIT,"ReadCloud, Unable to open %s.\n",filename);
+ NF.pos=off;
+ tmp=(double *)malloc((size_t)MAX(nv*np,1)*sizeof(double));
+ if(!tmp) Error("ReadCloud, Not enough memory to load point dataset.\n",EXIT);
+ if((got=ReadReals(&NF,nv,np,tmp,np*sizeof(double)))<nv)
+   Errorf(EXIT,"ReadCloud, %s truncated at point %ld.\n",filename,got);
+ CloseNumFile(&NF);
+ return PickPoints(tmp,nv,np,c,F,size,n);
+}
+
+
+/*
+ * ReadXYZ
+ *
+ * Conta le righe non vuote e i numeri della prima, poi legge tutto con
+ * ReadReals.
+ */
+
+static void *ReadXYZ(char *filename, PointFilter *F, size_t size, long *n)
+{
+ NumFile NF;
+ char *p, *e, *q;
+ long nv=0, got;
+ int k=0, words, c[3]={0,1,2};
+ boolean blank;
+ double *tmp;
+
+ if(!OpenNumFile(filename,&NF)) Errorf(EXIT,"ReadCloud, Unable to open %s.\n",filename);
+
+ for(p=NF.buf, e=NF.buf+NF.size; p<e; p=q+1)
+   {
+    q=(char *)memchr(p,'\n',(size_t)(e-p));
+    if(!q) q=e;
+    blank=TRUE;
+    words=0;
+    for(;p<q;p++)
+      if(*p==' ' || *p=='\t' || *p=='\r' || *p=='\v' || *p=='\f') blank=TRUE;
+      else
+	{
+	 if(blank) words++;
+	 blank=FALSE;
+	}
+    if(words)
+      {
+       if(nv++==0) k=words;
+      }
+   }
+ if(k<3) Errorf(EXIT,"ReadCloud, %s: a XYZ line needs 3 coordinates.\n",filename);
+
+ tmp=(double *)malloc((size_t)MAX(nv*k,1)*sizeof(double));
+ if(!tmp) Error("ReadCloud, Not enough memory to load point dataset.\n",EXIT);
+ if((got=ReadReals(&NF,nv,k,tmp,k*sizeof(double)))<nv)
+   Errorf(EXIT,"ReadCloud, %s truncated at point %ld.\n",filename,got);
+ CloseNumFile(&NF);
+ return PickPoints(tmp,nv,k,c,F,size,n);
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	ReadCloud						   *
+*									   *
+*  PURPOSE:	Read the points of a PLY, LAS or XYZ file that pass the    *
+*		filter F (NULL to read all of them).			   *
+*									   *
+*   PARAMS:	The file, the filter, the size of the objects of the	   *
+*		vector and where to put the number of points read.	   *
+*									   *
+*   RETURN:	The vector, allocated, with the coordinates at the	   *
+*		beginning of each object and the rest zero, or NULL if the *
+*		file is not of these formats (PLY and LAS are recognized   *
+*		from the first bytes, XYZ from the name ending in .xyz).   *
+*									   *
+***************************************************************************/
+
+void *ReadCloud(char *filename, PointFilter *F, size_t size, long *n)
+{
+ FILE *fp;
+ char magic[4];
+ size_t l=strlen(filename);
+ void *vec=NULL;
+
+ fp=fopen(filename,"rb");
+ if(!fp) return NULL;
+
+ if(fread(magic,1,4,fp)==4)
+   {
+    if(!memcmp(magic,"LASF",4))
+      {
+       rewind(fp);
+       vec=ReadLAS(filename,fp,F,size,n);
+      }
+    else if(!memcmp(magic,"ply",3) && (magic[3]=='\n' || magic[3]=='\r'))
+      {
+       rewind(fp);
+       vec=ReadPLY(filename,fp,F,size,n);
+      }
+   }
+ fclose(fp);
+
+ if(!vec && l>4 && (!strcmp(filename+l-4,".xyz") || !strcmp(filename+l-4,".XYZ")))
+   vec=ReadXYZ(filename,F,size,n);
+ return vec;
+}
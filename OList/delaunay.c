@@ -0,0 +1,307 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*									   *
+*    FILE:	delaunay.c						   *
+*									   *
+* PURPOSE:	The pieces of DeWall and InCoDe shared by the 3d and the   *
+*		E^d triangulators.					   *
+*									   *
+* EXPORTS:	SizeGrid      The cells and the box of a Uniform Grid.	   *
+*		GridCoord     The cell of a coordinate along an axis.	   *
+*		GridIndex     The index of a cell.			   *
+*		GridBox       The cells of the box around a sphere.	   *
+*		NextCell      The next cell of a box.			   *
+*		CellDistance  The squared distance of a point from a cell. *
+*		SplitWall     The position of a wall in sorted points.	   *
+*		ToggleFace    Opening or closing an active face.	   *
+*									   *
+* IMPORTS:	OList							   *
+*									   *
+* GLOBALS:								   *
+*									   *
+*   NOTES:	The dimension d is a parameter of each function, the	   *
+*		points and the cells are vectors of d coordinates (see	   *
+*		delaunay.h). The triangulators keep their own types and    *
+*		pass the coordinates of their points here.		   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <OList/general.h>
+#include <OList/olist.h>
+#include <OList/delaunay.h>
+
+
+/*
+ * Extent
+ *
+ * L'estensione del box lungo l'asse k: almeno una frazione della maggiore,
+ * cosi' un insieme piatto non ha celle di lato nullo.
+ */
+
+static double Extent(double *vn, double *vp, int k, double maxext)
+{
+ return MAX(vp[k]-vn[k],maxext*1e-6);
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	SizeGrid						   *
+*									   *
+*  PURPOSE:	Divide the box vn-vp of the points in about m cubic cells. *
+*									   *
+*   PARAMS:	The box, that is enlarged to a whole number of cells, the  *
+*		dimension d and the cells m wanted.			   *
+*									   *
+*   RETURN:	The number of cells; their number along each axis in c	   *
+*		and their edge in side.					   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	The volume of the box is divided in m hypercubes of edge   *
+*									   *
+*			       __________				   *
+*			    d /						   *
+*		    edge =   / Volume/m					   *
+*			   \/						   *
+*									   *
+*		An extent of the box smaller than a cell counts as one	   *
+*		cell, so for nearly flat point sets the edge is enlarged   *
+*		until the cells are no more than 2m. The box grows by the  *
+*		same amount on both sides of each axis.			   *
+*									   *
+***************************************************************************/
+
+long SizeGrid(double *vn, double *vp, int d, double m, int *c, double *side)
+{
+ double maxext=0, volume=1, cells, offset;
+ long n=1;
+ int k;
+
+ for(k=0;k<d;k++) maxext=MAX(maxext,vp[k]-vn[k]);
+ if(maxext==0) maxext=1;
+ for(k=0;k<d;k++) volume*=Extent(vn,vp,k,maxext);
+
+ m=MAX(m,1);
+ *side=pow(volume/m,1.0/d);
+ do
+   {
+    cells=1;
+    for(k=0;k<d;k++) cells*=ceil(Extent(vn,vp,k,maxext) / *side);
+    if(cells>2.0*m) *side*=1.1;
+   }
+ while(cells>2.0*m);
+
+ for(k=0;k<d;k++)
+   {
+    c[k]=MAX(1,(int)ceil(Extent(vn,vp,k,maxext) / *side));
+    offset=c[k] * *side - (vp[k]-vn[k]);
+    vn[k]-=offset/2;
+    vp[k]+=offset/2;
+    n*=c[k];
+   }
+ return n;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	GridCoord						   *
+*	        GridIndex						   *
+*									   *
+*  PURPOSE:	The cell along an axis of the coordinate x, and the index  *
+*		of the cell of coordinates i.				   *
+*									   *
+*   PARAMS:	x, the minimum vn of the UG along the axis, the cell edge  *
+*		and the cells c along the axis; for GridIndex the cell	   *
+*		coordinates, the cells along each axis and the dimension.  *
+*									   *
+*   RETURN:	The cell coordinate, clamped to 0..c-1; the cell index.    *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	The coordinate is clamped in double before converting it: *
+*		the border of a huge sphere does not fit in an int.	   *
+*									   *
+***************************************************************************/
+
+int GridCoord(double x, double vn, double side, int c)
+{
+ double i=floor((x-vn)/side);
+
+ if(i<0) return 0;
+ if(i>c-1) return c-1;
+ return (int)i;
+}
+
+int GridIndex(int *i, int *c, int d)
+{
+ int index=0, k;
+
+ for(k=d-1;k>=0;k--) index=index*c[k]+i[k];
+ return index;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	GridBox							   *
+*	        NextCell						   *
+*									   *
+*  PURPOSE:	The box of cells lo..hi containing the sphere of center o  *
+*		and radius r, and the scan of its cells.		   *
+*									   *
+*   PARAMS:	The sphere, the minimum vn, cell edge and cells c of the   *
+*		UG and the dimension; NextCell gets the current cell i,    *
+*		that must start from lo.				   *
+*									   *
+*   RETURN:	NextCell moves i to the next cell of the box, with the	   *
+*		first coordinate varying fastest, and returns FALSE after  *
+*		the last one.						   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	The box is clamped to the UG, so a sphere outside it gets  *
+*		the cells on its border.				   *
+*									   *
+***************************************************************************/
+
+void GridBox(double *o, double r, double *vn, double side, int *c, int d,
+	     int *lo, int *hi)
+{
+ int k;
+
+ for(k=0;k<d;k++)
+   {
+    lo[k]=GridCoord(o[k]-r,vn[k],side,c[k]);
+    hi[k]=GridCoord(o[k]+r,vn[k],side,c[k]);
+   }
+}
+
+boolean NextCell(int *i, int *lo, int *hi, int d)
+{
+ int k;
+
+ for(k=0;k<d && i[k]==hi[k];k++) i[k]=lo[k];
+ if(k==d) return FALSE;
+ i[k]++;
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	CellDistance						   *
+*									   *
+*  PURPOSE:	The squared distance of the point o from the cell i.	   *
+*									   *
+*   PARAMS:	The point, the cell, the minimum vn and cell edge of the   *
+*		UG and the dimension.					   *
+*									   *
+*   RETURN:	The squared distance, 0 if o is inside the cell.	   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	A cell whose distance is not less than the squared radius  *
+*		of a sphere does not intersect it and can be skipped.	   *
+*									   *
+***************************************************************************/
+
+double CellDistance(double *o, int *i, double *vn, double side, int d)
+{
+ double s=0, x;
+ int k;
+
+ for(k=0;k<d;k++)
+   {
+    x=vn[k]+i[k]*side;
+    if(o[k]<x) s+=SQR(x-o[k]);
+      else if(o[k]>x+side) s+=SQR(o[k]-x-side);
+   }
+ return s;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	SplitWall						   *
+*									   *
+*  PURPOSE:	Put a wall in the n points of v, sorted along the axis,    *
+*		as near as possible to the position m.			   *
+*									   *
+*   PARAMS:	The points, their number, the position wanted, the axis    *
+*		and the function giving the coordinate of a point along an *
+*		axis.							   *
+*									   *
+*   RETURN:	The index of the first point on the positive side, 0 if    *
+*		all the points have the same coordinate. The coordinate of *
+*		the wall goes in off.					   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	The wall is put between the two nearest coordinates that   *
+*		differ by more than WALL_GAP, halfway between them, so	   *
+*		v[0..m-1] and v[m..n-1] are on its two sides even when	   *
+*		many points share the coordinate at m.			   *
+*									   *
+***************************************************************************/
+
+pindex SplitWall(pointer *v, pindex n, pindex m, int axis,
+		 double (*coord)(pointer, int), double *off)
+{
+ pindex i, j=0;
+
+ if(n<2) return 0;
+ m=MIN(MAX(m,1),n-1);
+ for(i=0;i<n;i++)
+   {
+    j=m+i;
+    if(j<n && coord(v[j],axis)-coord(v[j-1],axis) > WALL_GAP) break;
+    j=m-i;
+    if(j>0 && coord(v[j],axis)-coord(v[j-1],axis) > WALL_GAP) break;
+   }
+ if(i==n) return 0;
+
+ *off=(coord(v[j-1],axis)+coord(v[j],axis))/2;
+ return j;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	ToggleFace						   *
+*									   *
+*  PURPOSE:	Update the active face list l with the face f of a new	   *
+*		simplex.						   *
+*									   *
+*   PARAMS:	The face and the list, whose equality function finds the  *
+*		same face of an adjacent simplex.			   *
+*									   *
+*   RETURN:	NULL if f was not in l and is inserted. Otherwise the face *
+*		is shared by two simplices and no more active: the copy    *
+*		found in l is deleted from it and returned.		   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	Freeing the two faces and counting the active faces of the *
+*		vertices are left to the caller.			   *
+*									   *
+***************************************************************************/
+
+pointer ToggleFace(pointer f, List l)
+{
+ pointer old;
+
+ if(!MemberList(f,l))
+   {
+    InsertList(f,l);
+    return NULL;
+   }
+ CurrList(&old,l);
+ DeleteCurrList(l);
+ return old;
+}
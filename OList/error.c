@@ -11,6 +11,7 @@
 * EXPORTS:	Error							   *
 *		ErrorNULL						   *
 *		ErrorFALSE						   *
+*		SetErrorExit						   *
 *									   *
 * IMPORTS:								   *
 *									   *
@@ -24,6 +25,9 @@
 *                                                                          *
 *    18/Jan/94  Added Errorf function that print a formatted error message *
 *                                                                          *
+*    19/Oct/26  Added SetErrorExit, so a server can survive the errors of  *
+*               a job.                                                     *
+*                                                                          *
 ****************************************************************************
 ***************************************************************************/
 
@@ -40,6 +44,8 @@
 
 char ProgramName[80]="Error";
 
+static void (*ErrorExit)(void)=NULL;
+
 /***************************************************************************
 *									   *
 * FUNCTION:	Error							   *
@@ -73,7 +79,11 @@ void Error(char *message, boolean ExitFlag)
  fputs(ProgramName,stderr);
  fputs(": ",stderr);
  fputs(message,stderr);
- if(ExitFlag) exit(-1);
+ if(ExitFlag)
+   {
+    if(ErrorExit) ErrorExit();
+    exit(-1);
+   }
 }
 
 
@@ -116,7 +126,11 @@ void Errorf(boolean ExitFlag, char *message, ...)
  vfprintf(stderr,message,marker);
  va_end( marker );
 
- if(ExitFlag) exit(-1);
+ if(ExitFlag)
+   {
+    if(ErrorExit) ErrorExit();
+    exit(-1);
+   }
 }
 
 /***************************************************************************
@@ -140,3 +154,25 @@ void SetProgramName(char *s)
 {
  strcpy(ProgramName, s);
 }
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	SetErrorExit						   *
+*									   *
+*  PURPOSE:	Set a function called by Error and Errorf before exiting.  *
+*									   *
+*   PARAMS:	The function, or NULL to simply exit.			   *
+*									   *
+*   RETURN:	Nothing.						   *
+*									   *
+*    NOTES:	The function can avoid the exit with a longjmp, as the	   *
+*		job server of serve.c does; if it returns the program	   *
+*		exits as usual.						   *
+*									   *
+***************************************************************************/
+
+void SetErrorExit(void (*f)(void))
+{
+ ErrorExit=f;
+}
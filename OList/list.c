@@ -88,6 +88,7 @@ List NewList(TypeList type, int size)
  l->CompareObj=NULL;
  l->type=type;
  l->hash=NULL;
+ InitPool(sizeof(ListElem),&l->pool);
  return l;
 }
 
@@ -220,7 +221,7 @@ boolean ChangeCompareObjectList(int (* comp)(void *elem1,
 boolean EqualList(List l0, List l1)
 {
  ListElem *e0,*e1;
- int i,n;
+ long i,n;
  if(!l0 || !l1) ErrorFALSE("EqualList, not initialized List.\n");
 
  if(l0->nobject!=l1->nobject) return FALSE;
@@ -255,7 +256,7 @@ boolean EqualList(List l0, List l1)
 *									   *
 ***************************************************************************/
 
-int CountList(List l)
+long CountList(List l)
 {
  if(!l) ErrorZERO("CountList, not initialized List.\n");
  return l->nobject;
@@ -297,22 +298,29 @@ int IsEmptyList(List l)
 *									   *
 *   RETURN:	TRUE if successful.					   *
 *									   *
-*  IMPORTS:	ExtractList, EraseHash					   *
+*  IMPORTS:	ExtractList, EraseHash, ErasePool			   *
 *									   *
 *    NOTES:	All the elements of the list and the List structure are    *
 *		freed. Because a List contains only pointers the objects   *
 *		it contained retain in memory.				   *
+*   19/Oct/26	The elements are freed all at once with their pool, they   *
+*		are extracted one by one only with -DNOPOOL.		   *
 *									   *
 ***************************************************************************/
 boolean EraseList(List l)
 {
+#ifdef NOPOOL
  pointer nocare;
+#endif
 
  if(!l) ErrorTRUE("EraseList, not initialized List.\n");
 
+#ifdef NOPOOL
  while(ExtractList(&nocare,l));
+#endif
 
  if(l->hash) EraseHashList(l);
+ ErasePool(&l->pool);
 
  free(l);
 
@@ -360,6 +368,7 @@ List CopyList(List l)
  NewL->CompareObj=l->CompareObj;
  NewL->type=l->type;
  NewL->hash=NULL;
+ InitPool(sizeof(ListElem),&NewL->pool);
 
  if(l->type!=CIRCULAR)
   {
@@ -372,7 +381,7 @@ List CopyList(List l)
   }
  else
   {
-   int i,n;
+   long i,n;
    n=l->nobject;
    PushCurrList(l);
    HeadList(l);
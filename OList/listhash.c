@@ -86,6 +86,7 @@ boolean HashList(int size, int (*HashKey)(void *), List l)
 
  H->size=size;
  H->HashKey=HashKey;
+ InitPool(sizeof(BuckElem),&H->pool);
  H->H=(BuckElem **)calloc(size,sizeof(BuckElem *));
  if(!H->H) ErrorFALSE("NewHash, unable to allocate Hash vector.\n");
  l->hash=H;
@@ -126,7 +127,7 @@ boolean InsertHash(ListElem *le, Hash *h)
 
  ind=ind%(h->size);
 
- bucket=(BuckElem *)malloc(sizeof(BuckElem));
+ bucket=(BuckElem *)PoolAlloc(&h->pool);
  if(!bucket) {
 	 Error("InsertHash, unable to allocate bucket.\n",NO_EXIT);
 	 return FALSE;
@@ -237,7 +238,7 @@ boolean DeleteHash(pointer obj, List l)
 	if(b->prev) (b->prev)->next=b->next;
 	       else l->hash->H[ind]=b->next;
 	if(b->next) (b->next)->prev=b->prev;
-	free(b);
+	PoolFree(b,&l->hash->pool);
 	return TRUE;
        }
    b=b->next;
@@ -263,19 +264,24 @@ boolean DeleteHash(pointer obj, List l)
 *    NOTES:	This function frees all the memory allocated for the hash  *
 *		index; for each bucket free all the BuckElem allocated in	*
 *		it. Then free the whole vector of ListElem pointers.	   *
+*   19/Oct/26	The BuckElem are freed all at once with their pool, they   *
+*		are visited one by one only with -DNOPOOL.		   *
 *									   *
 ***************************************************************************/
 boolean EraseHashList(List l)
 {
- int i;
  Hash *h;
+#ifdef NOPOOL
+ int i;
  BuckElem *next, *it;
+#endif
  if(!l->hash)
    {
     Error("EraseHash, trying to erase an unexistent hash.\n",NO_EXIT);
     return FALSE;
    }
  h=l->hash;
+#ifdef NOPOOL
  for(i=0;i<h->size;i++)	    /* For each bucket	*/
    if(h->H[i])		    /* not empty	*/
      {
@@ -288,6 +294,8 @@ boolean EraseHashList(List l)
 	 it=next;	    /* the next it is it! :)	*/
 	}
      }
+#endif
+ ErasePool(&h->pool);
  free(h->H);
  free(h);
  l->hash=NULL;
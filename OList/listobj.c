@@ -131,7 +131,7 @@ boolean InsertList(pointer object, List l)
  ListElem *t;
  ListElem *oldT;
 
- t=(ListElem *)malloc(sizeof(ListElem));
+ t=(ListElem *)PoolAlloc(&l->pool);
  if(!t) {
 	 Error("InsertList, unable to allocate ListElem\n", NO_EXIT);
 	 return FALSE;
@@ -291,8 +291,9 @@ pointer *object=(pointer *)Object;
 	 return FALSE;
 	}
  /* the following line was modified on 10 Nov 1993; previously I freed
-    elemtofree before the DeleteHash; was wrong but worked on every machine /*
- free(elemtofree);	    /* free the memory of old list element */
+    elemtofree before the DeleteHash; was wrong but worked on every machine.
+    Until 19 Oct 2026 a nested comment opener here swallowed the free. */
+ PoolFree(elemtofree,&l->pool);	    /* free the memory of old list element */
  return TRUE;
 }
 
@@ -378,7 +379,7 @@ boolean MemberList(pointer object, List l)     /* 10/Nov/92 */
 {
  pointer scanobj;
  ListElem *TempCurrList=l->C;
- int i,n;
+ long i,n;
 
  if(l->hash) return MemberHash(object, l);
 
@@ -462,7 +463,7 @@ boolean DeleteCurrList(List l)
 					else l->C=NULL;
 
 
- free(ElemToFree);
+ PoolFree(ElemToFree,&l->pool);
  l->nobject--;
  return TRUE;
 }
@@ -0,0 +1,370 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*									   *
+*    FILE:	numfile.c						   *
+*									   *
+* PURPOSE:	Reading text files of numbers in parallel.		   *
+*									   *
+* EXPORTS:	OpenNumFile   Mapping a file in memory.			   *
+*		ReadLong      Reading the next integer.			   *
+*		ReadReals     Reading in parallel vectors of reals.	   *
+*		CloseNumFile  Releasing the file.			   *
+*									   *
+* IMPORTS:	ParallelFor						   *
+*									   *
+* GLOBALS:								   *
+*									   *
+*   NOTES:	The point files have a count and then millions of reals:   *
+*		with fscanf loading them can take as long as the	   *
+*		triangulation. Here the file is mapped, cut in chunks at   *
+*		blanks, and the chunks are parsed by the threads, each	   *
+*		writing its numbers directly in their place of the vector. *
+*		A first parallel pass counts the numbers of each chunk to  *
+*		know where the numbers of the next chunk go.		   *
+*		The reals are parsed without the locale: the decimal point *
+*		is always '.'. The usual numbers, up to 15 significant	   *
+*		digits and powers of ten up to 22, are converted with one  *
+*		exact product or division, so they are correctly rounded   *
+*		as by strtod, that is used for all the others.		   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/parallel.h>
+#include <OList/numfile.h>
+
+#ifndef NOMMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+
+#define BLANK(c) ((c)==' ' || (c)=='\n' || (c)=='\t' || (c)=='\r' || \
+		  (c)=='\v' || (c)=='\f')
+
+static const double Pow10[23]={
+ 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+ 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	OpenNumFile						   *
+*									   *
+*  PURPOSE:	Map the whole text of a file in memory.			   *
+*									   *
+*   PARAMS:	The file name and the NumFile to fill.			   *
+*									   *
+*   RETURN:	F if successful,					   *
+*		NULL else.						   *
+*									   *
+*    NOTES:	If the file cannot be mapped (e.g. it is a pipe) it is	   *
+*		read in an allocated buffer.				   *
+*									   *
+***************************************************************************/
+
+NumFile *OpenNumFile(char *filename, NumFile *F)
+{
+ FILE *fp;
+ long len;
+ char *b;
+
+ F->buf=NULL;
+ F->size=0;
+ F->pos=0;
+ F->mapped=FALSE;
+
+#ifndef NOMMAP
+ {
+  struct stat st;
+  int fd=open(filename,O_RDONLY);
+
+  if(fd<0) return NULL;
+  if(fstat(fd,&st)==0 && S_ISREG(st.st_mode) && st.st_size>0)
+    {
+     b=(char *)mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+     if(b!=(char *)MAP_FAILED)
+       {
+	F->buf=b;
+	F->size=(long)st.st_size;
+	F->mapped=TRUE;
+	close(fd);
+	return F;
+       }
+    }
+  close(fd);
+ }
+#endif
+
+ fp=fopen(filename,"rb");
+ if(!fp) return NULL;
+
+ len=0;
+ F->size=NUM_CHUNK;
+ F->buf=(char *)malloc((size_t)F->size);
+ while(F->buf)
+   {
+    len+=(long)fread(F->buf+len,1,(size_t)(F->size-len),fp);
+    if(len<F->size) break;
+    F->size*=2;
+    b=(char *)realloc(F->buf,(size_t)F->size);
+    if(!b) free(F->buf);
+    F->buf=b;
+   }
+ fclose(fp);
+ if(!F->buf) ErrorNULL("OpenNumFile, not enough memory to read the file.\n");
+
+ F->size=len;
+ return F;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	ReadLong						   *
+*									   *
+*  PURPOSE:	Read the next number of the file as an integer.		   *
+*									   *
+*   PARAMS:	The NumFile and where to put the integer.		   *
+*									   *
+*   RETURN:	TRUE if successful,					   *
+*		FALSE if the file ended or the number is not an integer.   *
+*									   *
+***************************************************************************/
+
+boolean ReadLong(NumFile *F, long *x)
+{
+ char *p=F->buf+F->pos, *e=F->buf+F->size;
+ boolean neg=FALSE, digit=FALSE;
+
+ while(p<e && BLANK(*p)) p++;
+ if(p<e && (*p=='-' || *p=='+')) neg= *p++=='-';
+
+ *x=0;
+ while(p<e && *p>='0' && *p<='9')
+   {
+    *x=*x*10+(*p++-'0');
+    digit=TRUE;
+   }
+ if(neg) *x=-*x;
+
+ F->pos=(long)(p-F->buf);
+ return digit && (p==e || BLANK(*p));
+}
+
+
+/*
+ * ParseReal
+ *
+ * Converte il numero che occupa i caratteri da s a e (escluso). Le cifre
+ * significative sono accumulate in un double, esatto fino a 15 cifre; se
+ * anche la potenza di dieci e' esatta basta un prodotto o una divisione,
+ * altrimenti si usa strtod su una copia del numero.
+ */
+
+static boolean ParseReal(char *s, char *e, double *x)
+{
+ char *p=s, tmp[64], *end;
+ double m=0;
+ int nd=0, exp=0, ex=0, dot=0;
+ boolean neg=FALSE, eneg=FALSE, digit=FALSE;
+
+ if(p<e && (*p=='-' || *p=='+')) neg= *p++=='-';
+ for(;p<e;p++)
+   {
+    if(*p>='0' && *p<='9')
+      {
+       digit=TRUE;
+       if(m>0 || *p!='0')
+	 {
+	  if(nd<15) m=m*10+(*p-'0');
+	  else exp++;
+	  nd++;
+	 }
+       if(dot) exp--;
+      }
+    else if(*p=='.' && !dot) dot=1;
+    else break;
+   }
+
+ if(digit && p<e && (*p=='e' || *p=='E'))
+   {
+    p++;
+    if(p<e && (*p=='-' || *p=='+')) eneg= *p++=='-';
+    if(p==e) digit=FALSE;
+    for(;p<e && *p>='0' && *p<='9';p++)
+      if(ex<100000) ex=ex*10+(*p-'0');
+    exp+= eneg ? -ex : ex;
+   }
+
+ if(digit && p==e && nd<=15 && exp>=-22 && exp<=22)
+   {
+    *x= exp<0 ? m/Pow10[-exp] : m*Pow10[exp];
+    if(neg) *x=-*x;
+    return TRUE;
+   }
+
+ if(e-s>=(long)sizeof(tmp)) return FALSE;
+ memcpy(tmp,s,(size_t)(e-s));
+ tmp[e-s]=0;
+ *x=strtod(tmp,&end);
+ return end==tmp+(e-s);
+}
+
+
+/*
+ * ReadReals
+ *
+ * I blocchi sono tagliati in corrispondenza di uno spazio, cosi' nessun
+ * numero e' diviso fra due blocchi. Il primo passo conta i numeri di ogni
+ * blocco, il secondo li converte scrivendoli al loro posto nel vettore;
+ * Bad e' l'indice del primo numero errato di ogni blocco.
+ */
+
+typedef struct NumJobtag
+{
+ NumFile *F;
+ long Start[MAX_THREADS*NUM_SPLIT+1];	/* The chunks of the text	   */
+ long First[MAX_THREADS*NUM_SPLIT+1];	/* Numbers before each chunk	   */
+ long Bad[MAX_THREADS*NUM_SPLIT];	/* First wrong number of a chunk   */
+ long nn;				/* Numbers wanted		   */
+ int k;
+ char *vec;
+ size_t stride;
+} NumJob;
+
+static void CountBody(long from, long to, int thread, void *arg)
+{
+ NumJob *J=(NumJob *)arg;
+ char *p, *e;
+ long c, n;
+
+ for(c=from;c<to;c++)
+   {
+    p=J->F->buf+J->Start[c];
+    e=J->F->buf+J->Start[c+1];
+    n=0;
+    while(p<e)
+      {
+       while(p<e && BLANK(*p)) p++;
+       if(p==e) break;
+       n++;
+       while(p<e && !BLANK(*p)) p++;
+      }
+    J->First[c+1]=n;
+   }
+}
+
+static void ParseBody(long from, long to, int thread, void *arg)
+{
+ NumJob *J=(NumJob *)arg;
+ char *p, *e, *s;
+ long c, t;
+
+ for(c=from;c<to;c++)
+   {
+    J->Bad[c]=-1;
+    p=J->F->buf+J->Start[c];
+    e=J->F->buf+J->Start[c+1];
+    for(t=J->First[c];t<J->nn;t++)
+      {
+       while(p<e && BLANK(*p)) p++;
+       if(p==e) break;
+       s=p;
+       while(p<e && !BLANK(*p)) p++;
+       if(!ParseReal(s,p,(double *)(J->vec+(t/J->k)*J->stride)+t%J->k))
+	 {
+	  J->Bad[c]=t;
+	  break;
+	 }
+      }
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	ReadReals						   *
+*									   *
+*  PURPOSE:	Read in parallel n vectors of k reals.			   *
+*									   *
+*   PARAMS:	The NumFile, the number n of vectors and their size k, the *
+*		first real of the first vector and the distance in bytes   *
+*		between two vectors (the k reals of a vector follow each   *
+*		other).							   *
+*									   *
+*   RETURN:	The number of vectors read, less than n if the file ends   *
+*		or has a wrong number before.				   *
+*									   *
+*    NOTES:	The numbers can be separated by any blank, not necessarily *
+*		a vector for each line. The rest of the file is not read.  *
+*									   *
+***************************************************************************/
+
+long ReadReals(NumFile *F, long n, int k, double *vec, size_t stride)
+{
+ NumJob *J;
+ long nc, c, len=F->size-F->pos, good;
+
+ if(n<=0) return 0;
+
+ J=(NumJob *)malloc(sizeof(NumJob));
+ if(!J) Error("ReadReals, not enough memory.\n",EXIT);
+
+ nc=MIN((long)ThreadNum()*NUM_SPLIT, len/NUM_CHUNK+1);
+ for(c=0;c<=nc;c++)
+   {
+    J->Start[c]= c==nc ? F->size : F->pos+len/nc*c;
+    if(c>0)
+      while(J->Start[c]<F->size && !BLANK(F->buf[J->Start[c]])) J->Start[c]++;
+   }
+
+ J->F=F;
+ J->nn=n*k;
+ J->k=k;
+ J->vec=(char *)vec;
+ J->stride=stride;
+
+ ParallelFor(nc,1,CountBody,J);
+ J->First[0]=0;
+ for(c=1;c<=nc;c++) J->First[c]+=J->First[c-1];
+
+ ParallelFor(nc,1,ParseBody,J);
+
+ good=MIN(J->First[nc],J->nn);
+ for(c=0;c<nc;c++)
+   if(J->Bad[c]>=0 && J->Bad[c]<good) good=J->Bad[c];
+
+ F->pos=F->size;
+ free(J);
+ return good/k;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	CloseNumFile						   *
+*									   *
+*  PURPOSE:	Release the text of the file.				   *
+*									   *
+***************************************************************************/
+
+void CloseNumFile(NumFile *F)
+{
+#ifndef NOMMAP
+ if(F->mapped) munmap(F->buf,(size_t)F->size);
+ else
+#endif
+ free(F->buf);
+ F->buf=NULL;
+}
@@ -0,0 +1,316 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      parallel.c                                                 *
+*                                                                          *
+* PURPOSE:      Machine indipendent parallel loops.                        *
+*                                                                          *
+* EXPORTS:      SetThreadNum                                               *
+*               ThreadNum                                                  *
+*               ThreadId                                                   *
+*               InParallel                                                 *
+*               ParallelFor                                                *
+*               LockParallel                                               *
+*               UnlockParallel                                             *
+*                                                                          *
+*   NOTES:      The threads are created on the first parallel loop and    *
+*               then they wait for the next one, so a program can run     *
+*               many short loops without paying the thread creation.      *
+*               A ParallelFor called inside another one is executed by    *
+*               the calling thread.                                        *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/parallel.h>
+
+#ifndef NOTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+
+/***************************************************************************
+*                                                                          *
+* Global Variables                                                         *
+*                                                                          *
+* Requested is the number of threads asked by the user (0 means one for    *
+* each online processor). The loop currently executed is described by the *
+* Job* variables; the workers sleep on WorkCond until JobGen changes.      *
+*                                                                          *
+***************************************************************************/
+
+static int Requested=0;
+static PARALLEL_LOCAL int MyId=0;
+static PARALLEL_LOCAL int InLoop=FALSE;
+
+#ifndef NOTHREADS
+
+static int Started=0;			/* Number of running threads	  */
+static pthread_t Worker[MAX_THREADS];
+
+static pthread_mutex_t PoolMutex=PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t UserMutex=PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  WorkCond =PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  DoneCond =PTHREAD_COND_INITIALIZER;
+
+static long	    JobGen=0;		/* Incremented for each new loop  */
+static long	    StartGen=0;		/* JobGen when workers were born  */
+static int	    JobQuit=FALSE;	/* Tell the workers to terminate  */
+static int	    JobActive=0;	/* Workers still inside the loop  */
+static long	    JobN, JobGrain, JobNext;
+static ParallelBody JobBody;
+static void	   *JobArg;
+
+#endif
+
+
+/***************************************************************************
+*                                                                          *
+* FUNCTION:     SetThreadNum, ThreadNum, ThreadId                          *
+*                                                                          *
+*  PURPOSE:     Set and get the number of threads used by parallel loops  *
+*               and the number of the calling thread.                     *
+*                                                                          *
+*   PARAMS:     The number of threads; 0 means one for each processor.    *
+*                                                                          *
+*   RETURN:     ThreadNum returns the threads a loop will use,            *
+*               ThreadId a number in [0, ThreadNum()), 0 for the main one. *
+*                                                                          *
+*  IMPORTS:     None                                                       *
+*                                                                          *
+*    NOTES:     Changing the number of threads stops the running workers, *
+*               the next loop will start the new ones.                    *
+*                                                                          *
+***************************************************************************/
+
+#ifndef NOTHREADS
+static void StopWorkers(void)
+{
+ int i;
+
+ if(Started<=1) { Started=0; return; }
+
+ pthread_mutex_lock(&PoolMutex);
+ JobQuit=TRUE;
+ JobGen++;
+ pthread_cond_broadcast(&WorkCond);
+ pthread_mutex_unlock(&PoolMutex);
+
+ for(i=1;i<Started;i++) pthread_join(Worker[i],NULL);
+
+ JobQuit=FALSE;
+ Started=0;
+}
+#endif
+
+void SetThreadNum(int n)
+{
+ if(n<0) n=0;
+ if(n>MAX_THREADS) n=MAX_THREADS;
+#ifndef NOTHREADS
+ if(n!=Requested) StopWorkers();
+#endif
+ Requested=n;
+}
+
+int ThreadNum(void)
+{
+#ifdef NOTHREADS
+ return 1;
+#else
+ long n=Requested;
+
+ if(n==0)
+   {
+#ifdef _SC_NPROCESSORS_ONLN
+    n=sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if(n<1) n=1;
+   }
+ return (int)MIN(n,MAX_THREADS);
+#endif
+}
+
+int ThreadId(void)
+{
+ return MyId;
+}
+
+/***************************************************************************
+*                                                                          *
+* FUNCTION:     InParallel                                                 *
+*                                                                          *
+*  PURPOSE:     Tell whether the calling thread is running the chunks of   *
+*               a parallel loop, so the other threads may be in it too.    *
+*                                                                          *
+***************************************************************************/
+
+int InParallel(void)
+{
+ return InLoop;
+}
+
+
+/***************************************************************************
+*                                                                          *
+* FUNCTION:     RunChunks                                                  *
+*                                                                          *
+*  PURPOSE:     Execute chunks of the current loop until none is left.    *
+*                                                                          *
+*    NOTES:     Chunks are given on a first come first served basis, so   *
+*               unbalanced iterations are spread among the threads.       *
+*                                                                          *
+***************************************************************************/
+
+#ifndef NOTHREADS
+static void RunChunks(void)
+{
+ long from;
+
+ InLoop=TRUE;
+ for(;;)
+  {
+   pthread_mutex_lock(&PoolMutex);
+   from=JobNext;
+   JobNext+=JobGrain;
+   pthread_mutex_unlock(&PoolMutex);
+
+   if(from>=JobN) break;
+   JobBody(from, MIN(from+JobGrain,JobN), MyId, JobArg);
+  }
+ InLoop=FALSE;
+}
+
+static void *WorkerMain(void *Id)
+{
+ long seen=0;
+
+ MyId=(int)(long)Id;
+
+ pthread_mutex_lock(&PoolMutex);
+ seen=StartGen;
+ for(;;)
+  {
+   while(JobGen==seen) pthread_cond_wait(&WorkCond,&PoolMutex);
+   seen=JobGen;
+   if(JobQuit) break;
+   pthread_mutex_unlock(&PoolMutex);
+
+   RunChunks();
+
+   pthread_mutex_lock(&PoolMutex);
+   if(--JobActive==0) pthread_cond_signal(&DoneCond);
+  }
+ pthread_mutex_unlock(&PoolMutex);
+ return NULL;
+}
+
+static void StartWorkers(int n)
+{
+ long i;
+
+ Started=1;
+ StartGen=JobGen;
+ for(i=1;i<n;i++)
+  {
+   if(pthread_create(&Worker[i],NULL,WorkerMain,(void *)i)!=0)
+     {
+      Error("StartWorkers, unable to create a thread, going on with less.\n",
+	    NO_EXIT);
+      break;
+     }
+   Started++;
+  }
+}
+#endif
+
+
+/***************************************************************************
+*                                                                          *
+* FUNCTION:     ParallelFor                                                *
+*                                                                          *
+*  PURPOSE:     Execute body on the iterations [0, n) using all the       *
+*               threads.                                                   *
+*                                                                          *
+*   PARAMS:     The number of iterations, the number of iterations given  *
+*               to a thread at once (0 for an automatic value), the       *
+*               function to execute and its argument.                     *
+*                                                                          *
+*   RETURN:     Nothing, it returns when all the iterations are done.     *
+*                                                                          *
+*    NOTES:     The body is called with disjoint [from, to) ranges and    *
+*               the number of the executing thread, that can be used to   *
+*               index per thread data without locking.                    *
+*                                                                          *
+***************************************************************************/
+
+void ParallelFor(long n, long grain, ParallelBody body, void *arg)
+{
+#ifndef NOTHREADS
+ int threads;
+#endif
+
+ if(n<=0) return;
+
+#ifndef NOTHREADS
+ threads=ThreadNum();
+ if(grain<=0) grain=MAX(1,n/(threads*8));
+
+ if(threads>1 && !InLoop && n>grain)
+   {
+    if(Started!=threads) { StopWorkers(); StartWorkers(threads); }
+
+    pthread_mutex_lock(&PoolMutex);
+    JobBody=body;
+    JobArg=arg;
+    JobN=n;
+    JobGrain=grain;
+    JobNext=0;
+    JobActive=Started-1;
+    JobGen++;
+    pthread_cond_broadcast(&WorkCond);
+    pthread_mutex_unlock(&PoolMutex);
+
+    RunChunks();
+
+    pthread_mutex_lock(&PoolMutex);
+    while(JobActive>0) pthread_cond_wait(&DoneCond,&PoolMutex);
+    pthread_mutex_unlock(&PoolMutex);
+    return;
+   }
+#endif
+
+ body(0,n,MyId,arg);
+}
+
+
+/***************************************************************************
+*                                                                          *
+* FUNCTION:     LockParallel, UnlockParallel                               *
+*                                                                          *
+*  PURPOSE:     A global mutual exclusion for the rare operations of a    *
+*               parallel body that touch shared data (e.g. reporting).    *
+*                                                                          *
+***************************************************************************/
+
+void LockParallel(void)
+{
+#ifndef NOTHREADS
+ pthread_mutex_lock(&UserMutex);
+#endif
+}
+
+void UnlockParallel(void)
+{
+#ifndef NOTHREADS
+ pthread_mutex_unlock(&UserMutex);
+#endif
+}
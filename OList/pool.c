@@ -0,0 +1,178 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*									   *
+*    FILE:	pool.c							   *
+*									   *
+* PURPOSE:	Allocating the ListElem and BuckElem of a list in blocks.  *
+*									   *
+* EXPORTS:	InitPool      Initializing an empty pool.		   *
+*		PoolAlloc     Getting a node from a pool.		   *
+*		PoolFree      Giving back a node to its pool.		   *
+*		ErasePool     Freeing all the nodes of a pool at once.	   *
+*									   *
+* IMPORTS:								   *
+*									   *
+* GLOBALS:								   *
+*									   *
+*   NOTES:	Each list has a pool for its ListElem and each hash index  *
+*		one for its BuckElem. Nodes are cut from blocks that grow  *
+*		from POOL_FIRST_BLOCK to POOL_MAX_BLOCK nodes, so a short  *
+*		list wastes little memory and a long one calls malloc	   *
+*		rarely. Freed nodes are chained and given again by	   *
+*		PoolAlloc; the memory goes back to the system only with	   *
+*		ErasePool, that frees the blocks without visiting the	   *
+*		nodes.							   *
+*		A pool is not locked: as the list it belongs to, it must   *
+*		be changed by one thread at a time.			   *
+*		Compiling with -DNOPOOL every node is a malloc as before,  *
+*		that is useful with the memory debuggers.		   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <OList/general.h>
+#include <OList/olist.h>
+#include <OList/error.h>
+
+#define POOL_FIRST_BLOCK   16
+#define POOL_MAX_BLOCK	 4096
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	InitPool						   *
+*									   *
+*  PURPOSE:	Initializing an empty pool.				   *
+*									   *
+*   PARAMS:	The size of the nodes and the pool.			   *
+*									   *
+*   RETURN:	None							   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	No memory is allocated until the first PoolAlloc.	   *
+*		The nodes must be large enough to contain a pointer.	   *
+*									   *
+***************************************************************************/
+
+void InitPool(int nodesize, Pool *p)
+{
+ p->free=NULL;
+ p->block=NULL;
+ p->next=NULL;
+ p->end=NULL;
+ p->nodesize=MAX(nodesize,(int)sizeof(pointer));
+ p->blocknodes=POOL_FIRST_BLOCK;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	PoolAlloc						   *
+*									   *
+*  PURPOSE:	Getting a node from a pool.				   *
+*									   *
+*   PARAMS:	The pool.						   *
+*									   *
+*   RETURN:	The node if successful,					   *
+*		NULL else.						   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	The first node of each block is used to chain the blocks,  *
+*		the freed nodes are chained through their first pointer.   *
+*									   *
+***************************************************************************/
+
+pointer PoolAlloc(Pool *p)
+{
+ pointer node;
+ char *b;
+
+#ifdef NOPOOL
+ return malloc(p->nodesize);
+#else
+ if(p->free)				/* Prima i nodi liberati	*/
+   {
+    node=p->free;
+    p->free=*(pointer *)node;
+    return node;
+   }
+
+ if(p->next==p->end)			/* Blocco finito, ne serve un	*/
+   {					/* altro (il primo nodo per la	*/
+    b=(char *)malloc((size_t)(p->blocknodes+1)*p->nodesize);    /* catena) */
+    if(!b) ErrorNULL("PoolAlloc, unable to allocate a block of nodes.\n");
+
+    *(pointer *)b=p->block;
+    p->block=b;
+    p->next=b+p->nodesize;
+    p->end=p->next+(size_t)p->blocknodes*p->nodesize;
+    if(p->blocknodes<POOL_MAX_BLOCK) p->blocknodes*=2;
+   }
+
+ node=p->next;
+ p->next+=p->nodesize;
+ return node;
+#endif
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	PoolFree						   *
+*									   *
+*  PURPOSE:	Giving back a node to its pool.				   *
+*									   *
+*   PARAMS:	The node and the pool it came from.			   *
+*									   *
+*   RETURN:	None							   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+***************************************************************************/
+
+void PoolFree(pointer node, Pool *p)
+{
+#ifdef NOPOOL
+ free(node);
+#else
+ *(pointer *)node=p->free;
+ p->free=node;
+#endif
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	ErasePool						   *
+*									   *
+*  PURPOSE:	Freeing all the nodes of a pool at once.		   *
+*									   *
+*   PARAMS:	The pool.						   *
+*									   *
+*   RETURN:	None							   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	All the nodes, used or not, become invalid; the pool is	   *
+*		empty and can be used again. With -DNOPOOL it does nothing *
+*		and the nodes must be freed one by one.			   *
+*									   *
+***************************************************************************/
+
+void ErasePool(Pool *p)
+{
+ pointer b, next;
+
+ for(b=p->block;b;b=next)
+   {
+    next=*(pointer *)b;
+    free(b);
+   }
+ InitPool(p->nodesize,p);
+}
@@ -0,0 +1,257 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*									   *
+*    FILE:	serve.c							   *
+*									   *
+* PURPOSE:	Running the jobs sent on a Unix domain socket.		   *
+*									   *
+* EXPORTS:	ServeJobs     Serving the jobs until "quit".		   *
+*									   *
+* IMPORTS:	SetErrorExit, ThreadId, InParallel			   *
+*									   *
+* GLOBALS:								   *
+*									   *
+*   NOTES:	Many small jobs spend more time starting the program and   *
+*		its threads than triangulating. A server process runs	   *
+*		the jobs one after the other, each with all the threads,   *
+*		and keeps between them the threads of parallel.c and the   *
+*		memory already taken by malloc. See serve.h for the	   *
+*		protocol.						   *
+*		The files are exchanged by name: a job can read and write  *
+*		them in /dev/shm, where the points are mapped by numfile.c *
+*		and nothing touches the disk.				   *
+*		A job that calls Error with EXIT returns to the server	   *
+*		with a longjmp, but only when the error is in the main	   *
+*		thread and outside a parallel loop, where no other thread  *
+*		can be in the middle of the job; the others still end the  *
+*		server. The memory that the job had not freed yet is lost. *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <setjmp.h>
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/parallel.h>
+#include <OList/serve.h>
+
+#ifndef NOSOCKET
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+
+#ifndef NOSOCKET
+
+static jmp_buf JobJump;
+static int     JobRunning=FALSE;
+
+
+/*
+ * JobError
+ *
+ * Chiamata da Error prima di uscire: se si puo', torna al server.
+ */
+
+static void JobError(void)
+{
+ if(JobRunning && ThreadId()==0 && !InParallel())
+   {
+    JobRunning=FALSE;
+    longjmp(JobJump,1);
+   }
+}
+
+
+/*
+ * ReadRequest
+ *
+ * Legge dalla connessione c la riga della richiesta, senza il '\n'.
+ * Restituisce FALSE se la connessione si chiude prima o la riga e' troppo
+ * lunga.
+ */
+
+static boolean ReadRequest(int c, char *line, int size)
+{
+ int len=0;
+ ssize_t r;
+
+ for(;;)
+  {
+   r=read(c,line+len,1);
+   if(r<0 && errno==EINTR) continue;
+   if(r<=0 || len==size-1) return FALSE;
+   if(line[len]=='\n') break;
+   len++;
+  }
+ if(len>0 && line[len-1]=='\r') len--;
+ line[len]=0;
+ return TRUE;
+}
+
+
+/*
+ * SplitWords
+ *
+ * Divide la riga in argomenti separati da blank, dopo argv[0]. Tutto
+ * argv dopo l'ultimo argomento e' NULL, anche oltre argv[argc]: un'opzione
+ * che legge un argomento in piu' trova NULL e non la richiesta precedente.
+ */
+
+static int SplitWords(char *line, char *argv[])
+{
+ int argc=1, i;
+ char *s;
+
+ for(s=strtok(line," \t");s && argc<SERVE_ARGS;s=strtok(NULL," \t"))
+   argv[argc++]=s;
+ for(i=argc;i<=SERVE_ARGS;i++) argv[i]=NULL;
+ return s ? -1 : argc;
+}
+
+
+/*
+ * RunJob
+ *
+ * Esegue il job e ne restituisce il codice, -1 se e' finito in Error. Il
+ * setjmp sta qui e non in ServeJobs, cosi' nessuna variabile del server e'
+ * viva attraverso il longjmp.
+ */
+
+static int RunJob(ServeJob job, int argc, char *argv[])
+{
+ int code;
+
+ if(setjmp(JobJump)!=0) return -1;
+ JobRunning=TRUE;
+ code=job(argc,argv);
+ JobRunning=FALSE;
+ return code;
+}
+
+
+/*
+ * OpenSocket
+ *
+ * Crea il socket in ascolto su path. Un vecchio socket rimasto da un
+ * server terminato viene rimosso, un altro file no.
+ */
+
+static int OpenSocket(char *path)
+{
+ struct sockaddr_un addr;
+ struct stat st;
+ int s;
+
+ if(strlen(path)>=sizeof(addr.sun_path))
+   Errorf(EXIT,"ServeJobs, socket name too long '%s'\n",path);
+ if(stat(path,&st)==0 && S_ISSOCK(st.st_mode)) unlink(path);
+
+ memset(&addr,0,sizeof(addr));
+ addr.sun_family=AF_UNIX;
+ strcpy(addr.sun_path,path);
+
+ s=socket(AF_UNIX,SOCK_STREAM,0);
+ if(s<0) Error("ServeJobs, unable to create a socket\n",EXIT);
+ if(bind(s,(struct sockaddr *)&addr,sizeof(addr))<0 ||
+    listen(s,SERVE_BACKLOG)<0)
+   Errorf(EXIT,"ServeJobs, unable to listen on '%s'\n",path);
+ return s;
+}
+
+#endif
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	ServeJobs						   *
+*									   *
+*  PURPOSE:	Run the jobs sent on the socket path until one is "quit".  *
+*									   *
+*   PARAMS:	The socket file name, the program name given to the jobs   *
+*		as argv[0] and the function running a job.		   *
+*									   *
+*   RETURN:	Nothing, it returns after the "quit" job.		   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	The jobs are run one at a time, the clients that connect   *
+*		meanwhile wait. A client that disconnects before the end   *
+*		of its job does not stop the job, its output is lost.	   *
+*									   *
+***************************************************************************/
+
+void ServeJobs(char *path, char *name, ServeJob job)
+{
+#ifdef NOSOCKET
+ Error("ServeJobs, no sockets on this machine\n",EXIT);
+#else
+ char line[SERVE_LINE], *argv[SERVE_ARGS+1];
+ int s, c, argc, out, err, code;
+
+ s=OpenSocket(path);
+ signal(SIGPIPE,SIG_IGN);		/* A client gone is not an error */
+ setvbuf(stdout,NULL,_IOFBF,BUFSIZ);
+ fflush(stderr);
+ out=dup(1);
+ err=dup(2);
+ if(out<0 || err<0) Error("ServeJobs, unable to duplicate stdout\n",EXIT);
+ SetErrorExit(JobError);
+
+ for(;;)
+  {
+   c=accept(s,NULL,NULL);
+   if(c<0)
+     {
+      if(errno==EINTR || errno==ECONNABORTED) continue;
+      Error("ServeJobs, unable to accept a connection\n",EXIT);
+     }
+   if(!ReadRequest(c,line,SERVE_LINE))
+     {
+      close(c);
+      continue;
+     }
+
+   argv[0]=name;
+   argc=SplitWords(line,argv);
+   if(argc==2 && strcmp(argv[1],"quit")==0)
+     {
+      write(c,"Exit: 0\n",8);
+      close(c);
+      break;
+     }
+
+   dup2(c,1);
+   dup2(c,2);
+   if(argc<0)
+     {
+      Errorf(NO_EXIT,"ServeJobs, more than %d arguments\n",SERVE_ARGS-1);
+      code= -1;
+     }
+   else code=RunJob(job,argc,argv);
+   printf("Exit: %d\n",code);
+
+   fflush(stdout);
+   clearerr(stdout);
+   dup2(out,1);
+   dup2(err,2);
+   close(c);
+  }
+
+ SetErrorExit(NULL);
+ close(out);
+ close(err);
+ close(s);
+ unlink(path);
+#endif
+}
@@ -0,0 +1,389 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*									   *
+*    FILE:	store.c							   *
+*									   *
+* PURPOSE:	Implementing Store, a growable vector of objects.	   *
+*									   *
+* EXPORTS:	NewStore      Creating a new empty Store.		   *
+*		AppendStore   Appending a copy of an object.		   *
+*		CountStore    Counting the objects of a Store.		   *
+*		HashStore     Building an hash index over a Store.	   *
+*		MemberStore   Finding an object through the hash index.	   *
+*		Store2Vector  Turning a Store in a plain vector.	   *
+*		Vector2Store  Turning a plain vector in a Store.	   *
+*		EraseStore    Erasing a Store freeing all the memory.	   *
+*									   *
+* IMPORTS:								   *
+*									   *
+* GLOBALS:								   *
+*									   *
+*   NOTES:	A Store is meant for the many small objects that a program *
+*		only builds and then writes, as the tetrahedra of a	   *
+*		triangulation: in a List each of them would cost a malloc  *
+*		and a ListElem. The objects are copied in chunks of	   *
+*		STORE_CHUNK, so appending is O(1) and never moves the	   *
+*		objects already stored.					   *
+*		As a List, a Store must be changed by one thread at a	   *
+*		time; reading it in parallel with StoreElem is safe.	   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/store.h>
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	NewStore						   *
+*									   *
+*  PURPOSE:	Create a new empty Store.				   *
+*									   *
+*   PARAMS:	The size of the objects.				   *
+*									   *
+*   RETURN:	The created Store if successful,			   *
+*		NULL else.						   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+***************************************************************************/
+
+Store NewStore(int size)
+{
+ Store s;
+
+ s=(Store)malloc(sizeof(struct Storetag));
+ if(!s) ErrorNULL("NewStore, unable to allocate Store\n");
+
+ s->objectsize=size;
+ s->nobject=0;
+ s->chunk=NULL;
+ s->maxchunk=0;
+ s->hash=NULL;
+ return s;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	SlotHash						   *
+*									   *
+*  PURPOSE:	The first slot to probe for an object.			   *
+*									   *
+*    NOTES:	The user key is mixed, so also keys that differ only in    *
+*		the high bits spread over the whole table.		   *
+*									   *
+***************************************************************************/
+
+static long SlotHash(pointer object, StoreHash *h)
+{
+ unsigned long k=(unsigned int)h->HashKey(object);
+
+ k^=k>>16;
+ k*=0x45d9f3bUL;
+ k^=k>>16;
+ return (long)(k&(h->size-1));
+}
+
+/* Inserisce l'oggetto di indice i nella tabella, che non e' piena. */
+static void InsertSlot(long i, Store s)
+{
+ StoreHash *h=s->hash;
+ long j=SlotHash(StoreElem(i,s),h);
+
+ while(h->slot[j]) j=(j+1)&(h->size-1);
+ h->slot[j]=i+1;
+}
+
+/* Raddoppia la tabella e vi reinserisce tutti gli oggetti. */
+static boolean GrowHash(Store s)
+{
+ long *slot, i;
+
+ slot=(long *)calloc((size_t)s->hash->size*2,sizeof(long));
+ if(!slot) ErrorFALSE("GrowHash, unable to enlarge the Store hash.\n");
+
+ free(s->hash->slot);
+ s->hash->slot=slot;
+ s->hash->size*=2;
+ for(i=0;i<s->nobject;i++) InsertSlot(i,s);
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	AppendStore						   *
+*									   *
+*  PURPOSE:	Append a copy of an object to a Store.			   *
+*									   *
+*   PARAMS:	The pointer to the object and the Store.		   *
+*									   *
+*   RETURN:	The pointer to the stored copy if successful,		   *
+*		NULL else.						   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	If the Store is hashed the copy is added to the index.	   *
+*									   *
+***************************************************************************/
+
+pointer AppendStore(pointer object, Store s)
+{
+ long c=s->nobject>>STORE_SHIFT;
+ char **chunk;
+ pointer elem;
+
+ if(c==s->maxchunk)			/* Serve un vettore dei chunk	*/
+   {					/* piu' grande.			*/
+    chunk=(char **)realloc(s->chunk,(size_t)MAX(2*s->maxchunk,16)*sizeof(char *));
+    if(!chunk) ErrorNULL("AppendStore, unable to allocate chunk vector\n");
+    s->chunk=chunk;
+    s->maxchunk=MAX(2*s->maxchunk,16);
+   }
+ if((s->nobject&(STORE_CHUNK-1))==0)	/* Chunk pieno o primo oggetto	*/
+   {
+    s->chunk[c]=(char *)malloc((size_t)STORE_CHUNK*s->objectsize);
+    if(!s->chunk[c]) ErrorNULL("AppendStore, unable to allocate chunk\n");
+   }
+
+ elem=StoreElem(s->nobject,s);
+ memcpy(elem,object,(size_t)s->objectsize);
+ s->nobject++;
+
+ if(s->hash)
+   {
+    if(2*s->nobject > s->hash->size) GrowHash(s);
+    else InsertSlot(s->nobject-1,s);
+   }
+ return elem;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	CountStore						   *
+*									   *
+*  PURPOSE:	Counting the objects of a Store.			   *
+*									   *
+***************************************************************************/
+
+long CountStore(Store s)
+{
+ if(!s) ErrorZERO("CountStore, not initialized Store.\n");
+ return s->nobject;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	HashStore						   *
+*									   *
+*  PURPOSE:	Build an hash index over a Store.			   *
+*									   *
+*   PARAMS:	The expected number of objects, the hash function, the	   *
+*		equality function and the Store.			   *
+*									   *
+*   RETURN:	TRUE if successful,					   *
+*		FALSE else.						   *
+*									   *
+*  IMPORTS:	None							   *
+*									   *
+*    NOTES:	As for HashList, equal objects must have equal keys. The   *
+*		table is sized to hold size objects at half load and then  *
+*		grows with the Store, so size is only a hint.		   *
+*									   *
+***************************************************************************/
+
+boolean HashStore(long size, int (*HashKey)(pointer),
+		  boolean (*eq)(pointer, pointer), Store s)
+{
+ StoreHash *h;
+ long i;
+
+ if(s->hash) ErrorFALSE("HashStore, Hash index already existing.\n");
+
+ h=(StoreHash *)malloc(sizeof(StoreHash));
+ if(!h) ErrorFALSE("HashStore, unable to allocate Hash struct.\n");
+
+ for(h->size=16; h->size < 2*MAX(size,s->nobject); h->size*=2);
+ h->slot=(long *)calloc((size_t)h->size,sizeof(long));
+ if(!h->slot) ErrorFALSE("HashStore, unable to allocate Hash vector.\n");
+ h->HashKey=HashKey;
+ h->EqualObj=eq;
+ s->hash=h;
+
+ for(i=0;i<s->nobject;i++) InsertSlot(i,s);
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	MemberStore						   *
+*									   *
+*  PURPOSE:	Find an object equal to the given one in a hashed Store.   *
+*									   *
+*   PARAMS:	The object to find and the Store.			   *
+*									   *
+*   RETURN:	The pointer to the stored object if found,		   *
+*		NULL else.						   *
+*									   *
+***************************************************************************/
+
+pointer MemberStore(pointer object, Store s)
+{
+ StoreHash *h=s->hash;
+ pointer elem;
+ long j;
+
+ if(!h) ErrorNULL("MemberStore, Store not hashed!\n");
+
+ for(j=SlotHash(object,h); h->slot[j]; j=(j+1)&(h->size-1))
+   {
+    elem=StoreElem(h->slot[j]-1,s);
+    if(h->EqualObj(object,elem)) return elem;
+   }
+ return NULL;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	Store2Vector						   *
+*									   *
+*  PURPOSE:	Turn a Store in a plain vector of its objects.		   *
+*									   *
+*   PARAMS:	The Store.						   *
+*									   *
+*   RETURN:	The vector, in the order of appending, if successful;	   *
+*		NULL else.						   *
+*									   *
+*  IMPORTS:	EraseStore						   *
+*									   *
+*    NOTES:	The Store is erased and the caller owns the vector. The    *
+*		first chunk becomes the vector, so a Store of one chunk is *
+*		given without copying. Else the first chunk grows to the   *
+*		whole vector while the other chunks are still there: for a *
+*		moment the memory used is about twice the objects, then	   *
+*		the other chunks are copied and freed one at a time. Use   *
+*		StoreElem on the chunks where the objects are too many to  *
+*		be held twice.						   *
+*									   *
+***************************************************************************/
+
+pointer Store2Vector(Store s)
+{
+ char *vec;
+ long c, nchunk=(s->nobject+STORE_CHUNK-1)>>STORE_SHIFT;
+ size_t chunksize=(size_t)STORE_CHUNK*s->objectsize;
+
+ if(nchunk==0) vec=(char *)malloc((size_t)s->objectsize);
+ else vec=(char *)realloc(s->chunk[0],(size_t)MAX(s->nobject,1)*s->objectsize);
+ if(!vec) ErrorNULL("Store2Vector, unable to allocate the vector\n");
+
+ if(nchunk) s->chunk[0]=NULL;
+ for(c=1;c<nchunk;c++)
+   {
+    memcpy(vec+c*chunksize,s->chunk[c],
+	   (size_t)MIN(STORE_CHUNK,s->nobject-c*STORE_CHUNK)*s->objectsize);
+    free(s->chunk[c]);
+    s->chunk[c]=NULL;
+   }
+
+ EraseStore(s);
+ return vec;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	Vector2Store						   *
+*									   *
+*  PURPOSE:	Turn a plain vector of objects in a Store.		   *
+*									   *
+*   PARAMS:	The vector, allocated by malloc, the number and the size   *
+*		of its objects.						   *
+*									   *
+*   RETURN:	The Store, with the objects in the order of the vector, if *
+*		successful; NULL else.					   *
+*									   *
+*  IMPORTS:	NewStore						   *
+*									   *
+*    NOTES:	The Store owns the vector, that must not be used any more. *
+*		The chunks are copied from the last one and the vector is  *
+*		shrunk after each copy, so the memory used never exceeds   *
+*		the objects plus a chunk; the first chunk of the vector    *
+*		becomes the first chunk of the Store. It undoes		   *
+*		Store2Vector, e.g. after sorting the vector.		   *
+*									   *
+***************************************************************************/
+
+Store Vector2Store(pointer vec, long n, int size)
+{
+ Store s;
+ char *v=(char *)vec, *p;
+ long c, nchunk=(n+STORE_CHUNK-1)>>STORE_SHIFT;
+ size_t chunksize=(size_t)STORE_CHUNK*size;
+
+ s=NewStore(size);
+ if(!s) return NULL;
+ if(nchunk==0)
+   {
+    free(v);
+    return s;
+   }
+
+ s->chunk=(char **)malloc((size_t)nchunk*sizeof(char *));
+ if(!s->chunk) ErrorNULL("Vector2Store, unable to allocate chunk vector\n");
+ s->maxchunk=nchunk;
+
+ for(c=nchunk-1;c>0;c--)
+   {
+    s->chunk[c]=(char *)malloc(chunksize);
+    if(!s->chunk[c]) ErrorNULL("Vector2Store, unable to allocate chunk\n");
+    memcpy(s->chunk[c],v+c*chunksize,(size_t)MIN(STORE_CHUNK,n-c*STORE_CHUNK)*size);
+    p=(char *)realloc(v,c*chunksize);	/* Il resto torna all'allocatore */
+    if(p) v=p;
+   }
+ p=(char *)realloc(v,chunksize);		/* Un chunk intero, come in	 */
+ s->chunk[0]= p ? p : v;			/* AppendStore			 */
+ s->nobject=n;
+ return s;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	EraseStore						   *
+*									   *
+*  PURPOSE:	Erase a Store freeing all the memory.			   *
+*									   *
+*   RETURN:	TRUE if successful.					   *
+*									   *
+***************************************************************************/
+
+boolean EraseStore(Store s)
+{
+ long c, nchunk;
+
+ if(!s) ErrorTRUE("EraseStore, not initialized Store.\n");
+
+ nchunk=(s->nobject+STORE_CHUNK-1)>>STORE_SHIFT;
+ for(c=0;c<nchunk;c++) free(s->chunk[c]);
+ free(s->chunk);
+ if(s->hash)
+   {
+    free(s->hash->slot);
+    free(s->hash);
+   }
+ free(s);
+ return TRUE;
+}
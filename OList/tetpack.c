@@ -0,0 +1,456 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*									   *
+*    FILE:	tetpack.c						   *
+*									   *
+* PURPOSE:	Writing and reading packed tetrahedra files.		   *
+*									   *
+* EXPORTS:	WriteTetPack  Writing a vector of tetrahedra packed.	   *
+*		OpenTetPack   Reading the header of a packed file.	   *
+*		ReadTetPack   Reading the next block of tetrahedra.	   *
+*		CloseTetPack  Releasing the reader.			   *
+*									   *
+* IMPORTS:	ParallelFor						   *
+*									   *
+* GLOBALS:								   *
+*									   *
+*   NOTES:	A text tetrahedra file costs about 28 bytes for each	   *
+*		tetrahedron. Sorted, the tetrahedra that share their	   *
+*		smallest vertex follow each other and most of the vertex   *
+*		indexes are coded as small differences in one or two	   *
+*		bytes (see tetpack.h for the format).			   *
+*		The vector is sorted in place: each vertex is the smallest *
+*		of about 6 tetrahedra, so a counting sort on the smallest  *
+*		vertex leaves a qsort of a few tetrahedra for each vertex, *
+*		done in parallel. The blocks are then coded in parallel,   *
+*		one for each thread at a time, and written in order.	   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/parallel.h>
+#include <OList/tetpack.h>
+
+
+typedef struct PackJobtag
+{
+ pindex *t;
+ long nt;
+ long *Start;			/* The tetrahedra of each smallest vertex  */
+ long first;			/* First block of the round		   */
+ unsigned char *buf;		/* A block for each thread		   */
+ long Len[MAX_THREADS];		/* Bytes of each block of the round	   */
+} PackJob;
+
+
+/*
+ * PutVar, GetVar
+ *
+ * Scrivono e leggono un varint: 7 bit per byte, dal meno significativo,
+ * con il bit alto a 1 se segue un altro byte.
+ */
+
+static unsigned char *PutVar(unsigned char *p, unsigned long x)
+{
+ while(x>=0x80)
+   {
+    *p++=(unsigned char)(x|0x80);
+    x>>=7;
+   }
+ *p++=(unsigned char)x;
+ return p;
+}
+
+static boolean GetVar(unsigned char **p, unsigned char *e, unsigned long *x)
+{
+ unsigned char *q=*p;
+ int s=0;
+
+ *x=0;
+ do {
+    if(q==e || s>=(int)sizeof(long)*8) return FALSE;
+    *x|=(unsigned long)(*q&0x7f)<<s;
+    s+=7;
+   } while(*q++&0x80);
+ *p=q;
+ return TRUE;
+}
+
+static boolean GetFileVar(FILE *fp, unsigned long *x)
+{
+ int c, s=0;
+
+ *x=0;
+ do {
+    if((c=getc(fp))==EOF || s>=(int)sizeof(long)*8) return FALSE;
+    *x|=(unsigned long)(c&0x7f)<<s;
+    s+=7;
+   } while(c&0x80);
+ return TRUE;
+}
+
+
+/*
+ * SortVertexBody
+ *
+ * Ordina i vertici di ogni tetraedro; se la permutazione e' dispari
+ * scambia gli ultimi due, cosi' l'orientamento non cambia.
+ */
+
+static void SortVertexBody(long from, long to, int thread, void *arg)
+{
+ PackJob *J=(PackJob *)arg;
+ pindex *v, a;
+ long i;
+ int j, k, odd;
+
+ for(i=from;i<to;i++)
+   {
+    v=J->t+4*i;
+    odd=0;
+    for(j=1;j<4;j++)
+      {
+       a=v[j];
+       for(k=j-1; k>=0 && v[k]>a; k--)
+	 {
+	  v[k+1]=v[k];
+	  odd^=1;
+	 }
+       v[k+1]=a;
+      }
+    if(odd)
+      {
+       a=v[2]; v[2]=v[3]; v[3]=a;
+      }
+   }
+}
+
+
+/*
+ * CompareTetra, SortBucketBody
+ *
+ * Ordinano i tetraedri con lo stesso vertice minimo; gli ultimi due
+ * vertici possono essere scambiati e sono confrontati come minimo e
+ * massimo.
+ */
+
+static int CompareTetra(const void *T0, const void *T1)
+{
+ pindex *t0=(pindex *)T0, *t1=(pindex *)T1;
+ pindex a, b;
+
+ if(t0[1]!=t1[1]) return t0[1]<t1[1] ? -1 : 1;
+ a=MIN(t0[2],t0[3]);
+ b=MIN(t1[2],t1[3]);
+ if(a!=b) return a<b ? -1 : 1;
+ a=MAX(t0[2],t0[3]);
+ b=MAX(t1[2],t1[3]);
+ if(a!=b) return a<b ? -1 : 1;
+ return 0;
+}
+
+static void SortBucketBody(long from, long to, int thread, void *arg)
+{
+ PackJob *J=(PackJob *)arg;
+ long k;
+
+ for(k=from;k<to;k++)
+   if(J->Start[k+1]-J->Start[k]>1)
+     qsort(J->t+4*J->Start[k],(size_t)(J->Start[k+1]-J->Start[k]),
+	   4*sizeof(pindex),CompareTetra);
+}
+
+
+/*
+ * EncodeBody
+ *
+ * Codifica i blocchi del giro, il blocco first+b nella b-esima parte
+ * di buf.
+ */
+
+static void EncodeBody(long from, long to, int thread, void *arg)
+{
+ PackJob *J=(PackJob *)arg;
+ unsigned char *p;
+ pindex prev[4], *v;
+ unsigned long o;
+ long b, i, last;
+
+ for(b=from;b<to;b++)
+   {
+    p=J->buf+b*TETPACK_BLOCK*4*TETPACK_VARMAX;
+    i=(J->first+b)*TETPACK_BLOCK;
+    last=MIN(i+TETPACK_BLOCK,J->nt);
+    prev[0]=prev[1]=prev[2]=prev[3]=0;
+
+    for(;i<last;i++)
+      {
+       v=J->t+4*i;
+       o= v[2]>v[3];
+       if(o)
+	 {
+	  v[2]^=v[3]; v[3]^=v[2]; v[2]^=v[3];
+	 }
+
+       if(v[0]!=prev[0])
+	 {
+	  p=PutVar(p,(unsigned long)(v[0]-prev[0]));
+	  p=PutVar(p,(unsigned long)(v[1]-v[0]));
+	  p=PutVar(p,(unsigned long)(v[2]-v[1]));
+	  p=PutVar(p,(unsigned long)(v[3]-v[2])*2+o);
+	 }
+       else if(v[1]!=prev[1])
+	 {
+	  *p++=0;
+	  p=PutVar(p,(unsigned long)(v[1]-prev[1]));
+	  p=PutVar(p,(unsigned long)(v[2]-v[1]));
+	  p=PutVar(p,(unsigned long)(v[3]-v[2])*2+o);
+	 }
+       else if(v[2]!=prev[2])
+	 {
+	  *p++=0;
+	  *p++=0;
+	  p=PutVar(p,(unsigned long)(v[2]-prev[2]));
+	  p=PutVar(p,(unsigned long)(v[3]-v[2])*2+o);
+	 }
+       else
+	 {
+	  *p++=0;
+	  *p++=0;
+	  *p++=0;
+	  p=PutVar(p,(unsigned long)(v[3]-prev[3])*2+o);
+	 }
+
+       memcpy(prev,v,sizeof(prev));
+       if(o)
+	 {
+	  v[2]^=v[3]; v[3]^=v[2]; v[2]^=v[3];
+	 }
+      }
+    J->Len[b]=(long)(p-(J->buf+b*TETPACK_BLOCK*4*TETPACK_VARMAX));
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	WriteTetPack						   *
+*									   *
+*  PURPOSE:	Write a vector of tetrahedra as a packed file.		   *
+*									   *
+*   PARAMS:	The vector of the 4*nt vertices of nt tetrahedra, the	   *
+*		number np of points (the vertices are in [0, np)) and the  *
+*		file, opened for writing in binary mode.		   *
+*									   *
+*    NOTES:	The vector is left in the order of the file: the vertices  *
+*		of each tetrahedron are sorted, but the last two are	   *
+*		swapped if needed to keep the orientation, and the	   *
+*		tetrahedra are sorted by their sorted vertices.		   *
+*									   *
+***************************************************************************/
+
+void WriteTetPack(pindex *t, long nt, long np, FILE *fp)
+{
+ PackJob *J;
+ unsigned char head[sizeof(TETPACK_MAGIC)+3*10], *p;
+ pindex tmp[4], *v;
+ long *Next, i, k, nb, b, nr;
+
+ J=(PackJob *)malloc(sizeof(PackJob));
+ if(!J) Error("WriteTetPack, not enough memory.\n",EXIT);
+ J->Start=(long *)calloc((size_t)np+2,sizeof(long));
+ Next=(long *)malloc(((size_t)np+1)*sizeof(long));
+ if(!J->Start || !Next) Error("WriteTetPack, not enough memory.\n",EXIT);
+ J->t=t;
+ J->nt=nt;
+
+ ParallelFor(nt, 0, SortVertexBody, J);
+
+ for(i=0;i<nt;i++)
+   {
+    if(t[4*i]<0 || MAX(t[4*i+2],t[4*i+3])>=np)
+      Errorf(EXIT,"WriteTetPack, tetrahedron %ld has a vertex out of [0, %ld).\n",i,np);
+    J->Start[t[4*i]+1]++;
+   }
+ for(k=0;k<np;k++)
+   {
+    J->Start[k+1]+=J->Start[k];
+    Next[k]=J->Start[k];
+   }
+
+ for(k=0;k<np;k++)		/* Counting sort in place on v[0] */
+   while(Next[k]<J->Start[k+1])
+     {
+      v=t+4*Next[k];
+      while(v[0]!=k)
+	{
+	 memcpy(tmp,t+4*Next[v[0]],sizeof(tmp));
+	 memcpy(t+4*Next[v[0]]++,v,sizeof(tmp));
+	 memcpy(v,tmp,sizeof(tmp));
+	}
+      Next[k]++;
+     }
+ free(Next);
+
+ ParallelFor(np, 0, SortBucketBody, J);
+
+ p=head;
+ memcpy(p,TETPACK_MAGIC,strlen(TETPACK_MAGIC));
+ p+=strlen(TETPACK_MAGIC);
+ p=PutVar(p,(unsigned long)np);
+ p=PutVar(p,(unsigned long)nt);
+ p=PutVar(p,(unsigned long)TETPACK_BLOCK);
+ fwrite(head,1,(size_t)(p-head),fp);
+
+ nb=(nt+TETPACK_BLOCK-1)/TETPACK_BLOCK;
+ nr=MIN(ThreadNum(),MAX(nb,1));
+ J->buf=(unsigned char *)malloc((size_t)(nr*TETPACK_BLOCK*4*TETPACK_VARMAX));
+ if(!J->buf) Error("WriteTetPack, not enough memory.\n",EXIT);
+
+ for(J->first=0;J->first<nb;J->first+=nr)
+   {
+    ParallelFor(MIN(nr,nb-J->first), 1, EncodeBody, J);
+    for(b=0;b<nr && J->first+b<nb;b++)
+      {
+       p=PutVar(head,(unsigned long)MIN(TETPACK_BLOCK,nt-(J->first+b)*TETPACK_BLOCK));
+       p=PutVar(p,(unsigned long)J->Len[b]);
+       fwrite(head,1,(size_t)(p-head),fp);
+       fwrite(J->buf+b*TETPACK_BLOCK*4*TETPACK_VARMAX,1,(size_t)J->Len[b],fp);
+      }
+   }
+
+ free(J->buf);
+ free(J->Start);
+ free(J);
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	OpenTetPack						   *
+*									   *
+*  PURPOSE:	Read the header of a packed tetrahedra file.		   *
+*									   *
+*   PARAMS:	The file, opened for reading in binary mode, and the	   *
+*		TetPack to fill.					   *
+*									   *
+*   RETURN:	P if the file is a packed one,				   *
+*		NULL else.						   *
+*									   *
+*    NOTES:	A text file is recognized from its first character, that   *
+*		is left in the file, so it can be read as text also from   *
+*		a pipe. The caller allocates 4*P->block vertices for the   *
+*		tetrahedra of ReadTetPack.				   *
+*									   *
+***************************************************************************/
+
+TetPack *OpenTetPack(FILE *fp, TetPack *P)
+{
+ char magic[sizeof(TETPACK_MAGIC)];
+ unsigned long np, nt, nb;
+ int c;
+
+ c=getc(fp);
+ if(c==EOF) return NULL;
+ ungetc(c,fp);
+ if(c!=TETPACK_MAGIC[0]) return NULL;
+
+ if(fread(magic,1,strlen(TETPACK_MAGIC),fp)!=strlen(TETPACK_MAGIC) ||
+    memcmp(magic,TETPACK_MAGIC,strlen(TETPACK_MAGIC)) ||
+    !GetFileVar(fp,&np) || !GetFileVar(fp,&nt) || !GetFileVar(fp,&nb) ||
+    nb==0 || nb>(1UL<<24)) return NULL;
+
+ P->fp=fp;
+ P->np=(long)np;
+ P->nt=P->left=(long)nt;
+ P->block=(long)nb;
+ P->buf=NULL;
+ P->bufsize=0;
+ return P;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	ReadTetPack						   *
+*									   *
+*  PURPOSE:	Read the next block of a packed tetrahedra file.	   *
+*									   *
+*   PARAMS:	The TetPack and the vector for the vertices of at most	   *
+*		P->block tetrahedra.					   *
+*									   *
+*   RETURN:	The number of tetrahedra read, 0 at the end of the file,   *
+*		-1 if the block is truncated or wrong.			   *
+*									   *
+***************************************************************************/
+
+long ReadTetPack(TetPack *P, pindex *t)
+{
+ unsigned long k, len, d[4];
+ unsigned char *p, *e;
+ pindex prev[4];
+ long i;
+ int j, o;
+
+ if(P->left==0) return 0;
+ if(!GetFileVar(P->fp,&k) || !GetFileVar(P->fp,&len) ||
+    k==0 || k>(unsigned long)MIN(P->block,P->left) ||
+    len>k*4*TETPACK_VARMAX) return -1;
+
+ if((long)len>P->bufsize)
+   {
+    free(P->buf);
+    P->bufsize=(long)len;
+    P->buf=(unsigned char *)malloc((size_t)len);
+    if(!P->buf) Error("ReadTetPack, not enough memory.\n",EXIT);
+   }
+ if(fread(P->buf,1,(size_t)len,P->fp)!=len) return -1;
+
+ p=P->buf;
+ e=P->buf+len;
+ prev[0]=prev[1]=prev[2]=prev[3]=0;
+ for(i=0;i<(long)k;i++,t+=4)
+   {
+    for(j=0;j<4;j++)
+      if(!GetVar(&p,e,&d[j])) return -1;
+    o=d[3]&1;
+
+    d[3]>>=1;
+    for(j=0;j<3 && d[j]==0;j++) t[j]=prev[j];
+    t[j]=prev[j]+(pindex)d[j];
+    for(j++;j<4;j++) t[j]=t[j-1]+(pindex)d[j];
+
+    memcpy(prev,t,sizeof(prev));
+    if(o)
+      {
+       t[2]=prev[3];
+       t[3]=prev[2];
+      }
+   }
+ if(p!=e) return -1;
+
+ P->left-=(long)k;
+ return (long)k;
+}
+
+
+/***************************************************************************
+*									   *
+* FUNCTION:	CloseTetPack						   *
+*									   *
+*  PURPOSE:	Release the buffer of the reader; the file is not closed.  *
+*									   *
+***************************************************************************/
+
+void CloseTetPack(TetPack *P)
+{
+ free(P->buf);
+ P->buf=NULL;
+}
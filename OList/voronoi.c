@@ -0,0 +1,553 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      voronoi.c                                                  *
+*                                                                          *
+* PURPOSE:      Extraction of the Voronoi diagram from the Delaunay        *
+*               tetrahedra.                                                *
+*                                                                          *
+* IMPORTS:      ParallelFor, Store                                         *
+*                                                                          *
+* EXPORTS:      TetraCenter         Center of the sphere of a tetrahedron  *
+*               TetraVolume         Signed volume of a tetrahedron         *
+*               WriteVoronoi        Write the Voronoi diagram on a file    *
+*                                                                          *
+*   NOTES:      The Voronoi vertices are the centers of the spheres        *
+*               circumscribed to the tetrahedra, the Voronoi cell of a     *
+*               point has a face for each Delaunay edge leaving it, and    *
+*               the vertices of that face are the centers of the           *
+*               tetrahedra around the edge. Cells are built in blocks of   *
+*               points, each block in parallel, and written as soon as    *
+*               the block is done, so the memory used by the output does   *
+*               not depend on the size of the dataset.                     *
+*               The points and the centers are vectors of three doubles:   *
+*               TetraCenter makes the same operations of CalcSphereCenter  *
+*               of DeWall and InCoDe, so the diagram does not depend on    *
+*               the program that writes it.                                *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/voronoi.h>
+
+#define VPOINT(J,i) ((double *)((J)->v+(size_t)(i)*(J)->size))
+
+
+/*
+ * Sub, Cross, Dot, Length
+ *
+ * Le operazioni sui vettori di tre double usate qui, con le stesse
+ * espressioni di ggveclib.c.
+ */
+
+static double *Sub(double *a, double *b, double *c)
+{
+ c[0]=a[0]-b[0];  c[1]=a[1]-b[1];  c[2]=a[2]-b[2];
+ return c;
+}
+
+static double *Cross(double *a, double *b, double *c)
+{
+ c[0]=(a[1]*b[2])-(a[2]*b[1]);
+ c[1]=(a[2]*b[0])-(a[0]*b[2]);
+ c[2]=(a[0]*b[1])-(a[1]*b[0]);
+ return c;
+}
+
+static double Dot(double *a, double *b)
+{
+ return (a[0]*b[0])+(a[1]*b[1])+(a[2]*b[2]);
+}
+
+static double Length(double *a)
+{
+ return sqrt(Dot(a,a));
+}
+
+
+/***************************************************************************
+*									   *
+* TetraCenter								   *
+*									   *
+* The center o of the sphere through a b c d: the intersection of the	   *
+* three middle planes between a and the other vertices, found with the	   *
+* inverse of their 3x3 matrix. FALSE if the tetrahedron is flat.	   *
+*									   *
+***************************************************************************/
+
+boolean TetraCenter(double *a, double *b, double *c, double *d, double *o)
+{
+ double *q[3], n[3][3], m[3], off[3], inv[3][3], len, det;
+ int i, k;
+
+ q[0]=b; q[1]=c; q[2]=d;
+ for(i=0;i<3;i++)
+   {
+    for(k=0;k<3;k++)
+      {
+       m[k]=(a[k]+q[i][k])/2;
+       n[i][k]=a[k]-q[i][k];
+      }
+    len=Length(n[i]);
+    if(len!=0.0) for(k=0;k<3;k++) n[i][k]/=len;
+    off[i]=Dot(n[i],m);
+   }
+
+ det=n[0][0]*(n[1][1]*n[2][2]-n[1][2]*n[2][1])+
+     n[0][1]*(n[1][2]*n[2][0]-n[1][0]*n[2][2])+
+     n[0][2]*(n[1][0]*n[2][1]-n[1][1]*n[2][0]);
+ if(det==0) return FALSE;
+
+ inv[0][0]= n[1][1]*n[2][2]-n[1][2]*n[2][1];
+ inv[0][1]= n[0][2]*n[2][1]-n[0][1]*n[2][2];
+ inv[0][2]= n[0][1]*n[1][2]-n[0][2]*n[1][1];
+
+ inv[1][0]= n[1][2]*n[2][0]-n[1][0]*n[2][2];
+ inv[1][1]= n[0][0]*n[2][2]-n[0][2]*n[2][0];
+ inv[1][2]= n[0][2]*n[1][0]-n[0][0]*n[1][2];
+
+ inv[2][0]= n[1][0]*n[2][1]-n[1][1]*n[2][0];
+ inv[2][1]= n[0][1]*n[2][0]-n[0][0]*n[2][1];
+ inv[2][2]= n[0][0]*n[1][1]-n[0][1]*n[1][0];
+
+ for(k=0;k<3;k++)
+   o[k]=(inv[k][0]*off[0] +inv[k][1]*off[1] +inv[k][2]*off[2])/det;
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* TetraVolume								   *
+*									   *
+* The volume of the tetrahedron a b c d, positive if it is positively	   *
+* oriented.								   *
+*									   *
+***************************************************************************/
+
+double TetraVolume(double *a, double *b, double *c, double *d)
+{
+ double x[3], y[3], z[3], n[3];
+
+ Sub(b,a,x);
+ Sub(c,a,y);
+ Sub(d,a,z);
+ return Dot(Cross(x,y,n),z)/6;
+}
+
+
+/***************************************************************************
+*									   *
+* VBuf									   *
+*									   *
+* A growable text buffer. Each cell of a block is formatted in its own	   *
+* buffer by the thread that builds it; then the buffers are written in	   *
+* order by the main thread.						   *
+*									   *
+***************************************************************************/
+
+typedef struct VBufstruct
+{
+ char *s;
+ size_t len, size;
+} VBuf;
+
+static void AppendVBuf(VBuf *b, char *s)
+{
+ size_t l=strlen(s);
+
+ if(b->len+l+1 > b->size)
+   {
+    b->size=2*(b->len+l+1);
+    b->s=(char *)realloc(b->s,b->size);
+    if(!b->s) Error("AppendVBuf, Not enough memory to format Voronoi diagram\n",EXIT);
+   }
+ memcpy(b->s+b->len,s,l+1);
+ b->len+=l;
+}
+
+
+/***************************************************************************
+*									   *
+* VWork 								   *
+*									   *
+* The per thread workspace used to build a cell: the tetrahedra around     *
+* the current edge, the chain of their centers and the neighbour points.   *
+* The vectors grow with the number of tetrahedra incident in a point.	   *
+*									   *
+***************************************************************************/
+
+typedef struct VWorkstruct
+{
+ int size;
+ pindex *q;			/* Neighbour points			  */
+ long *t;			/* Tetrahedra around the current edge	  */
+ pindex *r, *s;			/* Their two vertices out of the edge	  */
+ long *chain;			/* Tetrahedra in cyclic order		  */
+} VWork;
+
+static void GrowVWork(VWork *w, int size)
+{
+ if(size<=w->size) return;
+ w->size=2*size;
+ w->q    =(pindex *)realloc(w->q,    3*w->size*sizeof(pindex));
+ w->t    =(long *)  realloc(w->t,      w->size*sizeof(long));
+ w->r    =(pindex *)realloc(w->r,      w->size*sizeof(pindex));
+ w->s    =(pindex *)realloc(w->s,      w->size*sizeof(pindex));
+ w->chain=(long *)  realloc(w->chain,  w->size*sizeof(long));
+ if(!w->q || !w->t || !w->r || !w->s || !w->chain)
+   Error("GrowVWork, Not enough memory to build Voronoi cells\n",EXIT);
+}
+
+typedef struct VJobstruct
+{
+ Store T;			/* The tetrahedra			  */
+ long nt;
+ char *v;			/* The points, of size bytes each	  */
+ size_t size;
+ pindex n;
+ double *c;			/* Voronoi vertices, three coordinates	  */
+ long *start;			/* Tetrahedra incident in each point:	  */
+ long *inc;			/* inc[start[p]] .. inc[start[p+1]-1]	  */
+ long first;			/* First item of the current block	  */
+ VBuf *buf;
+ VWork work[MAX_THREADS];
+ int Flat[MAX_THREADS];
+ boolean AreaFlag;
+} VJob;
+
+
+/***************************************************************************
+*									   *
+* CenterBody								   *
+*									   *
+* Compute a batch of Voronoi vertices. The center of a flat tetrahedron    *
+* cannot be found; its barycenter is used instead and it is counted.	   *
+*									   *
+***************************************************************************/
+
+static void CenterBody(long from, long to, int thread, void *arg)
+{
+ VJob *J=(VJob *)arg;
+ pindex *t;
+ double *c;
+ long i;
+ int k;
+
+ for(i=from;i<to;i++)
+   {
+    t=(pindex *)StoreElem(i,J->T);
+    c=J->c+3*i;
+    if(!TetraCenter(VPOINT(J,t[0]),VPOINT(J,t[1]),VPOINT(J,t[2]),VPOINT(J,t[3]),c))
+      {
+       c[0]=c[1]=c[2]=0;
+       for(k=0;k<4;k++)
+	 {
+	  c[0]+=VPOINT(J,t[k])[0];
+	  c[1]+=VPOINT(J,t[k])[1];
+	  c[2]+=VPOINT(J,t[k])[2];
+	 }
+       c[0]/=4; c[1]/=4; c[2]/=4;
+       J->Flat[thread]++;
+      }
+   }
+}
+
+static void VertexBody(long from, long to, int thread, void *arg)
+{
+ VJob *J=(VJob *)arg;
+ char line[80];
+ long i;
+ double *c;
+
+ for(i=from;i<to;i++)
+   {
+    c=J->c+3*(J->first+i);
+    sprintf(line,"%.10g %.10g %.10g\n",c[0],c[1],c[2]);
+    J->buf[i].len=0;
+    AppendVBuf(&(J->buf[i]),line);
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* ChainEdge								   *
+*									   *
+* Put in w->chain the k tetrahedra around the edge p q in cyclic order:    *
+* two consecutive tetrahedra share a face, i.e. a vertex out of the edge.  *
+* If the edge is on the convex hull the tetrahedra form an open fan, that  *
+* is started from one of its ends, and FALSE is returned.		   *
+*									   *
+***************************************************************************/
+
+static boolean ChainEdge(VWork *w, int k)
+{
+ int i, j, cnt, cur, next;
+ pindex last=-1;
+ boolean closed=TRUE;
+
+ cur=0;
+ for(i=0;i<k && closed;i++)	/* Look for an end of an open fan	  */
+   {
+    for(cnt=0,j=0;j<k;j++)
+      if(w->r[j]==w->r[i] || w->s[j]==w->r[i]) cnt++;
+    if(cnt==1) { cur=i; last=w->s[i]; closed=FALSE; break; }
+    for(cnt=0,j=0;j<k;j++)
+      if(w->r[j]==w->s[i] || w->s[j]==w->s[i]) cnt++;
+    if(cnt==1) { cur=i; last=w->r[i]; closed=FALSE; break; }
+   }
+ if(closed) last=w->s[0];
+
+ for(i=0;i<k;i++)
+   {
+    w->chain[i]=w->t[cur];
+    w->t[cur]=-1;			/* Already chained		  */
+    for(next=-1,j=0;j<k && next<0;j++)
+      if(w->t[j]>=0 && (w->r[j]==last || w->s[j]==last)) next=j;
+    if(next<0 && i<k-1)		/* Not a fan (numerical errors):  */
+      {				/* append the rest as it is.	  */
+       for(j=0;j<k;j++) if(w->t[j]>=0) w->chain[++i]=w->t[j];
+       return FALSE;
+      }
+    if(next<0) return closed;
+    last=(w->r[next]==last) ? w->s[next] : w->r[next];
+    cur=next;
+   }
+ return closed;
+}
+
+
+/***************************************************************************
+*									   *
+* CellBody								   *
+*									   *
+* Build and format the Voronoi cells of a block of points. For each edge   *
+* p q the centers around it are chained and oriented counterclockwise as   *
+* seen from q; area and volume come from the fan of triangles of each	   *
+* face (the pyramid from p over a face has height |pq|/2).		   *
+*									   *
+***************************************************************************/
+
+static int CompareIndex(const void *a, const void *b)
+{
+ pindex i=*(pindex *)a, j=*(pindex *)b;
+
+ return (i>j)-(i<j);
+}
+
+static void CellBody(long from, long to, int thread, void *arg)
+{
+ VJob *J=(VJob *)arg;
+ VWork *w=&(J->work[thread]);
+ VBuf *b;
+ pindex *t;
+ double a[3], e1[3], e2[3], x[3], pq[3];
+ char line[80];
+ long i, j, tmp;
+ pindex p;
+ int deg, nq, nf, h, k, l, m;
+ double area, volume;
+ boolean closed, bounded;
+
+ for(i=from;i<to;i++)
+   {
+    p=J->first+i;
+    b=&(J->buf[i]);
+    b->len=0;
+    deg=(int)(J->start[p+1]-J->start[p]);
+    GrowVWork(w,deg);
+
+    for(nq=0,j=J->start[p];j<J->start[p+1];j++)
+      {
+       t=(pindex *)StoreElem(J->inc[j],J->T);
+       for(l=0;l<4;l++) if(t[l]!=p) w->q[nq++]=t[l];
+      }
+    qsort(w->q,(size_t)nq,sizeof(pindex),CompareIndex);
+    for(nf=0,j=0;j<nq;j++)		/* Unique neighbour points	  */
+      if(j==0 || w->q[j]!=w->q[j-1]) w->q[nf++]=w->q[j];
+
+    bounded=TRUE;
+    volume=0;
+    sprintf(line,"%" IDX " %i\n",p,nf);
+    AppendVBuf(b,line);
+
+    for(h=0;h<nf;h++)
+      {
+       for(k=0,j=J->start[p];j<J->start[p+1];j++)
+	 {
+	  t=(pindex *)StoreElem(J->inc[j],J->T);
+	  for(l=0;l<4;l++) if(t[l]==w->q[h]) break;
+	  if(l==4) continue;
+	  w->t[k]=J->inc[j];
+	  for(m=0,l=0;l<4;l++)
+	    if(t[l]!=p && t[l]!=w->q[h])
+	      {
+	       if(m++==0) w->r[k]=t[l];
+		     else w->s[k]=t[l];
+	      }
+	  k++;
+	 }
+
+       closed=ChainEdge(w,k);
+       if(!closed) bounded=FALSE;
+
+       a[0]=a[1]=a[2]=0;		/* Area vector of the face	  */
+       for(j=1;j+1<k;j++)
+	 {
+	  Sub(J->c+3*w->chain[j],J->c+3*w->chain[0],e1);
+	  Sub(J->c+3*w->chain[j+1],J->c+3*w->chain[0],e2);
+	  Cross(e1,e2,x);
+	  a[0]+=x[0]; a[1]+=x[1]; a[2]+=x[2];
+	 }
+       Sub(VPOINT(J,w->q[h]),VPOINT(J,p),pq);
+       if(Dot(a,pq)<0)
+	 for(j=0;j<k/2;j++)
+	   {
+	    tmp=w->chain[j];
+	    w->chain[j]=w->chain[k-1-j];
+	    w->chain[k-1-j]=tmp;
+	   }
+       area=Length(a)/2;
+       volume+=area*Length(pq)/6;
+
+       sprintf(line,"%" IDX " %i",w->q[h],closed ? k : -k);
+       AppendVBuf(b,line);
+       for(j=0;j<k;j++)
+	 {
+	  sprintf(line," %ld",w->chain[j]);
+	  AppendVBuf(b,line);
+	 }
+       if(J->AreaFlag)
+	 {
+	  sprintf(line," %.10g",closed ? area : -1.0);
+	  AppendVBuf(b,line);
+	 }
+       AppendVBuf(b,"\n");
+      }
+
+    if(J->AreaFlag)
+      {
+       sprintf(line,"%.10g\n",bounded ? volume : -1.0);
+       AppendVBuf(b,line);
+      }
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* WriteBlocks								   *
+*									   *
+* Build n items with body, VORONOI_BLOCK at a time, and write them in	   *
+* order on fp.								   *
+*									   *
+***************************************************************************/
+
+static void WriteBlocks(VJob *J, long n, ParallelBody body, FILE *fp)
+{
+ long i, len;
+
+ for(J->first=0; J->first<n; J->first+=VORONOI_BLOCK)
+   {
+    len=MIN(VORONOI_BLOCK,n-J->first);
+    ParallelFor(len, 0, body, J);
+    for(i=0;i<len;i++) fwrite(J->buf[i].s,1,J->buf[i].len,fp);
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* WriteVoronoi								   *
+*									   *
+* Write on fp the Voronoi diagram of the n points v, objects of size	   *
+* bytes, given the Store T of the Delaunay tetrahedra in the order they	   *
+* are written on the tetrahedra file. The format is:			   *
+*									   *
+*	nt				number of Voronoi vertices	   *
+*	x y z				i-th vertex: center of i-th tetra  *
+*	...								   *
+*	n				number of cells 		   *
+*	p nf				cell of point p with nf faces	   *
+*	q k c1 ... ck [area]		face shared with the cell of q	   *
+*	...								   *
+*	[volume]							   *
+*									   *
+* The vertices of a face are counterclockwise as seen from q. A face of    *
+* an unbounded cell may be open: then k is negative and the -k vertices    *
+* are listed from one end of the open chain to the other. With AreaFlag    *
+* area and volume are added (-1 for open faces and unbounded cells).	   *
+*									   *
+***************************************************************************/
+
+void WriteVoronoi(Store T, void *v, size_t size, pindex n, boolean AreaFlag, FILE *fp)
+{
+ VJob J;
+ pindex *t;
+ long i, nt=CountStore(T), *pos;
+ int j, Flat=0;
+
+ J.T=T;
+ J.nt=nt;
+ J.v=(char *)v;
+ J.size=size;
+ J.n=n;
+ J.AreaFlag=AreaFlag;
+ J.c=(double *)malloc((size_t)MAX(nt,1)*3*sizeof(double));
+ J.start=(long *)calloc((size_t)n+1,sizeof(long));
+ J.inc=(long *)malloc((size_t)MAX(4*nt,1)*sizeof(long));
+ J.buf=(VBuf *)calloc(VORONOI_BLOCK,sizeof(VBuf));
+ pos=(long *)malloc((size_t)MAX(n,1)*sizeof(long));
+ if(!J.c || !J.start || !J.inc || !J.buf || !pos)
+   Error("WriteVoronoi, Not enough memory to build Voronoi diagram\n",EXIT);
+ for(i=0;i<MAX_THREADS;i++)
+   {
+    J.work[i].size=0;
+    J.work[i].q=J.work[i].r=J.work[i].s=NULL;
+    J.work[i].t=J.work[i].chain=NULL;
+    J.Flat[i]=0;
+   }
+
+ ParallelFor(nt, 0, CenterBody, &J);
+ for(i=0;i<MAX_THREADS;i++) Flat+=J.Flat[i];
+ if(Flat) Errorf(NO_EXIT,"WriteVoronoi, %i flat tetrahedra, barycenter used as vertex\n",Flat);
+
+ for(i=0;i<nt;i++)		/* Tetrahedra incident in each point	  */
+   for(t=(pindex *)StoreElem(i,T),j=0;j<4;j++) J.start[t[j]+1]++;
+ for(i=0;i<n;i++) J.start[i+1]+=J.start[i];
+ for(i=0;i<n;i++) pos[i]=J.start[i];
+ for(i=0;i<nt;i++)
+   for(t=(pindex *)StoreElem(i,T),j=0;j<4;j++) J.inc[pos[t[j]]++]=i;
+ free(pos);
+
+ fprintf(fp,"%ld\n",nt);
+ WriteBlocks(&J, nt, VertexBody, fp);
+ fprintf(fp,"%" IDX "\n",n);
+ WriteBlocks(&J, n, CellBody, fp);
+
+ for(i=0;i<VORONOI_BLOCK;i++) free(J.buf[i].s);
+ for(i=0;i<MAX_THREADS;i++)
+   {
+    free(J.work[i].q);
+    free(J.work[i].t);
+    free(J.work[i].r);
+    free(J.work[i].s);
+    free(J.work[i].chain);
+   }
+ free(J.buf);
+ free(J.inc);
+ free(J.start);
+ free(J.c);
+}
@@ -0,0 +1,207 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      vtk.c                                                      *
+*                                                                          *
+* PURPOSE:      Writing the triangulation as a VTK unstructured grid.      *
+*                                                                          *
+* IMPORTS:      ParallelFor, Store, TetraCenter, TetraVolume               *
+*                                                                          *
+* EXPORTS:      WriteVTK            Write points and tetrahedra in VTK     *
+*                                                                          *
+*   NOTES:      The file is in the legacy binary format of VTK, read by    *
+*               ParaView, VisIt and most FEM tools: a text header for      *
+*               each section and then its numbers in big endian. Points    *
+*               and tetrahedra are converted a block at a time, each       *
+*               block in parallel, and written as soon as the block is     *
+*               done; the tetrahedra are read directly from the Store.     *
+*               The optional radius and volume of the tetrahedra are       *
+*               computed while converting them, but their sections come    *
+*               after the cells, so they are kept until the end.           *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/store.h>
+#include <OList/parallel.h>
+#include <OList/voronoi.h>
+
+#define VPOINT(J,i) ((double *)((J)->v+(size_t)(i)*(J)->size))
+
+
+typedef struct VTKJobstruct
+{
+ Store T;
+ char *v;			/* The points, of size bytes each	  */
+ size_t size;
+ long first;			/* First item of the current block	  */
+ boolean swap;			/* Whether the machine is little endian   */
+ unsigned char *buf;		/* The block converted in big endian	  */
+ unsigned char *Radius; 	/* The fields of all the tetrahedra, in   */
+ unsigned char *Volume; 	/* big endian, or NULL			  */
+} VTKJob;
+
+
+/*
+ * PutBytes, PutInt, PutDouble
+ *
+ * Scrivono un int di 32 bit o un double in big endian a partire da b.
+ */
+
+static void PutBytes(unsigned char *b, void *x, int size, boolean swap)
+{
+ int i;
+
+ if(swap)
+   for(i=0;i<size;i++) b[i]=((unsigned char *)x)[size-1-i];
+ else memcpy(b,x,(size_t)size);
+}
+
+static void PutInt(unsigned char *b, long x, boolean swap)
+{
+ int i=(int)x;
+
+ PutBytes(b,&i,4,swap);
+}
+
+static void PutDouble(unsigned char *b, double x, boolean swap)
+{
+ PutBytes(b,&x,8,swap);
+}
+
+
+static void PointBody(long from, long to, int thread, void *arg)
+{
+ VTKJob *J=(VTKJob *)arg;
+ double *p;
+ long i;
+
+ for(i=from;i<to;i++)
+   {
+    p=VPOINT(J,J->first+i);
+    PutDouble(J->buf+24*i,   p[0],J->swap);
+    PutDouble(J->buf+24*i+8, p[1],J->swap);
+    PutDouble(J->buf+24*i+16,p[2],J->swap);
+   }
+}
+
+
+/*
+ * CellBody
+ *
+ * Converte un blocco di tetraedri: 4 e i quattro vertici. Il raggio della
+ * sfera circoscritta e' -1 per un tetraedro piatto; il volume ha il segno
+ * dell'orientamento.
+ */
+
+static void CellBody(long from, long to, int thread, void *arg)
+{
+ VTKJob *J=(VTKJob *)arg;
+ pindex *t;
+ double *a, *b, *c, *d, o[3], r;
+ long i;
+ int k;
+
+ for(i=from;i<to;i++)
+   {
+    t=(pindex *)StoreElem(J->first+i,J->T);
+    PutInt(J->buf+20*i,4,J->swap);
+    for(k=0;k<4;k++) PutInt(J->buf+20*i+4*(k+1),(long)t[k],J->swap);
+
+    if(J->Radius)
+      {
+       a=VPOINT(J,t[0]);
+       b=VPOINT(J,t[1]);
+       c=VPOINT(J,t[2]);
+       d=VPOINT(J,t[3]);
+       if(TetraCenter(a,b,c,d,o))
+	 r=sqrt(SQR(o[0]-a[0])+SQR(o[1]-a[1])+SQR(o[2]-a[2]));
+       else r= -1;
+       PutDouble(J->Radius+8*(J->first+i),r,J->swap);
+       PutDouble(J->Volume+8*(J->first+i),TetraVolume(a,b,c,d),J->swap);
+      }
+   }
+}
+
+
+/***************************************************************************
+*									   *
+* WriteVTK								   *
+*									   *
+* Write on fp, opened in binary mode, the n points v, objects of size	   *
+* bytes, and the tetrahedra of T as a VTK unstructured grid; with	   *
+* FieldFlag add for each tetrahedron the radius of its circumscribed	   *
+* sphere and its volume.						   *
+*									   *
+***************************************************************************/
+
+void WriteVTK(Store T, void *v, size_t size, pindex n, boolean FieldFlag, FILE *fp)
+{
+ VTKJob J;
+ long nt=CountStore(T), i, len;
+ int one=1;
+
+ if(n>INT_MAX || 5*nt>INT_MAX)
+   Error("WriteVTK, too many points or tetrahedra for a VTK file\n",EXIT);
+
+ J.T=T;
+ J.v=(char *)v;
+ J.size=size;
+ J.swap= *(char *)&one==1;
+ J.buf=(unsigned char *)malloc(VTK_BLOCK*24);
+ J.Radius=J.Volume=NULL;
+ if(FieldFlag)
+   {
+    J.Radius=(unsigned char *)malloc((size_t)MAX(nt,1)*8);
+    J.Volume=(unsigned char *)malloc((size_t)MAX(nt,1)*8);
+    if(!J.Radius || !J.Volume) Error("WriteVTK, Not enough memory for the tetrahedra fields\n",EXIT);
+   }
+ if(!J.buf) Error("WriteVTK, Not enough memory\n",EXIT);
+
+ fprintf(fp,"# vtk DataFile Version 3.0\n");
+ fprintf(fp,"Delaunay triangulation of %" IDX " points\n",n);
+ fprintf(fp,"BINARY\nDATASET UNSTRUCTURED_GRID\n");
+
+ fprintf(fp,"POINTS %" IDX " double\n",n);
+ for(J.first=0; J.first<n; J.first+=VTK_BLOCK)
+   {
+    len=MIN(VTK_BLOCK,n-J.first);
+    ParallelFor(len, 0, PointBody, &J);
+    fwrite(J.buf,24,(size_t)len,fp);
+   }
+
+ fprintf(fp,"\nCELLS %ld %ld\n",nt,5*nt);
+ for(J.first=0; J.first<nt; J.first+=VTK_BLOCK)
+   {
+    len=MIN(VTK_BLOCK,nt-J.first);
+    ParallelFor(len, 0, CellBody, &J);
+    fwrite(J.buf,20,(size_t)len,fp);
+   }
+
+ fprintf(fp,"\nCELL_TYPES %ld\n",nt);
+ for(i=0;i<MIN(VTK_BLOCK,nt);i++) PutInt(J.buf+4*i,VTK_TETRA,J.swap);
+ for(i=0;i<nt;i+=VTK_BLOCK) fwrite(J.buf,4,(size_t)MIN(VTK_BLOCK,nt-i),fp);
+
+ if(FieldFlag)
+   {
+    fprintf(fp,"\nCELL_DATA %ld\n",nt);
+    fprintf(fp,"SCALARS Radius double 1\nLOOKUP_TABLE default\n");
+    fwrite(J.Radius,8,(size_t)nt,fp);
+    fprintf(fp,"\nSCALARS Volume double 1\nLOOKUP_TABLE default\n");
+    fwrite(J.Volume,8,(size_t)nt,fp);
+    free(J.Radius);
+    free(J.Volume);
+   }
+ fprintf(fp,"\n");
+ free(J.buf);
+}
@@ -0,0 +1,192 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      main.c                                                     *
+*                                                                          *
+* PURPOSE:      Validator of the triangulations built by DeWall and InCoDe.*
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*               Validation library (vfile.c, validate.c)                   *
+*                                                                          *
+* EXPORTS:      main                                                       *
+*                                                                          *
+*   NOTES:      The program has three modes: the validation of a          *
+*               triangulation, the comparison of two triangulations of     *
+*               the same points (-d) and the canonicalization of a         *
+*               tetrahedra file (-k). Exit status is 0 on success, 1 if    *
+*               the validation fails or the triangulations differ.         *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/chronos.h>
+#include <OList/parallel.h>
+
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "graphics.h"
+#include "validate.h"
+
+#define USAGE_MESSAGE "\nUsage: validate [-s] [-o] [-f] [-v] [-e eps] [-j nnn] filepnt filetet\n\
+       validate -d [-j nnn] filetet1 filetet2\n\
+       validate -k [-j nnn] filetet [fileout]\n\
+	-s	Check the empty sphere property\n\
+	-o	Check that tetrahedra are positively oriented\n\
+	-f	Check that faces are shared by two tetrahedra or are on a\n\
+		closed convex boundary\n\
+	-v	Check that tetrahedra volume equals convex hull volume\n\
+		(without -s -o -f -v all the checks are done)\n\
+	-e eps	Tolerance of the empty sphere check (default 1e-7)\n\
+	-d	Compare two triangulations of the same points\n\
+	-k	Write a tetrahedra file in canonical form\n\
+	-j nnn	Use nnn threads (default one for each processor)\n\
+"
+
+
+/***************************************************************************
+*									   *
+* MaxIndex								   *
+*									   *
+* The number of points referred by a vector of tetrahedra, used when the   *
+* point file is not given.						   *
+*									   *
+***************************************************************************/
+
+static pindex MaxIndex(ShortTetra *t, long n)
+{
+ long i;
+ pindex m=0;
+ int j;
+
+ for(i=0;i<n;i++)
+   for(j=0;j<4;j++)
+     {
+      if(t[i].v[j]<0) Errorf(EXIT,"MaxIndex, negative index in tetrahedron %ld\n",i);
+      if(t[i].v[j]>=m) m=t[i].v[j]+1;
+     }
+ return m;
+}
+
+
+/***************************************************************************
+*									   *
+* main									   *
+*									   *
+* Do the usual command line parsing, file I/O and timing matters.	   *
+*									   *
+***************************************************************************/
+
+typedef struct DiffLoadstruct
+{
+ char *file[2];
+ ShortTetra *t[2];
+ long n[2];
+} DiffLoad;
+
+static void DiffLoadBody(long from, long to, int thread, void *arg)
+{
+ DiffLoad *L=(DiffLoad *)arg;
+ long i;
+
+ for(i=from;i<to;i++) L->t[i]=ReadTetraFile(L->file[i],&(L->n[i]));
+}
+
+main(int argc, char *argv[])
+{
+ char buf[80];
+ Triangulation T;
+ VResult R;
+ DiffLoad L;
+ long OnlyA, OnlyB;
+ int checks=0, DiffFlag=OFF, CanonFlag=OFF, ok, i=1;
+ pindex np;
+ double eps=EPSILON;
+ FILE *fp=stdout;
+
+ SetProgramName("Validate");
+ if((argc<2) ||
+    (strcmp(argv[i],"/?")==0)||
+    (strcmp(argv[i],"-?")==0)||
+    (strcmp(argv[i],"/h")==0)||
+    (strcmp(argv[i],"-h")==0)  ) Error(USAGE_MESSAGE, EXIT);
+
+ while(i<argc && *argv[i]=='-')
+   {
+    switch(argv[i][1])
+      {
+       case 's' : checks|=CHECK_SPHERE; 		break;
+       case 'o' : checks|=CHECK_ORIENT; 		break;
+       case 'f' : checks|=CHECK_FACES;			break;
+       case 'v' : checks|=CHECK_VOLUME; 		break;
+       case 'd' : DiffFlag=ON;				break;
+       case 'k' : CanonFlag=ON; 			break;
+
+       case 'e' : if(argv[i][2]==0 && i+1<argc) eps=atof(argv[++i]);
+		    else eps=atof(argv[i]+2);
+		  break;
+
+       case 'j' : if(argv[i][2]==0 && i+1<argc && isdigit(argv[i+1][0]))
+			 SetThreadNum(atoi(argv[++i]));
+		    else SetThreadNum(atoi(argv[i]+2));
+		  break;
+
+       default	: sprintf(buf,"Unknown options '%s'\n",argv[i]);
+		  Error(buf,NO_EXIT);
+      }
+    i++;
+   }
+
+ if(checks==0) checks=CHECK_ALL;
+
+ if(CanonFlag)
+   {
+    if(argc<=i) Error(USAGE_MESSAGE, EXIT);
+    T.t=ReadTetraFile(argv[i++],&(T.nt));
+    if(argc>i) fp=fopen(argv[i],"w");
+    if(!fp) Error("Unable to open output file\n",EXIT);
+
+    CanonicalTetra(T.t,T.nt,MaxIndex(T.t,T.nt));
+    WriteTetraVector(T.t,T.nt,fp);
+    return 0;
+   }
+
+ if(argc<i+2) Error(USAGE_MESSAGE, EXIT);
+
+ if(DiffFlag)
+   {
+    L.file[0]=argv[i];
+    L.file[1]=argv[i+1];
+    ParallelFor(2, 1, DiffLoadBody, &L);
+
+    np=max(MaxIndex(L.t[0],L.n[0]),MaxIndex(L.t[1],L.n[1]));
+    CanonicalTetra(L.t[0],L.n[0],np);
+    CanonicalTetra(L.t[1],L.n[1],np);
+
+    DiffTetra(L.t[0],L.n[0],L.t[1],L.n[1],&OnlyA,&OnlyB);
+    printf("Tetras: %ld %ld  Only in first: %ld  Only in second: %ld\n",
+	   L.n[0],L.n[1],OnlyA,OnlyB);
+    return (OnlyA || OnlyB) ? 1 : 0;
+   }
+
+ ResetChronos(USER_CHRONOS);
+ StartChronos(USER_CHRONOS);
+
+ ReadTriangulation(argv[i],argv[i+1],&T);
+ ok=ValidateTriangulation(&T,checks,eps,&R);
+
+ StopChronos(USER_CHRONOS);
+
+ PrintResult(&T,checks,&R);
+ printf("%s Secs:%6.2f\n", ok ? "Valid triangulation." : "NOT VALID!",
+	ReadChronos(USER_CHRONOS));
+
+ return ok ? 0 : 1;
+}
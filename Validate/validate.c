@@ -0,0 +1,824 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      validate.c                                                 *
+*                                                                          *
+* PURPOSE:      Parallel checks of a 3d Delaunay triangulation.            *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*                                                                          *
+* EXPORTS:      Orient                 Orientation of four points          *
+*               CheckIndexes           Test vertex indexes                 *
+*               CheckEmptySphere       Test the Delaunay property          *
+*               CheckOrientation       Test tetrahedra orientation         *
+*               CheckFaces             Test face adjacency and the hull    *
+*               ValidateTriangulation  Execute a set of checks             *
+*               PrintResult            Describe the outcome of the checks  *
+*                                                                          *
+*   NOTES:      A set of tetrahedra is a triangulation of the convex hull  *
+*               of its points if each internal face separates exactly two  *
+*               tetrahedra, the boundary faces form a closed convex        *
+*               surface through all the points, and the volumes of the     *
+*               tetrahedra sum to the volume enclosed by that surface.     *
+*               CheckFaces tests convexity edge by edge, so no convex      *
+*               hull has to be built.                                      *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/parallel.h>
+
+#include "graphics.h"
+#include "validate.h"
+
+#define FLAT_EPSILON	1e-12	/* Null volume, relative to bbox diag^3   */
+#define VOLUME_EPSILON	1e-9	/* Tolerated relative volume difference   */
+
+
+/***************************************************************************
+*									   *
+* Orient								   *
+*									   *
+* Six times the signed volume of tetrahedron a b c d. It is positive when  *
+* d lies on the side of the plane a b c from which a b c are seen	   *
+* counterclockwise.							   *
+*									   *
+***************************************************************************/
+
+double Orient(Point3 *a, Point3 *b, Point3 *c, Point3 *d)
+{
+ Vector3 ab, ac, ad, n;
+
+ V3Sub(b,a,&ab);
+ V3Sub(c,a,&ac);
+ V3Sub(d,a,&ad);
+ V3Cross(&ab,&ac,&n);
+ return V3Dot(&n,&ad);
+}
+
+
+/***************************************************************************
+*									   *
+* FlatTolerance								   *
+*									   *
+* The value of Orient under which a tetrahedron of the points of T is	   *
+* considered flat, scaled on the bounding box of the points.		   *
+*									   *
+***************************************************************************/
+
+static double FlatTolerance(Triangulation *T)
+{
+ Point3 vn, vp;
+ double d;
+ pindex i;
+
+ if(T->n==0) return 0;
+ vn=vp=T->v[0];
+ for(i=1;i<T->n;i++)
+   {
+    vn.x=min(vn.x,T->v[i].x); vp.x=max(vp.x,T->v[i].x);
+    vn.y=min(vn.y,T->v[i].y); vp.y=max(vp.y,T->v[i].y);
+    vn.z=min(vn.z,T->v[i].z); vp.z=max(vp.z,T->v[i].z);
+   }
+ d=V3DistanceBetween2Points(&vn,&vp);
+ return FLAT_EPSILON*d*d*d;
+}
+
+
+/***************************************************************************
+*									   *
+* CheckIndexes								   *
+*									   *
+* Count the tetrahedra with a vertex index out of the point vector or	   *
+* with a repeated vertex. The other checks must not be done if some is	   *
+* found.								   *
+*									   *
+***************************************************************************/
+
+typedef struct CountJobstruct
+{
+ Triangulation *T;
+ double Tol;
+ double eps;
+ long Bad[MAX_THREADS];
+ long Bad2[MAX_THREADS];
+ double Sum[MAX_THREADS];
+ int Reported;
+} CountJob;
+
+static void ResetJob(CountJob *J, Triangulation *T)
+{
+ int i;
+
+ J->T=T;
+ J->Reported=0;
+ for(i=0;i<MAX_THREADS;i++)
+   {
+    J->Bad[i]=J->Bad2[i]=0;
+    J->Sum[i]=0;
+   }
+}
+
+static void Report(CountJob *J, char *what, ShortTetra *t, pindex p)
+{
+ LockParallel();
+ if(J->Reported++ < MAX_REPORTED)
+   {
+    if(p<0) Errorf(NO_EXIT,"%s %" IDX " %" IDX " %" IDX " %" IDX "\n",
+		   what,t->v[0],t->v[1],t->v[2],t->v[3]);
+       else Errorf(NO_EXIT,"%s %" IDX " %" IDX " %" IDX " %" IDX " (point %" IDX ")\n",
+		   what,t->v[0],t->v[1],t->v[2],t->v[3],p);
+   }
+ UnlockParallel();
+}
+
+static void IndexBody(long from, long to, int thread, void *arg)
+{
+ CountJob *J=(CountJob *)arg;
+ ShortTetra *t;
+ long i;
+ int j,k,bad;
+
+ for(i=from;i<to;i++)
+   {
+    t=&(J->T->t[i]);
+    bad=FALSE;
+    for(j=0;j<4;j++)
+      {
+       if(t->v[j]<0 || t->v[j]>=J->T->n) bad=TRUE;
+       for(k=0;k<j;k++) if(t->v[j]==t->v[k]) bad=TRUE;
+      }
+    if(bad)
+      {
+       J->Bad[thread]++;
+       Report(J,"CheckIndexes, bad tetrahedron",t,-1);
+      }
+   }
+}
+
+long CheckIndexes(Triangulation *T)
+{
+ CountJob J;
+ long Bad=0;
+ int i;
+
+ ResetJob(&J,T);
+ ParallelFor(T->nt, 0, IndexBody, &J);
+ for(i=0;i<MAX_THREADS;i++) Bad+=J.Bad[i];
+ return Bad;
+}
+
+
+/***************************************************************************
+*									   *
+* VGrid 								   *
+*									   *
+* A uniform grid of the points, stored as a vector of point indexes sorted *
+* by cell and the position of the first index of each cell. Unlike the	   *
+* UG of the triangulators it has no marks, so it can be scanned by many    *
+* threads at the same time.						   *
+*									   *
+***************************************************************************/
+
+typedef struct VGridstruct
+{
+ int x, y, z;			/* Cell number for each axis		  */
+ Point3 vn;			/* Minimum vertex			  */
+ double side;			/* Cell edge				  */
+ long *start;			/* First index of each cell in p	  */
+ pindex *p;			/* Point indexes sorted by cell 	  */
+} VGrid;
+
+static int CellCoord(double c, double vn, double side, int cells)
+{
+ double i=(c-vn)/side;
+
+ if(i<0) return 0;
+ if(i>=cells) return cells-1;
+ return (int)i;
+}
+
+static long PointCell(VGrid *G, Point3 *p)
+{
+ return CellCoord(p->x,G->vn.x,G->side,G->x) +
+	CellCoord(p->y,G->vn.y,G->side,G->y)*(long)G->x +
+	CellCoord(p->z,G->vn.z,G->side,G->z)*(long)G->x*G->y;
+}
+
+static void BuildVGrid(Triangulation *T, VGrid *G)
+{
+ Point3 vp;
+ double volume, ex, ey, ez;
+ long c, n, *pos;
+ pindex i;
+
+ G->vn=vp=T->v[0];
+ for(i=1;i<T->n;i++)
+   {
+    G->vn.x=min(G->vn.x,T->v[i].x); vp.x=max(vp.x,T->v[i].x);
+    G->vn.y=min(G->vn.y,T->v[i].y); vp.y=max(vp.y,T->v[i].y);
+    G->vn.z=min(G->vn.z,T->v[i].z); vp.z=max(vp.z,T->v[i].z);
+   }
+ ex=vp.x-G->vn.x;
+ ey=vp.y-G->vn.y;
+ ez=vp.z-G->vn.z;
+
+ volume=ex*ey*ez;		/* About one point for each cell	  */
+ if(volume>0) G->side=pow(volume/(double)T->n,1.0/3.0);
+	 else G->side=max(ex,max(ey,ez))/pow((double)T->n,1.0/3.0);
+ if(G->side<=0) G->side=1;
+
+ G->x=max(1,(int)ceil(ex/G->side));
+ G->y=max(1,(int)ceil(ey/G->side));
+ G->z=max(1,(int)ceil(ez/G->side));
+ n=(long)G->x*G->y*G->z;
+
+ G->start=(long *)calloc((size_t)n+1,sizeof(long));
+ G->p=(pindex *)malloc((size_t)T->n*sizeof(pindex));
+ pos=(long *)malloc(((size_t)n+1)*sizeof(long));
+ if(!G->start || !G->p || !pos)
+   Error("BuildVGrid, Not enough memory to build the grid.\n",EXIT);
+
+ for(i=0;i<T->n;i++) G->start[PointCell(G,&(T->v[i]))+1]++;
+ for(c=0;c<n;c++) G->start[c+1]+=G->start[c];
+ for(c=0;c<=n;c++) pos[c]=G->start[c];
+ for(i=0;i<T->n;i++) G->p[pos[PointCell(G,&(T->v[i]))]++]=i;
+
+ free(pos);
+}
+
+static void EraseVGrid(VGrid *G)
+{
+ free(G->start);
+ free(G->p);
+}
+
+
+/***************************************************************************
+*									   *
+* CheckEmptySphere							   *
+*									   *
+* Count the tetrahedra whose circumsphere contains a point of T (farther   *
+* than eps from the sphere). Only the grid cells intersecting the sphere   *
+* are scanned. Flat tetrahedra are skipped: CheckOrientation counts them.  *
+*									   *
+***************************************************************************/
+
+typedef struct SphereJobstruct
+{
+ CountJob C;
+ VGrid *G;
+} SphereJob;
+
+static int Circumcenter(Point3 *a, Point3 *b, Point3 *c, Point3 *d, Point3 *o)
+{
+ Vector3 ab, ac, ad, n1, n2, n3;
+ double den, l1, l2, l3;
+
+ V3Sub(b,a,&ab);
+ V3Sub(c,a,&ac);
+ V3Sub(d,a,&ad);
+ V3Cross(&ac,&ad,&n1);
+ V3Cross(&ad,&ab,&n2);
+ V3Cross(&ab,&ac,&n3);
+ den=2*V3Dot(&ab,&n1);
+ if(den==0) return FALSE;
+
+ l1=V3SquaredLength(&ab)/den;
+ l2=V3SquaredLength(&ac)/den;
+ l3=V3SquaredLength(&ad)/den;
+ o->x=a->x + l1*n1.x + l2*n2.x + l3*n3.x;
+ o->y=a->y + l1*n1.y + l2*n2.y + l3*n3.y;
+ o->z=a->z + l1*n1.z + l2*n2.z + l3*n3.z;
+ return TRUE;
+}
+
+static void SphereBody(long from, long to, int thread, void *arg)
+{
+ SphereJob *J=(SphereJob *)arg;
+ VGrid *G=J->G;
+ Point3 *v=J->C.T->v, Center;
+ ShortTetra *t;
+ IntPoint3 vn, vp;
+ double Radius, MinDist, d, c;
+ long i, k, cell;
+ int x,y,z;
+ pindex p;
+
+ for(i=from;i<to;i++)
+   {
+    t=&(J->C.T->t[i]);
+    if(fabs(Orient(&v[t->v[0]],&v[t->v[1]],&v[t->v[2]],&v[t->v[3]]))<=J->C.Tol)
+      continue;
+    if(!Circumcenter(&v[t->v[0]],&v[t->v[1]],&v[t->v[2]],&v[t->v[3]],&Center))
+      continue;
+
+    Radius=V3DistanceBetween2Points(&Center,&v[t->v[0]]);
+    if(Radius<=J->C.eps) continue;
+    MinDist=SQR(Radius-J->C.eps);
+
+    vn.x=CellCoord(Center.x-Radius,G->vn.x,G->side,G->x);
+    vn.y=CellCoord(Center.y-Radius,G->vn.y,G->side,G->y);
+    vn.z=CellCoord(Center.z-Radius,G->vn.z,G->side,G->z);
+    vp.x=CellCoord(Center.x+Radius,G->vn.x,G->side,G->x);
+    vp.y=CellCoord(Center.y+Radius,G->vn.y,G->side,G->y);
+    vp.z=CellCoord(Center.z+Radius,G->vn.z,G->side,G->z);
+
+    p=-1;
+    for(z=vn.z; z<=vp.z && p<0; z++)
+      for(y=vn.y; y<=vp.y && p<0; y++)
+	for(x=vn.x; x<=vp.x && p<0; x++)
+	  {
+	   d=0;			/* Squared distance from the cell	  */
+	   c=G->vn.x+x*G->side;
+	   if(Center.x<c) d+=SQR(c-Center.x);
+	     else if(Center.x>c+G->side) d+=SQR(Center.x-c-G->side);
+	   c=G->vn.y+y*G->side;
+	   if(Center.y<c) d+=SQR(c-Center.y);
+	     else if(Center.y>c+G->side) d+=SQR(Center.y-c-G->side);
+	   c=G->vn.z+z*G->side;
+	   if(Center.z<c) d+=SQR(c-Center.z);
+	     else if(Center.z>c+G->side) d+=SQR(Center.z-c-G->side);
+	   if(d>=MinDist) continue;
+
+	   cell=x+y*(long)G->x+z*(long)G->x*G->y;
+	   for(k=G->start[cell]; k<G->start[cell+1]; k++)
+	     if(V3SquaredDistanceBetween2Points(&Center,&v[G->p[k]])<MinDist &&
+		G->p[k]!=t->v[0] && G->p[k]!=t->v[1] &&
+		G->p[k]!=t->v[2] && G->p[k]!=t->v[3])
+			{ p=G->p[k]; break; }
+	  }
+
+    if(p>=0)
+      {
+       J->C.Bad[thread]++;
+       Report(&(J->C),"CheckEmptySphere, point inside the sphere of",t,p);
+      }
+   }
+}
+
+long CheckEmptySphere(Triangulation *T, double eps)
+{
+ SphereJob J;
+ VGrid G;
+ long Bad=0;
+ int i;
+
+ if(T->n==0) return 0;
+
+ BuildVGrid(T,&G);
+ ResetJob(&(J.C),T);
+ J.C.Tol=FlatTolerance(T);
+ J.C.eps=eps;
+ J.G=&G;
+
+ ParallelFor(T->nt, 0, SphereBody, &J);
+
+ for(i=0;i<MAX_THREADS;i++) Bad+=J.C.Bad[i];
+ EraseVGrid(&G);
+ return Bad;
+}
+
+
+/***************************************************************************
+*									   *
+* CheckOrientation							   *
+*									   *
+* Count the negatively oriented tetrahedra (DeWall and InCoDe write all    *
+* the tetrahedra positively oriented) and the flat ones. Volume returns    *
+* the sum of the signed volumes.					   *
+*									   *
+***************************************************************************/
+
+static void OrientBody(long from, long to, int thread, void *arg)
+{
+ CountJob *J=(CountJob *)arg;
+ Point3 *v=J->T->v;
+ ShortTetra *t;
+ double o;
+ long i;
+
+ for(i=from;i<to;i++)
+   {
+    t=&(J->T->t[i]);
+    o=Orient(&v[t->v[0]],&v[t->v[1]],&v[t->v[2]],&v[t->v[3]]);
+    J->Sum[thread]+=o/6;
+    if(fabs(o)<=J->Tol)
+      {
+       J->Bad2[thread]++;
+       Report(J,"CheckOrientation, flat tetrahedron",t,-1);
+      }
+    else if(o<0)
+      {
+       J->Bad[thread]++;
+       Report(J,"CheckOrientation, negative tetrahedron",t,-1);
+      }
+   }
+}
+
+long CheckOrientation(Triangulation *T, long *Flat, double *Volume)
+{
+ CountJob J;
+ long Bad=0;
+ int i;
+
+ ResetJob(&J,T);
+ J.Tol=FlatTolerance(T);
+ ParallelFor(T->nt, 0, OrientBody, &J);
+
+ *Flat=0;
+ *Volume=0;
+ for(i=0;i<MAX_THREADS;i++)
+   {
+    Bad+=J.Bad[i];
+    *Flat+=J.Bad2[i];
+    *Volume+=J.Sum[i];
+   }
+ return Bad;
+}
+
+
+/***************************************************************************
+*									   *
+* CheckFaces								   *
+*									   *
+* Test the adjacency of the tetrahedra and their boundary:		   *
+*									   *
+*     - All the faces of the tetrahedra are sorted, so equal faces become  *
+*	adjacent. A face must belong to one tetrahedron (boundary face) or *
+*	to two tetrahedra lying on opposite sides of it.		   *
+*     - The boundary faces are oriented outward and their edges sorted.    *
+*	Each edge must be shared by two boundary faces, and the surface    *
+*	must be convex on it.						   *
+*     - Each point must be a vertex of some tetrahedron.		   *
+*									   *
+* The volume enclosed by the boundary (the convex hull volume if all the   *
+* tests succeed) is returned in R->HullVolume.				   *
+*									   *
+***************************************************************************/
+
+static long FaceKey(void *F)
+{
+ return ((VFace *)F)->v[0];
+}
+
+static int CompareFace(const void *F0, const void *F1)
+{
+ VFace *f0=(VFace *)F0;
+ VFace *f1=(VFace *)F1;
+ int i;
+
+ for(i=0;i<3;i++)
+   if(f0->v[i]!=f1->v[i]) return (f0->v[i]<f1->v[i]) ? -1 : 1;
+ return 0;
+}
+
+static long EdgeKey(void *Edg)
+{
+ return ((VEdge *)Edg)->v[0];
+}
+
+static int CompareEdge(const void *E0, const void *E1)
+{
+ VEdge *e0=(VEdge *)E0;
+ VEdge *e1=(VEdge *)E1;
+
+ if(e0->v[0]!=e1->v[0]) return (e0->v[0]<e1->v[0]) ? -1 : 1;
+ if(e0->v[1]!=e1->v[1]) return (e0->v[1]<e1->v[1]) ? -1 : 1;
+ return 0;
+}
+
+typedef struct FaceJobstruct
+{
+ Triangulation *T;
+ VFace *F;			/* All the faces, sorted		  */
+ long nf;
+ VFace *B;			/* The boundary faces, oriented outward   */
+ VEdge *Ed;			/* The boundary edges, sorted		  */
+ long ne;
+ Point3 c;			/* A point for the hull volume integral   */
+ double Tol;
+ long OverShared[MAX_THREADS];
+ long Folded[MAX_THREADS];
+ long Boundary[MAX_THREADS];
+ long OpenEdge[MAX_THREADS];
+ long ConcaveEdge[MAX_THREADS];
+ double Volume[MAX_THREADS];
+ int Reported;
+} FaceJob;
+
+static void FaceReport(FaceJob *J, char *what, pindex a, pindex b, pindex c)
+{
+ LockParallel();
+ if(J->Reported++ < MAX_REPORTED)
+   {
+    if(c<0) Errorf(NO_EXIT,"CheckFaces, %s %" IDX " %" IDX "\n",what,a,b);
+       else Errorf(NO_EXIT,"CheckFaces, %s %" IDX " %" IDX " %" IDX "\n",what,a,b,c);
+   }
+ UnlockParallel();
+}
+
+/* Make the faces of the tetrahedra [from, to) */
+
+static void MakeFaceBody(long from, long to, int thread, void *arg)
+{
+ FaceJob *J=(FaceJob *)arg;
+ ShortTetra *t;
+ VFace *f;
+ long i;
+ int j,k,l;
+ pindex a;
+
+ for(i=from;i<to;i++)
+   {
+    t=&(J->T->t[i]);
+    for(j=0;j<4;j++)
+      {
+       f=&(J->F[4*i+j]);
+       f->opp=t->v[j];
+       for(k=0,l=0;k<4;k++)
+	 if(k!=j) f->v[l++]=t->v[k];
+       if(f->v[0]>f->v[1]) { a=f->v[0]; f->v[0]=f->v[1]; f->v[1]=a; }
+       if(f->v[1]>f->v[2]) { a=f->v[1]; f->v[1]=f->v[2]; f->v[2]=a; }
+       if(f->v[0]>f->v[1]) { a=f->v[0]; f->v[0]=f->v[1]; f->v[1]=a; }
+      }
+   }
+}
+
+/*
+ * Classify the groups of equal faces starting in [from, to).
+ * A boundary face is marked storing -1-opp in its opp field.
+ */
+
+static void GroupFaceBody(long from, long to, int thread, void *arg)
+{
+ FaceJob *J=(FaceJob *)arg;
+ VFace *F=J->F;
+ Point3 *v=J->T->v;
+ double o1, o2;
+ long i, k;
+
+ i=from;
+ while(i<to && i>0 && CompareFace(&F[i-1],&F[i])==0) i++;
+
+ while(i<to)
+   {
+    for(k=i+1; k<J->nf && CompareFace(&F[i],&F[k])==0; k++);
+
+    switch(k-i)
+      {
+       case 1 : F[i].opp=-1-F[i].opp;
+		J->Boundary[thread]++;
+		break;
+
+       case 2 : o1=Orient(&v[F[i].v[0]],&v[F[i].v[1]],&v[F[i].v[2]],&v[F[i].opp]);
+		o2=Orient(&v[F[i].v[0]],&v[F[i].v[1]],&v[F[i].v[2]],&v[F[i+1].opp]);
+		if((o1>0 && o2>0) || (o1<0 && o2<0))
+		  {
+		   J->Folded[thread]++;
+		   FaceReport(J,"overlapping tetrahedra on face",
+			      F[i].v[0],F[i].v[1],F[i].v[2]);
+		  }
+		break;
+
+       default: J->OverShared[thread]++;
+		FaceReport(J,"face shared by more than two tetrahedra",
+			   F[i].v[0],F[i].v[1],F[i].v[2]);
+		break;
+      }
+    i=k;
+   }
+}
+
+/* Orient outward the boundary faces [from, to) and make their edges */
+
+static void BoundaryBody(long from, long to, int thread, void *arg)
+{
+ FaceJob *J=(FaceJob *)arg;
+ Point3 *v=J->T->v;
+ VFace *f;
+ VEdge *e;
+ long i;
+ int j;
+ pindex a;
+
+ for(i=from;i<to;i++)
+   {
+    f=&(J->B[i]);
+    if(Orient(&v[f->v[0]],&v[f->v[1]],&v[f->v[2]],&v[f->opp])>0)
+      { a=f->v[1]; f->v[1]=f->v[2]; f->v[2]=a; }
+
+    J->Volume[thread]+=Orient(&(J->c),&v[f->v[0]],&v[f->v[1]],&v[f->v[2]])/6;
+
+    for(j=0;j<3;j++)
+      {
+       e=&(J->Ed[3*i+j]);
+       e->v[0]=min(f->v[j],f->v[(j+1)%3]);
+       e->v[1]=max(f->v[j],f->v[(j+1)%3]);
+       e->f=i;
+      }
+   }
+}
+
+static pindex ThirdVertex(VFace *f, VEdge *e)
+{
+ int j;
+
+ for(j=0;j<3;j++)
+   if(f->v[j]!=e->v[0] && f->v[j]!=e->v[1]) return f->v[j];
+ return f->v[0];
+}
+
+/* Classify the groups of equal edges starting in [from, to) */
+
+static void GroupEdgeBody(long from, long to, int thread, void *arg)
+{
+ FaceJob *J=(FaceJob *)arg;
+ VEdge *Ed=J->Ed;
+ VFace *f1, *f2;
+ Point3 *v=J->T->v;
+ long i, k;
+
+ i=from;
+ while(i<to && i>0 && CompareEdge(&Ed[i-1],&Ed[i])==0) i++;
+
+ while(i<to)
+   {
+    for(k=i+1; k<J->ne && CompareEdge(&Ed[i],&Ed[k])==0; k++);
+
+    if(k-i!=2)
+      {
+       J->OpenEdge[thread]++;
+       FaceReport(J,"boundary edge not shared by two faces",Ed[i].v[0],Ed[i].v[1],-1);
+      }
+    else
+      {
+       f1=&(J->B[Ed[i].f]);
+       f2=&(J->B[Ed[i+1].f]);
+       if(Orient(&v[f1->v[0]],&v[f1->v[1]],&v[f1->v[2]],&v[ThirdVertex(f2,&Ed[i])])>J->Tol ||
+	  Orient(&v[f2->v[0]],&v[f2->v[1]],&v[f2->v[2]],&v[ThirdVertex(f1,&Ed[i])])>J->Tol)
+	 {
+	  J->ConcaveEdge[thread]++;
+	  FaceReport(J,"boundary not convex on edge",Ed[i].v[0],Ed[i].v[1],-1);
+	 }
+      }
+    i=k;
+   }
+}
+
+void CheckFaces(Triangulation *T, VResult *R)
+{
+ FaceJob J;
+ char *used;
+ long i, nb;
+ pindex p;
+ int j;
+
+ J.T=T;
+ J.nf=4*T->nt;
+ J.Tol=FlatTolerance(T);
+ J.Reported=0;
+ for(j=0;j<MAX_THREADS;j++)
+   {
+    J.OverShared[j]=J.Folded[j]=J.Boundary[j]=0;
+    J.OpenEdge[j]=J.ConcaveEdge[j]=0;
+    J.Volume[j]=0;
+   }
+
+ J.F=(VFace *)malloc((size_t)max(J.nf,1)*sizeof(VFace));
+ used=(char *)calloc((size_t)max(T->n,1),sizeof(char));
+ if(!J.F || !used) Error("CheckFaces, Not enough memory to check faces.\n",EXIT);
+
+ ParallelFor(T->nt, 0, MakeFaceBody, &J);
+ BucketSort(J.F, J.nf, sizeof(VFace), T->n, FaceKey, CompareFace);
+ ParallelFor(J.nf, 0, GroupFaceBody, &J);
+
+ for(nb=0,j=0;j<MAX_THREADS;j++) nb+=J.Boundary[j];
+
+ J.B=(VFace *)malloc((size_t)max(nb,1)*sizeof(VFace));
+ J.Ed=(VEdge *)malloc((size_t)max(3*nb,1)*sizeof(VEdge));
+ if(!J.B || !J.Ed) Error("CheckFaces, Not enough memory to check the hull.\n",EXIT);
+
+ for(i=0,nb=0;i<J.nf;i++)
+   if(J.F[i].opp<0)
+     {
+      J.B[nb]=J.F[i];
+      J.B[nb++].opp=-1-J.F[i].opp;
+     }
+ free(J.F);
+
+ J.c.x=J.c.y=J.c.z=0;		/* The centroid of the boundary vertices, */
+ for(i=0;i<nb;i++)		/* near to the hull for a good precision  */
+   for(j=0;j<3;j++) V3Add(&(J.c),&(T->v[J.B[i].v[j]]),&(J.c));
+ if(nb>0) V3Scale(&(J.c),V3Length(&(J.c))/(3*nb));
+
+ J.ne=3*nb;
+ ParallelFor(nb, 0, BoundaryBody, &J);
+ BucketSort(J.Ed, J.ne, sizeof(VEdge), T->n, EdgeKey, CompareEdge);
+ ParallelFor(J.ne, 0, GroupEdgeBody, &J);
+
+ for(i=0;i<T->nt;i++)
+   for(j=0;j<4;j++) used[T->t[i].v[j]]=TRUE;
+
+ R->Boundary=R->OverShared=R->Folded=R->OpenEdge=R->ConcaveEdge=0;
+ R->HullVolume=0;
+ for(j=0;j<MAX_THREADS;j++)
+   {
+    R->Boundary+=J.Boundary[j];
+    R->OverShared+=J.OverShared[j];
+    R->Folded+=J.Folded[j];
+    R->OpenEdge+=J.OpenEdge[j];
+    R->ConcaveEdge+=J.ConcaveEdge[j];
+    R->HullVolume+=J.Volume[j];
+   }
+ for(R->Unused=0,p=0;p<T->n;p++)
+   if(!used[p])
+     {
+      if(R->Unused++ < MAX_REPORTED)
+	Errorf(NO_EXIT,"CheckFaces, point %" IDX " is not a vertex\n",p);
+     }
+
+ free(used);
+ free(J.B);
+ free(J.Ed);
+}
+
+
+/***************************************************************************
+*									   *
+* ValidateTriangulation 						   *
+*									   *
+* Execute the checks selected by the CHECK_* bits of checks and fill R.    *
+* It returns TRUE if the triangulation passed all of them.		   *
+*									   *
+***************************************************************************/
+
+int ValidateTriangulation(Triangulation *T, int checks, double eps, VResult *R)
+{
+ R->BadIndex=R->NotEmpty=R->Negative=R->Flat=0;
+ R->Boundary=R->OverShared=R->Folded=R->OpenEdge=R->ConcaveEdge=R->Unused=0;
+ R->Volume=R->HullVolume=0;
+
+ R->BadIndex=CheckIndexes(T);
+ if(R->BadIndex) return FALSE;
+
+ if(checks & CHECK_SPHERE) R->NotEmpty=CheckEmptySphere(T,eps);
+ if(checks & (CHECK_ORIENT|CHECK_VOLUME))
+   R->Negative=CheckOrientation(T,&(R->Flat),&(R->Volume));
+ if(checks & (CHECK_FACES|CHECK_VOLUME)) CheckFaces(T,R);
+
+ if(R->NotEmpty || R->Negative || R->Flat || R->OverShared || R->Folded ||
+    R->OpenEdge || R->ConcaveEdge || R->Unused) return FALSE;
+
+ if((checks & CHECK_VOLUME) &&
+     fabs(R->Volume-R->HullVolume) > VOLUME_EPSILON*fabs(R->HullVolume))
+   return FALSE;
+
+ return TRUE;
+}
+
+
+/***************************************************************************
+*									   *
+* PrintResult								   *
+*									   *
+* Describe on stdout the outcome of ValidateTriangulation.		   *
+*									   *
+***************************************************************************/
+
+void PrintResult(Triangulation *T, int checks, VResult *R)
+{
+ printf("Points:%8" IDX " Tetras:%9ld\n",T->n,T->nt);
+ printf("Bad tetrahedra indexes         :%9ld\n",R->BadIndex);
+ if(R->BadIndex) return;
+
+ if(checks & CHECK_SPHERE)
+   printf("Points inside circumspheres    :%9ld\n",R->NotEmpty);
+ if(checks & (CHECK_ORIENT|CHECK_VOLUME))
+   {
+    printf("Negative tetrahedra            :%9ld\n",R->Negative);
+    printf("Flat tetrahedra                :%9ld\n",R->Flat);
+   }
+ if(checks & (CHECK_FACES|CHECK_VOLUME))
+   {
+    printf("Boundary faces                 :%9ld\n",R->Boundary);
+    printf("Faces of more than 2 tetrahedra:%9ld\n",R->OverShared);
+    printf("Overlapping face neighbours    :%9ld\n",R->Folded);
+    printf("Open boundary edges            :%9ld\n",R->OpenEdge);
+    printf("Concave boundary edges         :%9ld\n",R->ConcaveEdge);
+    printf("Unused points                  :%9ld\n",R->Unused);
+   }
+ if(checks & CHECK_VOLUME)
+   {
+    printf("Tetrahedra volume              : %.12g\n",R->Volume);
+    printf("Convex hull volume             : %.12g\n",R->HullVolume);
+   }
+}
@@ -0,0 +1,123 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      validate.h                                                 *
+*                                                                          *
+* PURPOSE:      Type definitions and prototyping of the triangulation      *
+*               validation library.                                        *
+*                                                                          *
+* IMPORTS:      OList definitions                                          *
+*                                                                          *
+* EXPORTS:      ShortTetra      Definition                                 *
+*               Triangulation   Definition                                 *
+*               VFace, VEdge    Definition                                 *
+*               VResult         Definition                                 *
+*                                                                          *
+*   NOTES:      The library works on the files written by DeWall and      *
+*               InCoDe: a point file and a file of tetrahedra given as     *
+*               four indexes in the point vector. All the checks are       *
+*               done in parallel with the OList parallel loops.            *
+*               The indexes are pindex, as in the triangulators: the files *
+*               of more than 2^31 points need -DLONGINDEX here too.        *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#define EPSILON 0.0000001
+
+#define MAX_REPORTED 10		/* Errors described on stderr by a check  */
+
+
+typedef struct Tetra2struct
+{				/* A ShortTetra is an abbreviated type for*/
+ pindex v[4];			/* representing Tetrahedra. It contains   */
+} ShortTetra;			/* only the four index of its vertices	  */
+
+
+typedef struct Triangulationstruct
+{				/* A triangulation as read from files:	  */
+ Point3 *v;			/* the point vector,			  */
+ pindex n;			/* its size,				  */
+ ShortTetra *t; 		/* the tetrahedra vector		  */
+ long nt;			/* and its size.			  */
+} Triangulation;
+
+
+typedef struct VFacestruct	/* A face of a tetrahedron: its vertices  */
+{				/* in increasing order and the vertex of  */
+ pindex v[3];			/* the tetrahedron opposite to it. When   */
+ pindex opp;			/* sorted, the two copies of an internal  */
+} VFace;			/* face are adjacent.			  */
+
+
+typedef struct VEdgestruct	/* An edge of the boundary surface: its   */
+{				/* vertices in increasing order and the   */
+ pindex v[2];			/* boundary face it belongs to. 	  */
+ long f;
+} VEdge;
+
+
+/****************************************************************************
+*									    *
+* VResult								    *
+*									    *
+* The outcome of the validation: a count for each kind of error and the     *
+* two volumes that must match. Checks not executed leave their counts to 0. *
+*									    *
+****************************************************************************/
+
+typedef struct VResultstruct
+{
+ long BadIndex; 		/* Vertex indexes out of the point vector */
+ long NotEmpty; 		/* Points inside a circumsphere 	  */
+ long Negative; 		/* Negatively oriented tetrahedra	  */
+ long Flat;			/* Tetrahedra with null volume		  */
+ long Boundary; 		/* Faces belonging to one tetrahedron	  */
+ long OverShared;		/* Faces belonging to more than two	  */
+ long Folded;			/* Faces whose two tetrahedra overlap	  */
+ long OpenEdge; 		/* Boundary edges not shared by two faces */
+ long ConcaveEdge;		/* Boundary edges where the hull is not   */
+				/* convex				  */
+ long Unused;			/* Points that are not vertices 	  */
+ double Volume; 		/* Sum of the tetrahedra volumes	  */
+ double HullVolume;		/* Volume enclosed by the boundary faces  */
+} VResult;
+
+
+/* Checks selectable in ValidateTriangulation */
+
+#define CHECK_SPHERE	 1
+#define CHECK_ORIENT	 2
+#define CHECK_FACES	 4
+#define CHECK_VOLUME	 8
+#define CHECK_ALL	15
+
+
+/**************************************************************************
+*   vfile.c								  *
+**************************************************************************/
+
+Point3 *ReadPointFile(char *filename, pindex *n);
+ShortTetra *ReadTetraFile(char *filename, long *n);
+void ReadTriangulation(char *pntfile, char *tetfile, Triangulation *T);
+void WriteTetraVector(ShortTetra *t, long n, FILE *fp);
+void BucketSort(void *base, long n, size_t size, long keys,
+		long (*key)(void *), int (*cmp)(const void *, const void *));
+void CanonicalTetra(ShortTetra *t, long n, pindex np);
+long DiffTetra(ShortTetra *a, long na, ShortTetra *b, long nb,
+	       long *OnlyA, long *OnlyB);
+
+
+/**************************************************************************
+*   validate.c								  *
+**************************************************************************/
+
+double Orient(Point3 *a, Point3 *b, Point3 *c, Point3 *d);
+long CheckIndexes(Triangulation *T);
+long CheckEmptySphere(Triangulation *T, double eps);
+long CheckOrientation(Triangulation *T, long *Flat, double *Volume);
+void CheckFaces(Triangulation *T, VResult *R);
+int  ValidateTriangulation(Triangulation *T, int checks, double eps, VResult *R);
+void PrintResult(Triangulation *T, int checks, VResult *R);
@@ -0,0 +1,370 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:      vfile.c                                                    *
+*                                                                          *
+* PURPOSE:      File I/O, sorting and comparison of triangulations.        *
+*                                                                          *
+* IMPORTS:      OList                                                      *
+*                                                                          *
+* EXPORTS:      ReadPointFile       Read a Point file                      *
+*               ReadTetraFile       Read a Tetrahedra file, also packed    *
+*               ReadTriangulation   Read both files in parallel            *
+*               WriteTetraVector    Write a tetra vector on a file         *
+*               BucketSort          Parallel sort on an integer key        *
+*               CanonicalTetra      Put tetrahedra in a canonical form     *
+*               DiffTetra           Compare two canonical triangulations   *
+*                                                                          *
+*   NOTES:      DeWall and InCoDe build the same tetrahedra in different   *
+*               orders and with different vertex orders. After            *
+*               CanonicalTetra two triangulations of the same points are   *
+*               equal if and only if their tetrahedra vectors are equal.   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <OList/general.h>
+#include <OList/error.h>
+#include <OList/parallel.h>
+#include <OList/numfile.h>
+#include <OList/cloud.h>
+#include <OList/tetpack.h>
+
+#include "graphics.h"
+#include "validate.h"
+
+#define LONG_MESSAGE "%s, %s has more points than a pindex: build with -DLONGINDEX.\n"
+
+
+/*
+ * ReadPointFile
+ *
+ * Read a point file in the format used by DeWall and InCoDe:
+ *      N
+ *      X Y Z
+ *      X Y Z
+ *      ...
+ * The coordinates are parsed in parallel by ReadReals (see numfile.c).
+ * PLY, LAS and XYZ files are read whole by ReadCloud (see cloud.c).
+ */
+
+Point3 *ReadPointFile(char *filename, pindex *n)
+{
+ NumFile F;
+ long m;
+ Point3 *vec;
+
+ if((vec=(Point3 *)ReadCloud(filename,NULL,sizeof(Point3),&m)))
+   {
+    if((pindex)m!=m) Errorf(EXIT,LONG_MESSAGE,"ReadPointFile",filename);
+    *n=(pindex)m;
+    return vec;
+   }
+
+ if(!OpenNumFile(filename,&F)) Errorf(EXIT,"ReadPointFile, Unable to open %s.\n",filename);
+
+ if(!ReadLong(&F,&m) || m<0)
+   Errorf(EXIT,"ReadPointFile, %s is not a point file.\n",filename);
+ if((pindex)m!=m) Errorf(EXIT,LONG_MESSAGE,"ReadPointFile",filename);
+ *n=(pindex)m;
+
+ vec=(Point3 *)calloc((size_t)max(*n,1),sizeof(Point3));
+ if(!vec) Error("ReadPointFile, Not enough memory to load point dataset.\n",EXIT);
+
+ if((m=ReadReals(&F,(long)*n,3,&(vec[0].x),sizeof(Point3)))<*n)
+   Errorf(EXIT,"ReadPointFile, %s truncated at point %ld.\n",filename,m);
+
+ CloseNumFile(&F);
+ return vec;
+}
+
+
+/*
+ * ReadTetraFile
+ *
+ * Read a tetrahedra file as written by DeWall and InCoDe:
+ *      N
+ *      V0 V1 V2 V3
+ *      ...
+ * or packed by the -z option (see tetpack.h).
+ */
+
+static ShortTetra *ReadPackedFile(char *filename, TetPack *P, long *n)
+{
+ pindex *b;
+ long i, k, m=0;
+ int j;
+ ShortTetra *t;
+
+ if((pindex)P->np!=P->np) Errorf(EXIT,LONG_MESSAGE,"ReadTetraFile",filename);
+
+ *n=P->nt;
+ t=(ShortTetra *)malloc((size_t)max(*n,1)*sizeof(ShortTetra));
+ b=(pindex *)malloc((size_t)P->block*4*sizeof(pindex));
+ if(!t || !b) Error("ReadTetraFile, Not enough memory to load tetrahedra.\n",EXIT);
+
+ while((k=ReadTetPack(P,b))>0)
+   {
+    for(i=0;i<k;i++,m++)
+      for(j=0;j<4;j++) t[m].v[j]=b[4*i+j];
+   }
+ if(k<0) Errorf(EXIT,"ReadTetraFile, %s truncated at tetrahedron %ld.\n",filename,m);
+
+ free(b);
+ CloseTetPack(P);
+ return t;
+}
+
+ShortTetra *ReadTetraFile(char *filename, long *n)
+{
+ FILE *fp;
+ TetPack P;
+ long i, a[4];
+ int j;
+ ShortTetra *t;
+
+ fp=fopen(filename,"rb");
+ if(!fp) Errorf(EXIT,"ReadTetraFile, Unable to open %s.\n",filename);
+
+ if(OpenTetPack(fp,&P))
+   {
+    t=ReadPackedFile(filename,&P,n);
+    fclose(fp);
+    return t;
+   }
+
+ if(fscanf(fp,"%ld",n)!=1 || *n<0)
+   Errorf(EXIT,"ReadTetraFile, %s is not a tetrahedra file.\n",filename);
+
+ t=(ShortTetra *)malloc((size_t)max(*n,1)*sizeof(ShortTetra));
+ if(!t) Error("ReadTetraFile, Not enough memory to load tetrahedra.\n",EXIT);
+
+ for(i=0;i<*n;i++)
+   {
+    if(fscanf(fp,"%ld %ld %ld %ld",&a[0],&a[1],&a[2],&a[3])!=4)
+      Errorf(EXIT,"ReadTetraFile, %s truncated at tetrahedron %ld.\n",filename,i);
+    for(j=0;j<4;j++)
+      {
+       t[i].v[j]=(pindex)a[j];
+       if(t[i].v[j]!=a[j]) Errorf(EXIT,LONG_MESSAGE,"ReadTetraFile",filename);
+      }
+   }
+
+ fclose(fp);
+ return t;
+}
+
+
+/*
+ * ReadTriangulation
+ *
+ * Read the point file and the tetrahedra file of a triangulation. The two
+ * files are independent, so they are read at the same time by two threads.
+ */
+
+typedef struct LoadJobstruct
+{
+ char *pntfile, *tetfile;
+ Triangulation *T;
+} LoadJob;
+
+static void LoadBody(long from, long to, int thread, void *arg)
+{
+ LoadJob *J=(LoadJob *)arg;
+ long i;
+
+ for(i=from;i<to;i++)
+   if(i==0) J->T->v=ReadPointFile(J->pntfile,&(J->T->n));
+       else J->T->t=ReadTetraFile(J->tetfile,&(J->T->nt));
+}
+
+void ReadTriangulation(char *pntfile, char *tetfile, Triangulation *T)
+{
+ LoadJob J;
+
+ J.pntfile=pntfile;
+ J.tetfile=tetfile;
+ J.T=T;
+
+ ParallelFor(2, 1, LoadBody, &J);
+}
+
+
+/*
+ * WriteTetraVector
+ *
+ * Write a vector of tetrahedra in the same format of DeWall and InCoDe.
+ */
+
+void WriteTetraVector(ShortTetra *t, long n, FILE *fp)
+{
+ long i;
+
+ fprintf(fp,"%ld\n",n);
+ for(i=0;i<n;i++)
+   fprintf(fp,"%6" IDX " %6" IDX " %6" IDX " %6" IDX "\n",
+	   t[i].v[0],t[i].v[1],t[i].v[2],t[i].v[3]);
+}
+
+
+/***************************************************************************
+*									   *
+* BucketSort								   *
+*									   *
+* Sort a vector of n elements of the given size. The elements are first    *
+* distributed by their integer key (in [0, keys)) with a counting sort,    *
+* then each bucket is sorted with qsort and cmp; the buckets are sorted    *
+* in parallel. cmp must order first by key.				   *
+*									   *
+* All the vectors we sort (faces, edges, tetrahedra) are keyed by their    *
+* smallest vertex, so buckets are small and the whole sort is nearly	   *
+* linear.								   *
+*									   *
+***************************************************************************/
+
+typedef struct SortJobstruct
+{
+ char *base;
+ size_t size;
+ long *start;			/* First element of each bucket 	  */
+ int (*cmp)(const void *, const void *);
+} SortJob;
+
+static void SortBody(long from, long to, int thread, void *arg)
+{
+ SortJob *J=(SortJob *)arg;
+ long k, len;
+
+ for(k=from;k<to;k++)
+   {
+    len=J->start[k+1]-J->start[k];
+    if(len>1) qsort(J->base+J->start[k]*J->size,(size_t)len,J->size,J->cmp);
+   }
+}
+
+void BucketSort(void *base, long n, size_t size, long keys,
+		long (*key)(void *), int (*cmp)(const void *, const void *))
+{
+ SortJob J;
+ char *tmp, *b=(char *)base;
+ long *pos, i, k;
+
+ if(n<2) return;
+
+ tmp=(char *)malloc((size_t)n*size);
+ J.start=(long *)calloc((size_t)keys+1,sizeof(long));
+ pos=(long *)malloc(((size_t)keys+1)*sizeof(long));
+ if(!tmp || !J.start || !pos) Error("BucketSort, Not enough memory to sort.\n",EXIT);
+
+ for(i=0;i<n;i++) J.start[key(b+i*size)+1]++;
+ for(k=0;k<keys;k++) J.start[k+1]+=J.start[k];
+ memcpy(pos,J.start,((size_t)keys+1)*sizeof(long));
+
+ for(i=0;i<n;i++)
+   memcpy(tmp+(pos[key(b+i*size)]++)*size, b+i*size, size);
+ memcpy(b,tmp,(size_t)n*size);
+
+ J.base=b;
+ J.size=size;
+ J.cmp=cmp;
+ ParallelFor(keys, 0, SortBody, &J);
+
+ free(pos);
+ free(J.start);
+ free(tmp);
+}
+
+
+/***************************************************************************
+*									   *
+* CanonicalTetra							   *
+*									   *
+* Put in canonical form a vector of tetrahedra whose indexes are in	   *
+* [0, np): the vertices of each tetrahedron are sorted in increasing	   *
+* order and then the tetrahedra are sorted lexicographically.		   *
+* Note that the orientation of the tetrahedra is lost.			   *
+*									   *
+***************************************************************************/
+
+static void SortVertexBody(long from, long to, int thread, void *arg)
+{
+ ShortTetra *t=(ShortTetra *)arg;
+ long i;
+ int j,k;
+ pindex a;
+
+ for(i=from;i<to;i++)
+   for(j=1;j<4;j++)			/* Insertion sort of 4 values	  */
+     {
+      a=t[i].v[j];
+      for(k=j-1; k>=0 && t[i].v[k]>a; k--) t[i].v[k+1]=t[i].v[k];
+      t[i].v[k+1]=a;
+     }
+}
+
+static long TetraKey(void *T)
+{
+ return ((ShortTetra *)T)->v[0];
+}
+
+static int CompareTetra(const void *T0, const void *T1)
+{
+ ShortTetra *t0=(ShortTetra *)T0;
+ ShortTetra *t1=(ShortTetra *)T1;
+ int i;
+
+ for(i=0;i<4;i++)
+   if(t0->v[i]!=t1->v[i]) return (t0->v[i]<t1->v[i]) ? -1 : 1;
+ return 0;
+}
+
+void CanonicalTetra(ShortTetra *t, long n, pindex np)
+{
+ ParallelFor(n, 0, SortVertexBody, t);
+ BucketSort(t, n, sizeof(ShortTetra), np, TetraKey, CompareTetra);
+}
+
+
+/***************************************************************************
+*									   *
+* DiffTetra								   *
+*									   *
+* Compare two vectors of tetrahedra in canonical form. OnlyA and OnlyB	   *
+* return the number of tetrahedra present only in the first and only in    *
+* the second vector; the first ones are described on stderr. It returns    *
+* OnlyA+OnlyB, so 0 means that the two triangulations are identical.	   *
+*									   *
+***************************************************************************/
+
+long DiffTetra(ShortTetra *a, long na, ShortTetra *b, long nb,
+	       long *OnlyA, long *OnlyB)
+{
+ long i=0, j=0;
+ int c;
+ ShortTetra *t;
+ char which;
+
+ *OnlyA=*OnlyB=0;
+ while(i<na || j<nb)
+   {
+    if(i==na) c=1;
+      else if(j==nb) c=-1;
+	else c=CompareTetra(&a[i],&b[j]);
+
+    if(c==0) { i++; j++; continue; }
+    if(c<0) { t=&a[i++]; which='<'; (*OnlyA)++; }
+       else { t=&b[j++]; which='>'; (*OnlyB)++; }
+
+    if(*OnlyA+*OnlyB <= MAX_REPORTED)
+      Errorf(NO_EXIT,"DiffTetra, %c %" IDX " %" IDX " %" IDX " %" IDX "\n",
+	     which,t->v[0],t->v[1],t->v[2],t->v[3]);
+   }
+
+ return *OnlyA+*OnlyB;
+}
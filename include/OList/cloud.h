@@ -0,0 +1,67 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	cloud.h							   *
+*                                                                          *
+* PURPOSE:	Define PointFilter type and the readers of point clouds in *
+*		the PLY, LAS and XYZ formats.				   *
+*                                                                          *
+*   NOTES:	It can be harmlessy included more than one time.	   *
+*		The points are read in a vector of objects of any size	   *
+*		that begin with the three double coordinates, as Point3.  *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#ifndef CLOUD_H 	/* If CLOUD_H is already defined all this file */
+			/* must be skipped.			       */
+#define CLOUD_H
+
+#include <stddef.h>
+#include <OList/general.h>
+
+/***************************************************************************
+*   CONST:	CLOUD_CHUNK						   *
+*									   *
+* PURPOSE:	The binary points are read and decoded CLOUD_CHUNK at a    *
+*		time.							   *
+*									   *
+***************************************************************************/
+
+#define CLOUD_CHUNK 65536L
+
+
+/***************************************************************************
+*									   *
+*    TYPE:	PointFilter						   *
+*									   *
+* PURPOSE:	Which points of a file are loaded: those inside a box and, *
+*		for LAS files, of some classes.				   *
+*									   *
+***************************************************************************/
+
+typedef struct PointFiltertag
+{
+ boolean BoxFlag;
+ double min[3], max[3];
+ boolean ClassFlag;
+ unsigned char Class[32];	/* Bit c set if class c is loaded	   */
+} PointFilter;
+
+
+/***************************************************************************
+*	Functions in cloud.c						   *
+***************************************************************************/
+
+void	InitFilter(PointFilter *F);
+boolean SetFilterBox(PointFilter *F, char *s);
+boolean SetFilterClass(PointFilter *F, char *s);
+long	FilterPoints(void *vec, long n, size_t size, PointFilter *F);
+void   *ReadCloud(char *filename, PointFilter *F, size_t size, long *n);
+
+
+#endif		/* this #endif is the brother of #ifndef CLOUD_H.  */
+		/* If CLOUD_H was already defined all this file    */
+		/* must be skipped.				   */
@@ -0,0 +1,63 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	delaunay.h						   *
+*                                                                          *
+* PURPOSE:	The pieces of DeWall and InCoDe that do not depend on the  *
+*		dimension: the Uniform Grid sizing and cell scan, the	   *
+*		position of a wall and the update of an active face list.  *
+*                                                                          *
+*   NOTES:	It can be harmlessy included more than one time.	   *
+*		They are used both by the 3d programs and by the E^d ones  *
+*		of Ed, so that a fix made here is made in all of them.	   *
+*		A point of the Uniform Grid is given as a vector of d	   *
+*		doubles, its cells by a vector of d int coordinates, the   *
+*		first one varying fastest in the cell index:		   *
+*									   *
+*		    index = i0 + i1*c0 + i2*c0*c1 + ...			   *
+*									   *
+*		where c0, c1, ... are the cells along each axis.	   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#ifndef DELAUNAY_H	/* If DELAUNAY_H is already defined all this file */
+			/* must be skipped.				  */
+#define DELAUNAY_H
+
+#include <OList/general.h>
+#include <OList/olist.h>
+
+/***************************************************************************
+*   CONST:	WALL_GAP						   *
+*									   *
+* PURPOSE:	The smallest gap between the coordinates of the points on  *
+*		the two sides of a wall (twice the EPSILON of the	   *
+*		triangulators), so no point is on the wall.		   *
+*									   *
+***************************************************************************/
+
+#define WALL_GAP 0.0000002
+
+
+/***************************************************************************
+*	Functions in delaunay.c						   *
+***************************************************************************/
+
+long	SizeGrid(double *vn, double *vp, int d, double m, int *c, double *side);
+int	GridCoord(double x, double vn, double side, int c);
+int	GridIndex(int *i, int *c, int d);
+void	GridBox(double *o, double r, double *vn, double side, int *c, int d,
+		int *lo, int *hi);
+boolean NextCell(int *i, int *lo, int *hi, int d);
+double	CellDistance(double *o, int *i, double *vn, double side, int d);
+pindex	SplitWall(pointer *v, pindex n, pindex m, int axis,
+		  double (*coord)(pointer, int), double *off);
+pointer ToggleFace(pointer f, List l);
+
+
+#endif		/* this #endif is the brother of #ifndef DELAUNAY_H.*/
+		/* If DELAUNAY_H was already defined all this file  */
+		/* must be skipped.				    */
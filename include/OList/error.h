@@ -45,6 +45,7 @@
 void Error(char *message, int ExitFlag);
 void Errorf(boolean ExitFlag, char *message, ...);
 void SetProgramName(char *s);
+void SetErrorExit(void (*f)(void));
 
 
 /***************************************************************************
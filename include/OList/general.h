@@ -179,6 +179,24 @@ typedef int boolean;			/* boolean data type */
 typedef boolean flag;                   /* flag data type    */
 #endif
 
+
+/**************/
+/* index type */
+/**************/
+
+/* Index of a point or of a tetrahedron: int by default, long compiling */
+/* with -DLONGINDEX for datasets of more than 2^31 points or		 */
+/* tetrahedra. IDX is the conversion to print or scan a pindex, as in	 */
+/* printf("%7" IDX, n).							 */
+
+#ifdef LONGINDEX
+typedef long pindex;
+#define IDX "ld"
+#else
+typedef int pindex;
+#define IDX "d"
+#endif
+
 #endif		/* this #endif is the brother of #ifndef GENERAL_H. */
 		/* If GENERAL_H was already defined all this file   */
 		/* must be skipped.                                 */
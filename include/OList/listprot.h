@@ -31,7 +31,7 @@ List NewList(TypeList type, int size);
 List NewHashList(TypeList type, int size,
 		int (* comp)(void *elem1, void *elem2),
 		int hashsize, int (*HashKey)(void *)   );
-int CountList(List l);
+long CountList(List l);
 boolean ChangeCompareObjectList(int (* comp)(void *e1, void *e2), List l);
 boolean ChangeEqualObjectList(boolean (* eq)(void *e1, void *e2), List l);
 boolean EraseList(List l);
@@ -100,6 +100,16 @@ boolean EraseHashList(List l);
 boolean ReHashList(int newsize, List l);
 
 
+/***************************************************************************
+*	Functions in pool.c						   *
+***************************************************************************/
+
+void InitPool(int nodesize, Pool *p);
+pointer PoolAlloc(Pool *p);
+void PoolFree(pointer node, Pool *p);
+void ErasePool(Pool *p);
+
+
 
 #endif		/* this #endif is the brother of #ifndef LISTPROT_H.*/
 		/* If LISTPROT_H was already defined all this file  */
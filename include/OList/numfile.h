@@ -0,0 +1,75 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	numfile.h						   *
+*                                                                          *
+* PURPOSE:	Define NumFile type, a text file of numbers read in	   *
+*		parallel.						   *
+*                                                                          *
+*   NOTES:	It can be harmlessy included more than one time.	   *
+*		On MSDOS and NOMACHINE, or when NOMMAP is defined, the	   *
+*		file is read in memory instead of being mapped.		   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#ifndef NUMFILE_H	/* If NUMFILE_H is already defined all this file */
+			/* must be skipped.				 */
+#define NUMFILE_H
+
+#include <stddef.h>
+#include <OList/general.h>
+
+#ifdef NOMACHINE
+#define NOMMAP
+#endif
+
+#ifdef MSDOS
+#define NOMMAP
+#endif
+
+/***************************************************************************
+*   CONST:	NUM_SPLIT, NUM_CHUNK					   *
+*									   *
+* PURPOSE:	The numbers are parsed in NUM_SPLIT chunks for each thread,*
+*		but chunks are at least NUM_CHUNK bytes long.		   *
+*									   *
+***************************************************************************/
+
+#define NUM_SPLIT 8
+#define NUM_CHUNK 65536L
+
+
+/***************************************************************************
+*									   *
+*    TYPE:	NumFile							   *
+*									   *
+* PURPOSE:	The whole text of a file and the position of the next	   *
+*		number to read.						   *
+*									   *
+***************************************************************************/
+
+typedef struct NumFiletag
+{
+ char *buf;			/* The text of the file			   */
+ long size;
+ long pos;			/* Where the next number is searched	   */
+ boolean mapped;		/* Whether buf is mapped or allocated	   */
+} NumFile;
+
+
+/***************************************************************************
+*	Functions in numfile.c						   *
+***************************************************************************/
+
+NumFile *OpenNumFile(char *filename, NumFile *F);
+boolean  ReadLong(NumFile *F, long *x);
+long	 ReadReals(NumFile *F, long n, int k, double *vec, size_t stride);
+void	 CloseNumFile(NumFile *F);
+
+
+#endif		/* this #endif is the brother of #ifndef NUMFILE_H.*/
+		/* If NUMFILE_H was already defined all this file  */
+		/* must be skipped.				   */
@@ -12,6 +12,8 @@
 *									   *
 *   18/Jan/93	Changed from list.h to olist.h				   *
 *									   *
+*   19/Oct/26	Added the Pool of the list and hash nodes.		   *
+*									   *
 ****************************************************************************
 ***************************************************************************/
 
@@ -76,6 +78,28 @@ typedef void * pointer;
 
 
 
+/***************************************************************************
+*									   *
+*    TYPE:	Pool							   *
+*									   *
+* PURPOSE:	Allocating nodes of the same size in blocks.		   *
+*									   *
+*   NOTES:	See pool.c. Each list has one for its ListElem and each	   *
+*		hash index one for its BuckElem.			   *
+*									   *
+***************************************************************************/
+typedef struct Pooltag
+{
+ pointer free;		/* Chain of the freed nodes		*/
+ pointer block;		/* Chain of the allocated blocks	*/
+ char *next;		/* First never used node of last block	*/
+ char *end;		/* End of the last block		*/
+ int nodesize;
+ int blocknodes;	/* Nodes of the next block		*/
+} Pool;
+
+
+
 /***************************************************************************
 *									   *
 *    TYPE:	ListElem						   *
@@ -137,6 +161,7 @@ typedef struct Hashtag
  BuckElem **H;
  int size;
  int (*HashKey)(pointer);
+ Pool pool;
 } Hash;
 
 
@@ -173,7 +198,7 @@ typedef struct Hashtag
 struct Listtag
 {
  int objectsize;
- int nobject;
+ long nobject;
  ListElem *H;
  ListElem *T;
  ListElem *C;
@@ -181,6 +206,7 @@ struct Listtag
  boolean (*EqualObj)(void *, void *);
  int (*CompareObj)(void *, void *);
  Hash *hash;
+ Pool pool;
 };
 
 
@@ -0,0 +1,83 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	parallel.h						   *
+*                                                                          *
+* PURPOSE:	Prototypes for machine indipendent parallel loops.	   *
+*                                                                          *
+*   NOTES:	On machines without POSIX threads (MSDOS, NOMACHINE, or    *
+*		when NOTHREADS is defined) every parallel loop is simply   *
+*		executed by the calling process.			   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#ifndef PARALLEL_H	/* If PARALLEL_H is already defined all this file */
+			/* must be skipped.				  */
+#define PARALLEL_H
+
+#ifdef NOMACHINE
+#define NOTHREADS
+#endif
+
+#ifdef MSDOS
+#define NOTHREADS
+#endif
+
+/***************************************************************************
+*   CONST:	MAX_THREADS						   *
+*									   *
+* PURPOSE:	Maximum number of threads used by a parallel loop.	   *
+*									   *
+*   NOTES:	Per thread workspaces can be statically sized with it.	   *
+*									   *
+***************************************************************************/
+
+#define MAX_THREADS 64
+
+
+/***************************************************************************
+*   MACRO:	PARALLEL_LOCAL						   *
+*									   *
+* PURPOSE:	Storage class for variables that must have a private copy  *
+*		in each thread (e.g. statistic counters).		   *
+*									   *
+***************************************************************************/
+
+#ifdef NOTHREADS
+#define PARALLEL_LOCAL
+#else
+#define PARALLEL_LOCAL __thread
+#endif
+
+
+/***************************************************************************
+*									   *
+*    TYPE:	ParallelBody						   *
+*									   *
+* PURPOSE:	The function executed by a parallel loop on the sub range  *
+*		[from, to) of the iterations, by the thread number thread. *
+*									   *
+***************************************************************************/
+
+typedef void (*ParallelBody)(long from, long to, int thread, void *arg);
+
+
+/***************************************************************************
+*	Functions in parallel.c						   *
+***************************************************************************/
+
+void SetThreadNum(int n);
+int  ThreadNum(void);
+int  ThreadId(void);
+int  InParallel(void);
+void ParallelFor(long n, long grain, ParallelBody body, void *arg);
+void LockParallel(void);
+void UnlockParallel(void);
+
+
+#endif		/* this #endif is the brother of #ifndef PARALLEL_H.*/
+		/* If PARALLEL_H was already defined all this file  */
+		/* must be skipped.				    */
@@ -0,0 +1,76 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	serve.h							   *
+*                                                                          *
+* PURPOSE:	Define ServeJob type, a program that runs its command	   *
+*		lines as jobs sent on a Unix domain socket.		   *
+*                                                                          *
+*   NOTES:	It can be harmlessy included more than one time.	   *
+*		A client connects to the socket and writes one line, the   *
+*		arguments of the job separated by blanks as on the	   *
+*		command line. The job runs with stdout and stderr sent on  *
+*		the connection, so the client reads what the program	   *
+*		would print, then the last line				   *
+*									   *
+*		    Exit: n						   *
+*									   *
+*		with the value the program would return (-1 if the job    *
+*		ended with an error), and the connection is closed.	   *
+*		The line "quit" stops the server.			   *
+*		On MSDOS and NOMACHINE, or when NOSOCKET is defined, there *
+*		are no sockets and ServeJobs is an error.		   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#ifndef SERVE_H 	/* If SERVE_H is already defined all this file */
+			/* must be skipped.			       */
+#define SERVE_H
+
+#ifdef NOMACHINE
+#define NOSOCKET
+#endif
+
+#ifdef MSDOS
+#define NOSOCKET
+#endif
+
+/***************************************************************************
+*   CONST:	SERVE_LINE, SERVE_ARGS, SERVE_BACKLOG			   *
+*									   *
+* PURPOSE:	The longest line of a job, its most arguments and the	   *
+*		clients that can wait for the running job.		   *
+*									   *
+***************************************************************************/
+
+#define SERVE_LINE	4096
+#define SERVE_ARGS	64
+#define SERVE_BACKLOG	16
+
+
+/***************************************************************************
+*									   *
+*    TYPE:	ServeJob						   *
+*									   *
+* PURPOSE:	The function that runs a job, with the arguments as main   *
+*		gets them (argv[0] is the program name, argv[argc] is	   *
+*		NULL), returning what main would.			   *
+*									   *
+***************************************************************************/
+
+typedef int (*ServeJob)(int argc, char *argv[]);
+
+
+/***************************************************************************
+*	Functions in serve.c						   *
+***************************************************************************/
+
+void ServeJobs(char *path, char *name, ServeJob job);
+
+
+#endif		/* this #endif is the brother of #ifndef SERVE_H.  */
+		/* If SERVE_H was already defined all this file    */
+		/* must be skipped.				   */
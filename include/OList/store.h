@@ -0,0 +1,108 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	store.h							   *
+*                                                                          *
+* PURPOSE:	Define Store type, a growable vector of objects.	   *
+*                                                                          *
+*   NOTES:	It can be harmlessy included more than one time.	   *
+*		Unlike a List a Store contains the objects themselves, not *
+*		pointers to them, and objects can only be appended.	   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#ifndef STORE_H 	/* If STORE_H is already defined all this file */
+			/* must be skipped.                            */
+#define STORE_H
+
+#include <OList/olist.h>
+
+/***************************************************************************
+*   CONST:	STORE_SHIFT						   *
+*									   *
+* PURPOSE:	A Store is made of chunks of 2^STORE_SHIFT objects.	   *
+*									   *
+***************************************************************************/
+
+#define STORE_SHIFT 14
+#define STORE_CHUNK (1L<<STORE_SHIFT)
+
+
+/***************************************************************************
+*									   *
+*    TYPE:	StoreHash						   *
+*									   *
+* PURPOSE:	An hash index over the objects of a Store.		   *
+*									   *
+*   NOTES:	Open addressing with linear probing; slot contains the	   *
+*		index+1 of an object, 0 if empty. The table is doubled	   *
+*		when it is half full.					   *
+*									   *
+***************************************************************************/
+
+typedef struct StoreHashtag
+{
+ long *slot;
+ long size;			/* A power of two			   */
+ int (*HashKey)(pointer);
+ boolean (*EqualObj)(pointer, pointer);
+} StoreHash;
+
+
+/***************************************************************************
+*									   *
+*    TYPE:	Store							   *
+*									   *
+* PURPOSE:	A growable vector of objects of the same size.		   *
+*									   *
+*   NOTES:	The objects never move, so the pointers returned by	   *
+*		AppendStore and StoreElem stay valid until the Store is	   *
+*		erased or turned into a vector.				   *
+*									   *
+***************************************************************************/
+
+struct Storetag
+{
+ int objectsize;
+ long nobject;
+ char **chunk;			/* The chunks of STORE_CHUNK objects	   */
+ long maxchunk;			/* Size of the chunk vector		   */
+ StoreHash *hash;
+};
+
+typedef struct Storetag *Store;
+
+
+/***************************************************************************
+*									   *
+*    MACRO:	StoreElem						   *
+*									   *
+* PURPOSE:	The pointer to the i-th object of a Store, 0 <= i < count. *
+*									   *
+***************************************************************************/
+
+#define StoreElem(i,s) ((pointer)((s)->chunk[(i)>>STORE_SHIFT] + \
+			 ((i)&(STORE_CHUNK-1))*(s)->objectsize))
+
+
+/***************************************************************************
+*	Functions in store.c						   *
+***************************************************************************/
+
+Store NewStore(int size);
+pointer AppendStore(pointer object, Store s);
+long CountStore(Store s);
+boolean HashStore(long size, int (*HashKey)(pointer),
+		  boolean (*eq)(pointer, pointer), Store s);
+pointer MemberStore(pointer object, Store s);
+pointer Store2Vector(Store s);
+Store Vector2Store(pointer vec, long n, int size);
+boolean EraseStore(Store s);
+
+
+#endif		/* this #endif is the brother of #ifndef STORE_H.*/
+		/* If STORE_H was already defined all this file  */
+		/* must be skipped.                              */
@@ -0,0 +1,91 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	tetpack.h						   *
+*                                                                          *
+* PURPOSE:	Define TetPack type, the reader of a packed tetrahedra	   *
+*		file.							   *
+*                                                                          *
+*   NOTES:	It can be harmlessy included more than one time.	   *
+*		A packed file has the same tetrahedra of a text one, with  *
+*		their vertices sorted and in lexicographic order; each	   *
+*		tetrahedron keeps its orientation. The file is:		   *
+*									   *
+*		    TETPACK_MAGIC np nt nb    header, np points, nt	   *
+*					      tetrahedra in blocks of nb   *
+*		    k len d d d d d d d d ...  a block: k tetrahedra coded *
+*		    ...			       in len bytes		   *
+*									   *
+*		All the numbers are unsigned varints, 7 bits for each byte *
+*		starting from the lowest, the high bit set when another    *
+*		byte follows. A block is coded from scratch, as if the	   *
+*		previous tetrahedron were 0 0 0 0, so the blocks can be    *
+*		coded and decoded independently. For each tetrahedron	   *
+*		a<b<c<d, knowing the previous one p:			   *
+*									   *
+*		    a-p.a		      always			   *
+*		    b-p.b or b-a	      if a==p.a or not		   *
+*		    c-p.c or c-b	      if a,b==p.a,p.b or not	   *
+*		    2*(d-p.d)+o or 2*(d-c)+o  if a,b,c==p.a,p.b,p.c or not *
+*									   *
+*		where o is 1 if the tetrahedron a b c d has the opposite   *
+*		orientation of the one given, that is then a b d c.	   *
+*									   *
+****************************************************************************
+***************************************************************************/
+
+#ifndef TETPACK_H	/* If TETPACK_H is already defined all this file */
+			/* must be skipped.				 */
+#define TETPACK_H
+
+#include <stdio.h>
+#include <OList/general.h>
+
+/***************************************************************************
+*   CONST:	TETPACK_MAGIC, TETPACK_BLOCK, TETPACK_VARMAX		   *
+*									   *
+* PURPOSE:	The first bytes of a packed file, the tetrahedra of a	   *
+*		block and the longest varint of a vertex index.		   *
+*									   *
+***************************************************************************/
+
+#define TETPACK_MAGIC "TETPACK1"
+#define TETPACK_BLOCK 65536L
+#define TETPACK_VARMAX ((int)(sizeof(pindex)*8+1+6)/7)
+
+
+/***************************************************************************
+*									   *
+*    TYPE:	TetPack							   *
+*									   *
+* PURPOSE:	A packed tetrahedra file being read a block at a time.	   *
+*									   *
+***************************************************************************/
+
+typedef struct TetPacktag
+{
+ FILE *fp;
+ long np;			/* Points of the triangulation		   */
+ long nt;			/* Tetrahedra of the file		   */
+ long block;			/* Tetrahedra of a full block		   */
+ long left;			/* Tetrahedra not read yet		   */
+ unsigned char *buf;		/* The bytes of the last block		   */
+ long bufsize;
+} TetPack;
+
+
+/***************************************************************************
+*	Functions in tetpack.c						   *
+***************************************************************************/
+
+void	 WriteTetPack(pindex *t, long nt, long np, FILE *fp);
+TetPack *OpenTetPack(FILE *fp, TetPack *P);
+long	 ReadTetPack(TetPack *P, pindex *t);
+void	 CloseTetPack(TetPack *P);
+
+
+#endif		/* this #endif is the brother of #ifndef TETPACK_H.*/
+		/* If TETPACK_H was already defined all this file  */
+		/* must be skipped.				   */
@@ -0,0 +1,63 @@
+/***************************************************************************
+******************************* 19/Oct/26 **********************************
+****************************   Version 1.0   *******************************
+*********************** Author: DeWall & InCoDe team ***********************
+*                                                                          *
+*    FILE:	voronoi.h						   *
+*                                                                          *
+* PURPOSE:	The writers of the Voronoi diagram and of the VTK grid of  *
+*		a 3d Delaunay triangulation.				   *
+*                                                                          *
+*   NOTES:	It can be harmlessy included more than one time.	   *
+*		They are used by both DeWall and InCoDe. The tetrahedra    *
+*		are a Store of objects that begin with the four pindex	   *
+*		of their vertices, as ShortTetra; the points a vector of   *
+*		objects of any size that begin with the three double	   *
+*		coordinates, as Point3 (see cloud.h).			   *
+*                                                                          *
+****************************************************************************
+***************************************************************************/
+
+#ifndef VORONOI_H	/* If VORONOI_H is already defined all this file */
+			/* must be skipped.				 */
+#define VORONOI_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <OList/general.h>
+#include <OList/store.h>
+
+/***************************************************************************
+*   CONST:	VORONOI_BLOCK, VTK_BLOCK, VTK_TETRA			   *
+*									   *
+* PURPOSE:	The Voronoi cells (or vertices) and the VTK points (or	   *
+*		tetrahedra) built at once, and the VTK cell type of a	   *
+*		tetrahedron.						   *
+*									   *
+***************************************************************************/
+
+#define VORONOI_BLOCK 4096
+#define VTK_BLOCK 65536
+#define VTK_TETRA 10
+
+
+/***************************************************************************
+*	Functions in voronoi.c						   *
+***************************************************************************/
+
+boolean TetraCenter(double *a, double *b, double *c, double *d, double *o);
+double	TetraVolume(double *a, double *b, double *c, double *d);
+void	WriteVoronoi(Store T, void *v, size_t size, pindex n,
+		     boolean AreaFlag, FILE *fp);
+
+/***************************************************************************
+*	Functions in vtk.c						   *
+***************************************************************************/
+
+void	WriteVTK(Store T, void *v, size_t size, pindex n,
+		 boolean FieldFlag, FILE *fp);
+
+
+#endif		/* this #endif is the brother of #ifndef VORONOI_H.*/
+		/* If VORONOI_H was already defined all this file  */
+		/* must be skipped.				   */